@@ -0,0 +1,98 @@
+#pragma once
+
+#include "image_buffer.hpp"
+#include "render_trace.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Buddhabrot / anti-Buddhabrot 轨道密度渲染器
+ *
+ * 与逃逸时间渲染不同: 随机采样参数c, 把满足条件的c的整条轨道 z_1..z_n 累加到密度图上
+ * - Buddhabrot: 迭代次数在 [min_iter, max_iter) 内逃逸的轨道
+ * - anti-Buddhabrot: 跑满 max_iter 不逃逸的轨道
+ *
+ * 采样效率: 先用逃逸时间内核 (fractal_kernels.hpp) 在粗网格上统计每格满足条件的比例,
+ * 按该比例 (加下限, 并向邻格膨胀一格) 重要性采样格子, 格内均匀采样; 远离命中格的格子
+ * 保留很小的概率下限, 每格概率都大于0。每个样本按 均匀密度 / 采样密度 加权,
+ * 因此结果仍是均匀采样的无偏估计, 但大部分样本不再落在心形内部或快速逃逸的外部。
+ *
+ * 累加扩展性: 每个线程独占一张密度图 (由本线程首次写入), 热循环内没有原子操作与共享写;
+ * 结束时按行带并行归约。密度按double累加: 数十亿样本时热点像素远超float的2^24精度上限,
+ * 继续累加的权重会被舍入丢失。样本按固定大小的批次派发, 每批的随机数种子只取决于批次编号,
+ * 结果与线程数无关 (除浮点求和顺序)。
+ */
+
+namespace MandelbrotOMP {
+
+    /**
+     * 采样方式
+     */
+    enum class BuddhabrotSampling {
+        Uniform,        // 在采样域内均匀采样c
+        Importance      // 按粗逃逸时间图的重要性采样
+    };
+
+    /**
+     * Buddhabrot 渲染参数
+     */
+    struct BuddhabrotParams {
+        int width = 1000;
+        int height = 1000;
+        double x_min = -2.0;        // 累加区域 (轨道点落在此区域内才计入)
+        double x_max = 1.0;
+        double y_min = -1.5;
+        double y_max = 1.5;
+        int min_iter = 20;          // 只累加迭代次数不少于min_iter的轨道 (anti模式忽略)
+        int max_iter = 5000;
+        bool anti = false;          // anti-Buddhabrot: 累加不逃逸的轨道
+        long long samples = 10000000;  // 采样的c个数
+        uint64_t seed = 1;
+        BuddhabrotSampling sampling = BuddhabrotSampling::Importance;
+        int importance_grid = 256;  // 重要性图每轴格数 (覆盖采样域 [-2, 2] x [-2, 2])
+        int num_threads = 0;        // 0 = 自动检测
+        MandelbrotCPU::TraceRecorder* trace = nullptr;  // 非空时记录各阶段与每批采样的区间
+    };
+
+    /**
+     * 渲染统计
+     */
+    struct BuddhabrotStats {
+        long long samples = 0;              // 采样的c个数
+        long long accepted = 0;             // 满足条件、轨道被累加的c个数
+        long long orbit_points = 0;         // 累加的轨道点数 (含落在区域外的)
+        long long iterations = 0;           // 判定 + 累加两遍的总迭代次数
+        double uniform_acceptance = 0.0;    // 重要性图估计的均匀采样接受率
+        double map_seconds = 0.0;           // 构建重要性图耗时
+        double sample_seconds = 0.0;        // 采样与累加耗时
+        double merge_seconds = 0.0;         // 每线程密度图归约耗时
+
+        double acceptance() const { return samples > 0 ? static_cast<double>(accepted) / samples : 0.0; }
+    };
+
+    /**
+     * 轨道密度图 (行优先, 值为加权命中数)
+     */
+    struct BuddhabrotImage {
+        int width = 0;
+        int height = 0;
+        std::vector<double> density;
+        BuddhabrotStats stats;
+    };
+
+    /**
+     * OpenMP并行渲染Buddhabrot密度图
+     * @param params 渲染参数
+     * @return 密度图与统计
+     */
+    BuddhabrotImage render_buddhabrot_omp(const BuddhabrotParams& params);
+
+    /**
+     * 密度图色调映射为RGB (按99.9百分位归一化后做gamma, 冷色到白色的色带)
+     * @param image 密度图
+     * @param gamma 亮度指数 (<1 提亮暗部)
+     * @return RGB像素数据 (size = width * height * 3)
+     */
+    MandelbrotCPU::ImageBuffer buddhabrot_to_rgb(const BuddhabrotImage& image, double gamma = 0.5);
+
+} // namespace MandelbrotOMP
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * 缓冲区池 - 按尺寸分级复用的大块内存
+ *
+ * 同一进程内连续多次渲染时, 每次都重新申请整帧图像、迭代场和临时缓冲区:
+ * - 新申请的页面需要再次缺页 (首次访问时由内核清零)
+ * - 大小不一的大块反复申请/释放会造成地址空间碎片
+ *
+ * 目前只有单进程内重复渲染的基准程序 (fractal_scaling 结束时打印池的命中数, fractal_scenarios)
+ * 会真正复用缓存块; 单次渲染的命令行程序每个尺寸等级只申请一次。
+ * API服务器每个请求启动一个新的 fractal_api 进程, 且 render_api.cpp 不使用本池。
+ *
+ * BufferPool 把不小于 MIN_POOLED_BYTES 的申请向上取整到尺寸等级
+ * (每个2的幂次区间分4级, 浪费不超过25%), 释放的块按等级缓存, 下次同等级申请直接复用
+ * 已缺页的"热"内存。缓存总量超过容量上限时直接归还系统。
+ *
+ * 不小于2MB的块默认按2MB对齐, 并通过 madvise(MADV_HUGEPAGE) 建议内核使用透明大页 (THP):
+ * 4K大帧缓冲区 (约24MB) 只需十几个页表项, 首次访问的缺页次数也减少到1/512。
+ * 尺寸等级不为大页取整 (不小于8MB的等级恰好是2MB的整数倍; 2-8MB的块末尾不足2MB的部分
+ * 仍用普通页), 因此浪费上限始终为25%。内核THP模式为 never 时建议无效, 行为不变。
+ *
+ * 所有方法线程安全。ImageBuffer / IterationField 的分配器自动经过全局池。
+ */
+
+namespace MandelbrotCPU {
+
+    class BufferPool {
+    public:
+        static constexpr size_t MIN_POOLED_BYTES = 256 * 1024;     // 小于此值不进入池
+        static constexpr size_t HUGE_PAGE_BYTES = 2 * 1024 * 1024; // 透明大页尺寸
+
+        // 池统计
+        struct Stats {
+            long long hits = 0;             // 复用缓存块的次数
+            long long misses = 0;           // 向系统申请新块的次数
+            size_t allocated_bytes = 0;     // 向系统申请的累计字节数
+            size_t cached_bytes = 0;        // 空闲缓存的字节数
+            size_t outstanding_bytes = 0;   // 已借出 (使用中) 的字节数
+            size_t peak_outstanding_bytes = 0;
+        };
+
+        /**
+         * 进程级全局池 (永不析构, 避免静态对象析构顺序问题)
+         */
+        static BufferPool& global();
+
+        /**
+         * 申请至少bytes字节 (不初始化)
+         */
+        void* acquire(size_t bytes);
+
+        /**
+         * 归还由acquire申请的块 (bytes须与申请时一致)
+         */
+        void release(void* ptr, size_t bytes);
+
+        /**
+         * 设置空闲缓存上限 (字节), 超出部分立即归还系统
+         */
+        void set_capacity(size_t bytes);
+
+        /**
+         * 不小于2MB的新块按2MB对齐分配并建议使用透明大页 (默认启用)
+         */
+        void set_huge_pages(bool enabled);
+
+        /**
+         * 内核透明大页模式 (always / madvise / never; 无法读取时为空)
+         */
+        static std::string transparent_huge_page_mode();
+
+        /**
+         * 释放全部空闲缓存
+         */
+        void trim();
+
+        Stats stats() const;
+
+        /**
+         * 申请尺寸对应的尺寸等级 (实际分配的字节数; 不小于2MB时为2MB的整数倍)
+         */
+        static size_t size_class(size_t bytes);
+
+    private:
+        BufferPool() = default;
+
+        struct Block {
+            void* ptr;
+            size_t bytes;
+        };
+
+        void* allocate_block(size_t bytes) const;
+        void trim_to(size_t capacity);
+
+        mutable std::mutex mutex_;
+        std::vector<Block> free_blocks_;        // 空闲块 (按尺寸等级匹配)
+        size_t capacity_ = 512ull * 1024 * 1024;
+        bool huge_pages_ = true;
+        Stats stats_;
+    };
+
+} // namespace MandelbrotCPU
@@ -3,6 +3,7 @@
 #include <vector>
 #include <string>
 #include <chrono>
+#include "render_counters.hpp"
 
 /**
  * Burning Ship Fractal Renderer
@@ -26,9 +27,9 @@ public:
     // Constructor with default parameters
     BurningShipCPU(int width = 800, int height = 600, int max_iterations = 1000);
     
-    // Core rendering methods
-    void render(double center_x = -0.5, double center_y = -0.5, double zoom = 1.0);
-    void renderToFile(const std::string& filename, double center_x = -0.5, 
+    // Core rendering methods (return the render time in milliseconds)
+    double render(double center_x = -0.5, double center_y = -0.5, double zoom = 1.0);
+    double renderToFile(const std::string& filename, double center_x = -0.5, 
                      double center_y = -0.5, double zoom = 1.0);
     
     // Burning Ship computation
@@ -43,6 +44,9 @@ public:
     int getHeight() const { return height_; }
     int getMaxIterations() const { return max_iterations_; }
     
+    // Hot-path counters of the last render() (iterations, escaped / max_iter pixels)
+    const MandelbrotCPU::RenderCounters& getCounters() const { return counters_; }
+    
     // Preset configurations
     static std::vector<std::tuple<std::string, double, double, double>> getPresets();
     
@@ -51,6 +55,7 @@ private:
     int height_;
     int max_iterations_;
     std::vector<std::vector<int>> fractal_data_;
+    MandelbrotCPU::RenderCounters counters_;
     
     // HSV to RGB conversion for smooth coloring
     std::vector<uint8_t> hsvToRgb(double h, double s, double v) const;
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * 计算代价热力图 (--cost-map) - 每像素实际执行的迭代次数
+ *
+ * - cost_heatmap_rgb: 对数刻度映射到 黑 -> 紫 -> 红 -> 橙 -> 黄 -> 白 的色带,
+ *   结果可直接交给现有的PPM写入函数
+ * - summarize_costs: 代价分布的百分位数与头部像素的代价占比
+ *   (p99远高于p50、前1%像素占大头时, 静态划分与跳过判定的收益最大)
+ */
+
+namespace MandelbrotCPU {
+
+    /**
+     * 代价分布摘要
+     */
+    struct CostSummary {
+        long long pixels = 0;       // 像素数
+        long long total = 0;        // 总迭代次数
+        double mean = 0.0;
+        int p50 = 0;
+        int p90 = 0;
+        int p99 = 0;
+        int max = 0;
+        double top1_share = 0.0;    // 代价最高的1%像素占总代价的比例
+        double top10_share = 0.0;   // 代价最高的10%像素占总代价的比例
+
+        /**
+         * 单行JSON (与 RenderCounters::to_json 同风格)
+         */
+        std::string to_json() const {
+            std::ostringstream json;
+            json << "{\"cost_map\": {\"pixels\": " << pixels
+                 << ", \"iterations\": " << total
+                 << ", \"mean\": " << mean
+                 << ", \"p50\": " << p50
+                 << ", \"p90\": " << p90
+                 << ", \"p99\": " << p99
+                 << ", \"max\": " << max
+                 << ", \"top1_share\": " << top1_share
+                 << ", \"top10_share\": " << top10_share
+                 << "}}";
+            return json.str();
+        }
+    };
+
+    /**
+     * 统计代价分布 (复制后排序, O(n log n), 只在渲染结束后调用一次)
+     */
+    inline CostSummary summarize_costs(const std::vector<int>& costs) {
+        CostSummary summary;
+        if (costs.empty()) return summary;
+
+        std::vector<int> sorted(costs);
+        std::sort(sorted.begin(), sorted.end());
+        const size_t n = sorted.size();
+
+        summary.pixels = static_cast<long long>(n);
+        for (int cost : sorted) summary.total += cost;
+        summary.mean = static_cast<double>(summary.total) / n;
+
+        auto percentile = [&](double q) { return sorted[std::min(n - 1, static_cast<size_t>(q * (n - 1) + 0.5))]; };
+        summary.p50 = percentile(0.50);
+        summary.p90 = percentile(0.90);
+        summary.p99 = percentile(0.99);
+        summary.max = sorted.back();
+
+        // 头部像素 (至少一个) 的代价之和
+        auto top_share = [&](double fraction) {
+            const size_t count = std::max<size_t>(1, static_cast<size_t>(n * fraction));
+            long long sum = 0;
+            for (size_t i = n - count; i < n; ++i) sum += sorted[i];
+            return summary.total > 0 ? static_cast<double>(sum) / summary.total : 0.0;
+        };
+        summary.top1_share = top_share(0.01);
+        summary.top10_share = top_share(0.10);
+
+        return summary;
+    }
+
+    /**
+     * 对数刻度热力图 (size = costs.size() * 3)
+     * @param costs 每像素代价 (行优先)
+     * @param max_cost 映射到白色的代价 (<=0 时取costs中的最大值)
+     */
+    inline std::vector<unsigned char> cost_heatmap_rgb(const std::vector<int>& costs, int max_cost = 0) {
+        // 色带节点 (均匀分布在 [0, 1])
+        static const unsigned char stops[][3] = {
+            {0, 0, 0}, {80, 18, 123}, {200, 40, 70}, {250, 140, 20}, {250, 230, 80}, {255, 255, 255}
+        };
+        const int num_segments = static_cast<int>(sizeof(stops) / sizeof(stops[0])) - 1;
+
+        if (max_cost <= 0) {
+            for (int cost : costs) max_cost = std::max(max_cost, cost);
+        }
+        const double scale = max_cost > 0 ? 1.0 / std::log1p(static_cast<double>(max_cost)) : 0.0;
+
+        std::vector<unsigned char> rgb(costs.size() * 3);
+        for (size_t i = 0; i < costs.size(); ++i) {
+            const double t = std::min(1.0, std::log1p(static_cast<double>(std::max(0, costs[i]))) * scale);
+            const int segment = std::min(num_segments - 1, static_cast<int>(t * num_segments));
+            const double f = t * num_segments - segment;
+            for (int c = 0; c < 3; ++c) {
+                rgb[i * 3 + c] = static_cast<unsigned char>(stops[segment][c] + f * (stops[segment + 1][c] - stops[segment][c]) + 0.5);
+            }
+        }
+        return rgb;
+    }
+
+} // namespace MandelbrotCPU
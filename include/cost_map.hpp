@@ -0,0 +1,85 @@
+#pragma once
+
+#include "render.hpp"
+#include <vector>
+
+/**
+ * 代价图 - 低分辨率探测驱动的静态负载划分
+ *
+ * 先以 1/probe_scale 的边长 (默认1/4, 即1/16像素数) 渲染一幅探测图,
+ * 将迭代次数汇总为每个分块的预计代价; 再沿分块遍历顺序把分块切成
+ * 代价均衡的连续段 (每线程一段), 只留一小部分分块作为可窃取的余量。
+ * 大部分分块无需原子竞争即可领取, 跨NUMA节点窃取也降到最少。
+ */
+
+namespace MandelbrotOMP {
+
+    /**
+     * 分块代价图 (与 make_tiles 的行优先分块编号一致)
+     */
+    struct CostMap {
+        int tiles_x = 0;
+        int tiles_y = 0;
+        int tile_size = 0;
+        int probe_width = 0;                // 探测图分辨率
+        int probe_height = 0;
+        std::vector<double> tile_costs;     // 每个分块的预计代价 (迭代次数量级)
+
+        double total() const;
+
+        /**
+         * 每个分块行的代价之和 (用于按代价划分NUMA节点的行区间)
+         */
+        std::vector<double> row_costs() const;
+    };
+
+    /**
+     * 渲染低分辨率探测图并估计分块代价 (OpenMP并行)
+     * 探测像素取全分辨率网格上 probe_scale x probe_scale 区块的中心点,
+     * 坐标映射与全分辨率渲染一致; 不含探测点的小分块单独采样其中心
+     * @param params 渲染参数
+     * @param tile_size 分块边长
+     * @param probe_scale 探测图缩小倍数 (每轴)
+     */
+    CostMap estimate_tile_costs(const MandelbrotCPU::RenderParams& params, int tile_size, int probe_scale = 4);
+
+    /**
+     * 由实测的每像素迭代次数汇总分块代价 (与探测使用相同的单像素代价模型)
+     * @param iterations 每像素迭代次数 (行优先, width * height)
+     */
+    CostMap cost_map_from_iterations(const std::vector<int>& iterations, int width, int height, int tile_size);
+
+    /**
+     * 探测代价与实测代价的一致性 (两图分块划分须相同)
+     */
+    struct CostMapAccuracy {
+        double correlation = 0.0;   // 分块代价的皮尔逊相关系数
+        double total_ratio = 0.0;   // 探测总代价 / 实测总代价
+    };
+
+    CostMapAccuracy compare_cost_maps(const CostMap& predicted, const CostMap& measured);
+
+    /**
+     * 代价均衡划分结果
+     */
+    struct CostPartition {
+        std::vector<std::vector<int>> chunks;   // 每段一组连续分块 (保持遍历顺序)
+        std::vector<int> remainder;             // 可窃取的余量分块
+        double max_chunk_cost = 0.0;            // 最重一段的预计代价
+        double mean_chunk_cost = 0.0;           // 平均每段的预计代价
+    };
+
+    /**
+     * 将按遍历顺序排列的分块切成代价均衡的连续段
+     * 每段目标代价为 (1 - remainder_fraction) * 总代价 / num_parts,
+     * 切点取前缀和最接近目标的位置; 最后剩余的分块归入余量
+     * @param ordered_tiles 分块编号 (按遍历顺序)
+     * @param tile_costs 分块代价 (按分块编号索引)
+     * @param num_parts 段数 (线程数)
+     * @param remainder_fraction 余量占总代价的比例 [0, 1)
+     */
+    CostPartition partition_by_cost(const std::vector<int>& ordered_tiles,
+                                    const std::vector<double>& tile_costs,
+                                    int num_parts, double remainder_fraction);
+
+} // namespace MandelbrotOMP
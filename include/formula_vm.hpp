@@ -0,0 +1,506 @@
+#pragma once
+
+/**
+ * User-defined escape-time formulas, compiled once to register bytecode and interpreted
+ * on kFormulaLanes pixels at a time.
+ *
+ * Language: one complex expression giving the next z, e.g.
+ *   z^2 + c                      Mandelbrot
+ *   abs(z)^2 + c                 Burning Ship
+ *   conj(z)^2 + c                Tricorn
+ *   z^2 + c + (0.5 - 0.2i)*prev  uses the previous iterate
+ * - variables: z (z0 = 0), c (the pixel), prev (z of the previous iteration, 0 at first)
+ * - numbers: 1.5, 2e-3, imaginary literals 0.5i, and the unit i
+ * - operators: + - * / ^ (right-associative), unary minus, parentheses
+ * - functions: abs (|re| + i|im|), conj, re, im, sqr, exp, log, sin, cos, pow(a, b)
+ * Iteration stops when |z|^2 > 4 (or z is NaN), as in the built-in kernels.
+ *
+ * Compilation: recursive descent to an expression tree, constant folding, integer powers
+ * expanded to square-and-multiply chains, then one instruction per remaining node. Registers
+ * 0-2 hold z, c and prev; constants are loaded once per row, temporaries follow.
+ *
+ * Interpretation: every register holds kFormulaLanes complex values and every instruction is
+ * a fixed-length loop over them (auto-vectorized at -O3), so the switch dispatch is paid once
+ * per 8 pixels. Lanes that escape keep their z and only stop counting; a group finishes when
+ * all of its lanes have escaped or maxIter is reached.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+const int kFormulaLanes = 8;
+const int kFormulaMaxRegisters = 256;
+
+enum FormulaOp : uint8_t {
+    FormulaAdd, FormulaSub, FormulaMul, FormulaDiv, FormulaPow,   // binary
+    FormulaNeg, FormulaSqr, FormulaAbs, FormulaConj, FormulaRe, FormulaIm,
+    FormulaExp, FormulaLog, FormulaSin, FormulaCos                // unary
+};
+
+struct FormulaInstruction {
+    FormulaOp op;
+    uint8_t dst, a, b;
+};
+
+// One complex value per lane
+struct FormulaRegister {
+    double re[kFormulaLanes];
+    double im[kFormulaLanes];
+};
+
+class FormulaProgram {
+public:
+    static const int kZ = 0, kC = 1, kPrev = 2;
+
+    /**
+     * Compile a formula; throws std::invalid_argument with the position of the error.
+     */
+    static FormulaProgram compile(const std::string& source) {
+        FormulaProgram program;
+        Parser parser(source);
+        std::unique_ptr<Node> tree = parser.parse();
+        program.result_ = program.emit(*tree);
+        return program;
+    }
+
+    size_t instructionCount() const { return code_.size(); }
+    int registerCount() const { return registerCount_; }
+
+    /**
+     * Escape counts for one row of pixels c = (startX + x * stepX, imag), x in [0, width)
+     */
+    void iterateRow(double startX, double stepX, double imag, int width, int maxIter, int* out) const {
+        thread_local std::vector<FormulaRegister> regs;
+        regs.resize(registerCount_);
+        for (size_t k = 0; k < constants_.size(); k++) {
+            for (int l = 0; l < kFormulaLanes; l++) {
+                regs[kFirstConstant + k].re[l] = constants_[k].re;
+                regs[kFirstConstant + k].im[l] = constants_[k].im;
+            }
+        }
+
+        for (int x0 = 0; x0 < width; x0 += kFormulaLanes) {
+            // Lanes past the row end repeat the last pixel
+            for (int l = 0; l < kFormulaLanes; l++) {
+                regs[kC].re[l] = startX + std::min(x0 + l, width - 1) * stepX;
+                regs[kC].im[l] = imag;
+            }
+            int counts[kFormulaLanes];
+            iterateGroup(regs.data(), maxIter, counts);
+            for (int l = 0; l < kFormulaLanes && x0 + l < width; l++) out[x0 + l] = counts[l];
+        }
+    }
+
+private:
+    static const int kFirstConstant = 3;
+
+    struct Complex {
+        double re, im;
+    };
+
+    // --- Expression tree ---
+
+    struct Node {
+        enum Kind { Constant, Variable, Operation } kind;
+        Complex value = {0.0, 0.0};     // Constant
+        int variable = 0;               // Variable: kZ, kC or kPrev
+        FormulaOp op = FormulaAdd;      // Operation
+        std::unique_ptr<Node> lhs, rhs;
+
+        explicit Node(Kind k) : kind(k) {}
+
+        static std::unique_ptr<Node> constant(double re, double im) {
+            std::unique_ptr<Node> node(new Node(Constant));
+            node->value = {re, im};
+            return node;
+        }
+        static std::unique_ptr<Node> variableNode(int index) {
+            std::unique_ptr<Node> node(new Node(Variable));
+            node->variable = index;
+            return node;
+        }
+        static std::unique_ptr<Node> operation(FormulaOp op, std::unique_ptr<Node> lhs, std::unique_ptr<Node> rhs = nullptr) {
+            std::unique_ptr<Node> node(new Node(Operation));
+            node->op = op;
+            node->lhs = std::move(lhs);
+            node->rhs = std::move(rhs);
+            return node;
+        }
+    };
+
+    class Parser {
+    public:
+        explicit Parser(const std::string& source) : src_(source) {}
+
+        std::unique_ptr<Node> parse() {
+            std::unique_ptr<Node> node = expression();
+            skipSpace();
+            if (pos_ < src_.size()) fail("unexpected '" + std::string(1, src_[pos_]) + "'");
+            return node;
+        }
+
+    private:
+        [[noreturn]] void fail(const std::string& message) const {
+            throw std::invalid_argument(message + " at position " + std::to_string(pos_ + 1));
+        }
+
+        void skipSpace() {
+            while (pos_ < src_.size() && std::isspace(static_cast<unsigned char>(src_[pos_]))) pos_++;
+        }
+
+        bool accept(char ch) {
+            skipSpace();
+            if (pos_ < src_.size() && src_[pos_] == ch) { pos_++; return true; }
+            return false;
+        }
+
+        void expect(char ch) {
+            if (!accept(ch)) fail(std::string("expected '") + ch + "'");
+        }
+
+        // expression := term (('+' | '-') term)*
+        std::unique_ptr<Node> expression() {
+            std::unique_ptr<Node> node = term();
+            for (;;) {
+                if (accept('+')) node = Node::operation(FormulaAdd, std::move(node), term());
+                else if (accept('-')) node = Node::operation(FormulaSub, std::move(node), term());
+                else return node;
+            }
+        }
+
+        // term := unary (('*' | '/') unary)*
+        std::unique_ptr<Node> term() {
+            std::unique_ptr<Node> node = unary();
+            for (;;) {
+                if (accept('*')) node = Node::operation(FormulaMul, std::move(node), unary());
+                else if (accept('/')) node = Node::operation(FormulaDiv, std::move(node), unary());
+                else return node;
+            }
+        }
+
+        // unary := '-' unary | power
+        std::unique_ptr<Node> unary() {
+            if (accept('-')) return Node::operation(FormulaNeg, unary());
+            if (accept('+')) return unary();
+            return power();
+        }
+
+        // power := primary ('^' unary)?   (z^-1 and z^2^2 = z^(2^2) parse as expected)
+        std::unique_ptr<Node> power() {
+            std::unique_ptr<Node> node = primary();
+            if (accept('^')) node = Node::operation(FormulaPow, std::move(node), unary());
+            return node;
+        }
+
+        std::unique_ptr<Node> primary() {
+            skipSpace();
+            if (pos_ >= src_.size()) fail("unexpected end of formula");
+            if (accept('(')) {
+                std::unique_ptr<Node> node = expression();
+                expect(')');
+                return node;
+            }
+
+            const char ch = src_[pos_];
+            if (std::isdigit(static_cast<unsigned char>(ch)) || ch == '.') {
+                const char* begin = src_.c_str() + pos_;
+                char* end = nullptr;
+                double value = std::strtod(begin, &end);
+                if (end == begin) fail("invalid number");
+                pos_ += end - begin;
+                // 0.5i is an imaginary literal
+                if (pos_ < src_.size() && src_[pos_] == 'i' &&
+                    (pos_ + 1 >= src_.size() || !std::isalnum(static_cast<unsigned char>(src_[pos_ + 1])))) {
+                    pos_++;
+                    return Node::constant(0.0, value);
+                }
+                return Node::constant(value, 0.0);
+            }
+
+            if (std::isalpha(static_cast<unsigned char>(ch))) {
+                const size_t start = pos_;
+                while (pos_ < src_.size() && (std::isalnum(static_cast<unsigned char>(src_[pos_])) || src_[pos_] == '_')) pos_++;
+                const std::string name = src_.substr(start, pos_ - start);
+
+                if (name == "z") return Node::variableNode(kZ);
+                if (name == "c") return Node::variableNode(kC);
+                if (name == "prev") return Node::variableNode(kPrev);
+                if (name == "i") return Node::constant(0.0, 1.0);
+
+                static const struct { const char* name; FormulaOp op; } unaryFunctions[] = {
+                    {"abs", FormulaAbs}, {"conj", FormulaConj}, {"re", FormulaRe}, {"im", FormulaIm},
+                    {"sqr", FormulaSqr}, {"exp", FormulaExp}, {"log", FormulaLog},
+                    {"sin", FormulaSin}, {"cos", FormulaCos}
+                };
+                for (const auto& function : unaryFunctions) {
+                    if (name != function.name) continue;
+                    expect('(');
+                    std::unique_ptr<Node> arg = expression();
+                    expect(')');
+                    return Node::operation(function.op, std::move(arg));
+                }
+                if (name == "pow") {
+                    expect('(');
+                    std::unique_ptr<Node> base = expression();
+                    expect(',');
+                    std::unique_ptr<Node> exponent = expression();
+                    expect(')');
+                    return Node::operation(FormulaPow, std::move(base), std::move(exponent));
+                }
+                pos_ = start;
+                fail("unknown name '" + name + "'");
+            }
+
+            fail("unexpected '" + std::string(1, ch) + "'");
+        }
+
+        const std::string& src_;
+        size_t pos_ = 0;
+    };
+
+    // --- Code generation ---
+    //
+    // While emitting, operands are tagged: variables keep 0-2, constants are kConstantTag + k and
+    // temporaries kTemporaryTag + t. emit() then numbers constants right after the variables
+    // and temporaries after the constants.
+
+    static const int kConstantTag = 1 << 16;
+    static const int kTemporaryTag = 1 << 20;
+
+    struct PendingInstruction {
+        FormulaOp op;
+        int dst, a, b;
+    };
+
+    int constantOperand(Complex value) {
+        for (size_t k = 0; k < constants_.size(); k++) {
+            if (constants_[k].re == value.re && constants_[k].im == value.im) return kConstantTag + int(k);
+        }
+        constants_.push_back(value);
+        return kConstantTag + int(constants_.size()) - 1;
+    }
+
+    int instruction(FormulaOp op, int a, int b = 0) {
+        const int dst = kTemporaryTag + int(pending_.size());
+        pending_.push_back({op, dst, a, b});
+        return dst;
+    }
+
+    // Folds a constant operation with the same lane code the interpreter runs
+    static Complex fold(FormulaOp op, Complex a, Complex b) {
+        FormulaRegister ra, rb, rd;
+        for (int l = 0; l < kFormulaLanes; l++) {
+            ra.re[l] = a.re; ra.im[l] = a.im;
+            rb.re[l] = b.re; rb.im[l] = b.im;
+        }
+        execute(op, rd, ra, rb);
+        return {rd.re[0], rd.im[0]};
+    }
+
+    // Folds constant subtrees in place; returns true when node became a constant
+    static bool foldConstants(Node& node) {
+        if (node.kind != Node::Operation) return node.kind == Node::Constant;
+        bool constant = foldConstants(*node.lhs);
+        if (node.rhs) constant = foldConstants(*node.rhs) && constant;
+        if (!constant) return false;
+        node.value = fold(node.op, node.lhs->value, node.rhs ? node.rhs->value : Complex{0.0, 0.0});
+        node.kind = Node::Constant;
+        node.lhs.reset();
+        node.rhs.reset();
+        return true;
+    }
+
+    // x^n for a small integer n by square-and-multiply
+    int emitIntegerPower(int base, int n) {
+        if (n == 0) return constantOperand({1.0, 0.0});
+        if (n < 0) return instruction(FormulaDiv, constantOperand({1.0, 0.0}), emitIntegerPower(base, -n));
+        int result = -1;
+        int square = base;
+        for (;;) {
+            if (n & 1) result = result < 0 ? square : instruction(FormulaMul, result, square);
+            n >>= 1;
+            if (!n) return result;
+            square = instruction(FormulaSqr, square);
+        }
+    }
+
+    int emitNode(const Node& node) {
+        if (node.kind == Node::Constant) return constantOperand(node.value);
+        if (node.kind == Node::Variable) return node.variable;
+
+        if (node.op == FormulaPow && node.rhs->kind == Node::Constant) {
+            const Complex e = node.rhs->value;
+            if (e.im == 0.0 && e.re == std::floor(e.re) && std::abs(e.re) <= 64.0) {
+                return emitIntegerPower(emitNode(*node.lhs), int(e.re));
+            }
+        }
+        const int a = emitNode(*node.lhs);
+        const int b = node.rhs ? emitNode(*node.rhs) : 0;
+        return instruction(node.op, a, b);
+    }
+
+    int resolve(int operand) const {
+        if (operand >= kTemporaryTag) return kFirstConstant + int(constants_.size()) + operand - kTemporaryTag;
+        if (operand >= kConstantTag) return kFirstConstant + operand - kConstantTag;
+        return operand;
+    }
+
+    int emit(Node& tree) {
+        foldConstants(tree);
+        const int result = emitNode(tree);
+
+        registerCount_ = kFirstConstant + int(constants_.size() + pending_.size());
+        if (registerCount_ > kFormulaMaxRegisters) throw std::invalid_argument("formula too complex");
+        for (const PendingInstruction& p : pending_) {
+            code_.push_back({p.op, uint8_t(resolve(p.dst)), uint8_t(resolve(p.a)), uint8_t(resolve(p.b))});
+        }
+        pending_.clear();
+        return resolve(result);
+    }
+
+    // --- Interpreter ---
+
+    static void execute(FormulaOp op, FormulaRegister& d, const FormulaRegister& a, const FormulaRegister& b) {
+        const int n = kFormulaLanes;
+        switch (op) {
+            case FormulaAdd:
+                for (int l = 0; l < n; l++) { d.re[l] = a.re[l] + b.re[l]; d.im[l] = a.im[l] + b.im[l]; }
+                break;
+            case FormulaSub:
+                for (int l = 0; l < n; l++) { d.re[l] = a.re[l] - b.re[l]; d.im[l] = a.im[l] - b.im[l]; }
+                break;
+            case FormulaMul:
+                for (int l = 0; l < n; l++) {
+                    double re = a.re[l] * b.re[l] - a.im[l] * b.im[l];
+                    double im = a.re[l] * b.im[l] + a.im[l] * b.re[l];
+                    d.re[l] = re; d.im[l] = im;
+                }
+                break;
+            case FormulaDiv:
+                for (int l = 0; l < n; l++) {
+                    double denom = b.re[l] * b.re[l] + b.im[l] * b.im[l];
+                    double re = (a.re[l] * b.re[l] + a.im[l] * b.im[l]) / denom;
+                    double im = (a.im[l] * b.re[l] - a.re[l] * b.im[l]) / denom;
+                    d.re[l] = re; d.im[l] = im;
+                }
+                break;
+            case FormulaPow:
+                // General complex power exp(b log a); integer constant powers never get here
+                for (int l = 0; l < n; l++) {
+                    if (a.re[l] == 0.0 && a.im[l] == 0.0) {
+                        d.re[l] = (b.re[l] == 0.0 && b.im[l] == 0.0) ? 1.0 : 0.0;
+                        d.im[l] = 0.0;
+                        continue;
+                    }
+                    double logR = 0.5 * std::log(a.re[l] * a.re[l] + a.im[l] * a.im[l]);
+                    double theta = std::atan2(a.im[l], a.re[l]);
+                    double re = b.re[l] * logR - b.im[l] * theta;
+                    double im = b.re[l] * theta + b.im[l] * logR;
+                    double scale = std::exp(re);
+                    d.re[l] = scale * std::cos(im);
+                    d.im[l] = scale * std::sin(im);
+                }
+                break;
+            case FormulaNeg:
+                for (int l = 0; l < n; l++) { d.re[l] = -a.re[l]; d.im[l] = -a.im[l]; }
+                break;
+            case FormulaSqr:
+                // Same operation order as the built-in kernels (zx2 - zy2, 2 * zx * zy)
+                for (int l = 0; l < n; l++) {
+                    double re = a.re[l] * a.re[l] - a.im[l] * a.im[l];
+                    double im = 2.0 * a.re[l] * a.im[l];
+                    d.re[l] = re; d.im[l] = im;
+                }
+                break;
+            case FormulaAbs:
+                for (int l = 0; l < n; l++) { d.re[l] = std::abs(a.re[l]); d.im[l] = std::abs(a.im[l]); }
+                break;
+            case FormulaConj:
+                for (int l = 0; l < n; l++) { d.re[l] = a.re[l]; d.im[l] = -a.im[l]; }
+                break;
+            case FormulaRe:
+                for (int l = 0; l < n; l++) { d.re[l] = a.re[l]; d.im[l] = 0.0; }
+                break;
+            case FormulaIm:
+                for (int l = 0; l < n; l++) { d.re[l] = a.im[l]; d.im[l] = 0.0; }
+                break;
+            case FormulaExp:
+                for (int l = 0; l < n; l++) {
+                    double scale = std::exp(a.re[l]);
+                    double im = a.im[l];
+                    d.re[l] = scale * std::cos(im);
+                    d.im[l] = scale * std::sin(im);
+                }
+                break;
+            case FormulaLog:
+                for (int l = 0; l < n; l++) {
+                    double re = 0.5 * std::log(a.re[l] * a.re[l] + a.im[l] * a.im[l]);
+                    double im = std::atan2(a.im[l], a.re[l]);
+                    d.re[l] = re; d.im[l] = im;
+                }
+                break;
+            case FormulaSin:
+                for (int l = 0; l < n; l++) {
+                    double re = std::sin(a.re[l]) * std::cosh(a.im[l]);
+                    double im = std::cos(a.re[l]) * std::sinh(a.im[l]);
+                    d.re[l] = re; d.im[l] = im;
+                }
+                break;
+            case FormulaCos:
+                for (int l = 0; l < n; l++) {
+                    double re = std::cos(a.re[l]) * std::cosh(a.im[l]);
+                    double im = -std::sin(a.re[l]) * std::sinh(a.im[l]);
+                    d.re[l] = re; d.im[l] = im;
+                }
+                break;
+        }
+    }
+
+    void iterateGroup(FormulaRegister* regs, int maxIter, int* counts) const {
+        FormulaRegister& z = regs[kZ];
+        FormulaRegister& prev = regs[kPrev];
+        for (int l = 0; l < kFormulaLanes; l++) {
+            z.re[l] = z.im[l] = 0.0;
+            prev.re[l] = prev.im[l] = 0.0;
+            counts[l] = maxIter;
+        }
+        const FormulaRegister& next = regs[result_];
+
+        for (int i = 0; i < maxIter; i++) {
+            // Escape test before the step, like the built-in kernels; NaN counts as escaped
+            bool anyActive = false;
+            for (int l = 0; l < kFormulaLanes; l++) {
+                if (counts[l] != maxIter) continue;
+                if (!(z.re[l] * z.re[l] + z.im[l] * z.im[l] <= 4.0)) counts[l] = i;
+                else anyActive = true;
+            }
+            if (!anyActive) return;
+
+            for (const FormulaInstruction& instruction : code_) {
+                execute(instruction.op, regs[instruction.dst], regs[instruction.a], regs[instruction.b]);
+            }
+
+            // Escaped lanes keep their z (and prev), so they stay finite and escaped
+            for (int l = 0; l < kFormulaLanes; l++) {
+                if (counts[l] != maxIter) continue;
+                prev.re[l] = z.re[l];
+                prev.im[l] = z.im[l];
+                z.re[l] = next.re[l];
+                z.im[l] = next.im[l];
+            }
+        }
+    }
+
+    std::vector<FormulaInstruction> code_;
+    std::vector<Complex> constants_;
+    std::vector<PendingInstruction> pending_;
+    int registerCount_ = kFirstConstant;
+    int result_ = kZ;
+};
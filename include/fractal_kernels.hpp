@@ -0,0 +1,245 @@
+#pragma once
+
+/**
+ * Fractal iteration kernels shared by the server-side API binary and the benchmarks.
+ *
+ * Header-only so that render_api.cpp still builds as a single translation unit
+ * (g++ src/render_api.cpp) in the Docker images and the Makefile fallback. The same holds
+ * for every other header render_api.cpp includes: header-only, standard library only.
+ */
+
+#include <cmath>
+
+// Interior shortcuts: points inside the main cardioid or the period-2 bulb never escape
+enum MandelbrotShortcut { NoShortcut = 0, CardioidShortcut, BulbShortcut };
+
+inline MandelbrotShortcut mandelbrotShortcut(double real, double imag) {
+    // Cardioid check
+    double cy2 = imag * imag;
+    double q = (real - 0.25) * (real - 0.25) + cy2;
+    if (q * (q + (real - 0.25)) <= 0.25 * cy2) return CardioidShortcut;
+    // Period-2 bulb
+    if ((real + 1.0) * (real + 1.0) + cy2 <= 0.0625) return BulbShortcut;
+    return NoShortcut;
+}
+
+// Escape-time loop without shortcuts; the result is the number of iterations executed
+inline int mandelbrotEscapeIterations(double real, double imag, int maxIter) {
+    double zx = 0.0, zy = 0.0, zx2 = 0.0, zy2 = 0.0;
+    for (int i = 0; i < maxIter; i++) {
+        if (zx2 + zy2 > 4.0) return i;
+        zy = 2.0 * zx * zy + imag;
+        zx = zx2 - zy2 + real;
+        zx2 = zx * zx;
+        zy2 = zy * zy;
+    }
+    return maxIter;
+}
+
+inline int mandelbrotIterations(double real, double imag, int maxIter) {
+    if (mandelbrotShortcut(real, imag) != NoShortcut) return maxIter;
+    return mandelbrotEscapeIterations(real, imag, maxIter);
+}
+
+inline int juliaIterations(double real, double imag, double cReal, double cImag, int maxIter) {
+    double zx = real, zy = imag;
+    for (int i = 0; i < maxIter; i++) {
+        if (zx * zx + zy * zy > 4.0) return i;
+        double tmp = zx * zx - zy * zy + cReal;
+        zy = 2.0 * zx * zy + cImag;
+        zx = tmp;
+    }
+    return maxIter;
+}
+
+inline int burningShipIterations(double real, double imag, int maxIter) {
+    double zx = 0.0, zy = 0.0;
+    for (int i = 0; i < maxIter; i++) {
+        if (zx * zx + zy * zy > 4.0) return i;
+        double ax = std::abs(zx), ay = std::abs(zy);
+        double tmp = ax * ax - ay * ay + real;
+        zy = 2.0 * ax * ay + imag;
+        zx = tmp;
+    }
+    return maxIter;
+}
+
+inline int newtonIterations(double real, double imag, int maxIter) {
+    double zx = real, zy = imag;
+    const double tol = 1e-6;
+    const double roots[][2] = {{1.0, 0.0}, {-0.5, 0.866025403784}, {-0.5, -0.866025403784}};
+
+    for (int i = 0; i < maxIter; i++) {
+        double z2x = zx * zx - zy * zy;
+        double z2y = 2.0 * zx * zy;
+        double z3x = z2x * zx - z2y * zy;
+        double z3y = z2x * zy + z2y * zx;
+
+        double fx = z3x - 1.0;
+        double fy = z3y;
+        double fpx = 3.0 * z2x;
+        double fpy = 3.0 * z2y;
+
+        double denom = fpx * fpx + fpy * fpy;
+        if (denom < tol) break;
+
+        double qx = (fx * fpx + fy * fpy) / denom;
+        double qy = (fy * fpx - fx * fpy) / denom;
+        zx -= qx;
+        zy -= qy;
+
+        for (int j = 0; j < 3; j++) {
+            double dx = zx - roots[j][0];
+            double dy = zy - roots[j][1];
+            if (dx * dx + dy * dy < tol)
+                return (j + 1) * 1000 + i;
+        }
+    }
+    return 0;
+}
+
+// Tricorn (Mandelbar): z_{n+1} = conj(z)^2 + c
+inline int tricornIterations(double real, double imag, int maxIter) {
+    double zx = 0.0, zy = 0.0, zx2 = 0.0, zy2 = 0.0;
+    for (int i = 0; i < maxIter; i++) {
+        if (zx2 + zy2 > 4.0) return i;
+        zy = -2.0 * zx * zy + imag;
+        zx = zx2 - zy2 + real;
+        zx2 = zx * zx;
+        zy2 = zy * zy;
+    }
+    return maxIter;
+}
+
+// Phoenix: z_{n+1} = z_n^2 + p_re + p_im * z_{n-1}
+inline int phoenixIterations(double real, double imag, double pReal, double pImag, int maxIter) {
+    double zx = real, zy = imag;
+    double prevX = 0.0, prevY = 0.0;
+    double zx2 = zx * zx, zy2 = zy * zy;
+    for (int i = 0; i < maxIter; i++) {
+        if (zx2 + zy2 > 4.0) return i;
+        double nx = zx2 - zy2 + pReal + pImag * prevX;
+        double ny = 2.0 * zx * zy + pImag * prevY;
+        prevX = zx; prevY = zy;
+        zx = nx; zy = ny;
+        zx2 = zx * zx; zy2 = zy * zy;
+    }
+    return maxIter;
+}
+
+// --- Distance estimation ---
+
+// Escape count plus an exterior distance estimate, for coverage-based anti-aliasing.
+// The derivative dz is carried through the same loop as the plain kernel, so `iterations`
+// matches the corresponding *Iterations function exactly. After the escape test passes,
+// up to kDistanceExtraIterations more steps run until |z|^2 > kDistanceBailout2 so that the
+// estimate d = |z| ln|z| / |dz| is accurate (it is within a factor of ~4 of the true
+// distance to the set; Burning Ship and Tricorn use the folded derivative, a heuristic).
+// distance is < 0 for points that did not escape.
+struct EscapeDistance {
+    int iterations;
+    double distance;
+};
+
+const int kDistanceExtraIterations = 16;
+const double kDistanceBailout2 = 1e10;
+
+// One z = fold(z)^2 + c step with its derivative. Fold: 0 = none (Mandelbrot/Julia),
+// 1 = conj (Tricorn), 2 = abs of both parts (Burning Ship)
+template <int Fold>
+inline void distanceStep(double& zx, double& zy, double& dzx, double& dzy, double cr, double ci, double dc) {
+    if (Fold == 1) { zy = -zy; dzy = -dzy; }
+    if (Fold == 2) {
+        if (zx < 0) { zx = -zx; dzx = -dzx; }
+        if (zy < 0) { zy = -zy; dzy = -dzy; }
+    }
+    double ndx = 2.0 * (zx * dzx - zy * dzy) + dc;
+    double ndy = 2.0 * (zx * dzy + zy * dzx);
+    double nzx = zx * zx - zy * zy + cr;
+    zy = 2.0 * zx * zy + ci;
+    zx = nzx;
+    dzx = ndx;
+    dzy = ndy;
+}
+
+template <int Fold>
+inline EscapeDistance escapeDistance(double zx, double zy, double dzx, double dzy,
+                                     double cr, double ci, double dc, int maxIter) {
+    for (int i = 0; i < maxIter; i++) {
+        double r2 = zx * zx + zy * zy;
+        if (r2 > 4.0) {
+            // Iterations are counted at the plain bailout; the extra steps only sharpen the estimate
+            for (int extra = 0; extra < kDistanceExtraIterations && r2 <= kDistanceBailout2; extra++) {
+                distanceStep<Fold>(zx, zy, dzx, dzy, cr, ci, dc);
+                r2 = zx * zx + zy * zy;
+            }
+            double dz = std::sqrt(dzx * dzx + dzy * dzy);
+            double r = std::sqrt(r2);
+            return {i, dz > 0.0 ? r * std::log(r) / dz : 0.0};
+        }
+        distanceStep<Fold>(zx, zy, dzx, dzy, cr, ci, dc);
+    }
+    return {maxIter, -1.0};
+}
+
+// dz/dc, z0 = 0
+inline EscapeDistance mandelbrotDistance(double real, double imag, int maxIter) {
+    return escapeDistance<0>(0.0, 0.0, 0.0, 0.0, real, imag, 1.0, maxIter);
+}
+
+// dz/dz0, z0 = pixel
+inline EscapeDistance juliaDistance(double real, double imag, double cReal, double cImag, int maxIter) {
+    return escapeDistance<0>(real, imag, 1.0, 0.0, cReal, cImag, 0.0, maxIter);
+}
+
+inline EscapeDistance burningShipDistance(double real, double imag, int maxIter) {
+    return escapeDistance<2>(0.0, 0.0, 0.0, 0.0, real, imag, 1.0, maxIter);
+}
+
+inline EscapeDistance tricornDistance(double real, double imag, int maxIter) {
+    return escapeDistance<1>(0.0, 0.0, 0.0, 0.0, real, imag, 1.0, maxIter);
+}
+
+// --- SIMD variants ---
+
+// Plain Mandelbrot escape count for 4 points at once (no cardioid/bulb shortcut).
+// Lane results equal the scalar loop "if (|z|^2 > 4) break; z = z^2 + c; ++i".
+// Uses GCC/Clang vector extensions, which lower to SSE2/AVX/NEON as available.
+#if defined(__GNUC__) || defined(__clang__)
+typedef double Vec4d __attribute__((vector_size(32)));
+typedef long long Vec4l __attribute__((vector_size(32)));
+
+inline void mandelbrotIterations4(const double* real, const double* imag, int maxIter, int* out) {
+    const Vec4d cr = {real[0], real[1], real[2], real[3]};
+    const Vec4d ci = {imag[0], imag[1], imag[2], imag[3]};
+    const Vec4d four = {4.0, 4.0, 4.0, 4.0};
+    Vec4d zx = {0.0, 0.0, 0.0, 0.0};
+    Vec4d zy = {0.0, 0.0, 0.0, 0.0};
+    Vec4l count = {0, 0, 0, 0};
+
+    for (int i = 0; i < maxIter; i++) {
+        Vec4d zx2 = zx * zx, zy2 = zy * zy;
+        Vec4l active = (zx2 + zy2) <= four;   // -1 in lanes still iterating
+        if (!(active[0] | active[1] | active[2] | active[3])) break;
+        count -= active;
+        zy = 2.0 * zx * zy + ci;
+        zx = zx2 - zy2 + cr;
+    }
+
+    for (int lane = 0; lane < 4; lane++) out[lane] = int(count[lane]);
+}
+#else
+inline void mandelbrotIterations4(const double* real, const double* imag, int maxIter, int* out) {
+    for (int lane = 0; lane < 4; lane++) {
+        double zx = 0.0, zy = 0.0;
+        int i = 0;
+        for (; i < maxIter; i++) {
+            double zx2 = zx * zx, zy2 = zy * zy;
+            if (zx2 + zy2 > 4.0) break;
+            zy = 2.0 * zx * zy + imag[lane];
+            zx = zx2 - zy2 + real[lane];
+        }
+        out[lane] = i;
+    }
+}
+#endif
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "buffer_pool.hpp"
+#include <memory>
+#include <vector>
+
+/**
+ * 图像缓冲区 - 不做零初始化的像素容器
+ *
+ * std::vector<unsigned char>(n) 会由分配线程把所有字节清零, 导致:
+ * - 渲染前多一次整帧写入
+ * - Linux首次访问(first-touch)策略下, 所有内存页都落在分配线程所在的NUMA节点
+ *
+ * ImageBuffer 的 resize/构造只分配不初始化, 由渲染线程首次写入时决定页面归属。
+ * 调用方必须保证每个字节在读取前都被写入。
+ *
+ * 大块内存 (>= BufferPool::MIN_POOLED_BYTES) 从全局缓冲区池申请, 释放后留待下次渲染复用。
+ */
+
+namespace MandelbrotCPU {
+
+    template <typename T>
+    class DefaultInitAllocator : public std::allocator<T> {
+    public:
+        template <typename U>
+        struct rebind {
+            using other = DefaultInitAllocator<U>;
+        };
+
+        DefaultInitAllocator() noexcept = default;
+
+        template <typename U>
+        DefaultInitAllocator(const DefaultInitAllocator<U>&) noexcept {}
+
+        T* allocate(size_t n) {
+            const size_t bytes = n * sizeof(T);
+            if (bytes >= BufferPool::MIN_POOLED_BYTES) {
+                return static_cast<T*>(BufferPool::global().acquire(bytes));
+            }
+            return std::allocator<T>::allocate(n);
+        }
+
+        void deallocate(T* ptr, size_t n) {
+            const size_t bytes = n * sizeof(T);
+            if (bytes >= BufferPool::MIN_POOLED_BYTES) {
+                BufferPool::global().release(ptr, bytes);
+                return;
+            }
+            std::allocator<T>::deallocate(ptr, n);
+        }
+
+        // 无参构造使用默认初始化 (对基本类型即不初始化)
+        template <typename U>
+        void construct(U* ptr) noexcept {
+            ::new (static_cast<void*>(ptr)) U;
+        }
+
+        template <typename U, typename... Args>
+        void construct(U* ptr, Args&&... args) {
+            ::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+        }
+    };
+
+    // RGB像素缓冲区 (size = width * height * 3)
+    using ImageBuffer = std::vector<unsigned char, DefaultInitAllocator<unsigned char>>;
+
+    /**
+     * 预缺页: 每个4KB页写入一个字节, 提前完成缺页 (及透明大页的分配)
+     * 并行调用时各线程负责不同区间, 页面落在执行线程所在的NUMA节点
+     * @param data 区间起点
+     * @param bytes 区间字节数
+     */
+    inline void prefault_pages(void* data, size_t bytes) {
+        const size_t PAGE_BYTES = 4096;
+        volatile unsigned char* bytes_ptr = static_cast<unsigned char*>(data);
+        for (size_t offset = 0; offset < bytes; offset += PAGE_BYTES) {
+            bytes_ptr[offset] = 0;
+        }
+    }
+
+} // namespace MandelbrotCPU
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * 图像缩放 (超采样渲染的缩小、缩略图) - 可分离滤波, 线性光空间, 按行带流式输入
+ *
+ * - 滤波器: box / tent / Lanczos-3, 缩小时按缩放比例展宽 (抗混叠), 边缘像素复制
+ * - 输入按sRGB解码到线性光 (查表), 滤波后再编码回sRGB (查表), 避免在gamma空间平均导致发暗
+ * - 流式: 调用方按行带追加输入, 每当某个输出行所需的输入行已到齐就立即输出;
+ *   只保留滤波窗口内的水平滤波结果, 内存与输入高度无关
+ * - 每个像素以4个float的向量 (RGB + 填充) 运算, 水平/垂直卷积都是整像素的向量乘加;
+ *   水平滤波 (按输入行) 与垂直滤波 (按输出行) 都可由调用方提供的 parallel_for 并行
+ */
+
+namespace MandelbrotCPU {
+
+    enum class ResampleFilter { Box, Tent, Lanczos3 };
+
+    /**
+     * 解析滤波器名称 (box, tent, lanczos3)
+     */
+    inline bool parse_resample_filter(const std::string& name, ResampleFilter& filter) {
+        if (name == "box") filter = ResampleFilter::Box;
+        else if (name == "tent") filter = ResampleFilter::Tent;
+        else if (name == "lanczos3") filter = ResampleFilter::Lanczos3;
+        else return false;
+        return true;
+    }
+
+#if defined(__GNUC__) || defined(__clang__)
+    typedef float Pixel4f __attribute__((vector_size(16)));  // 线性光 R, G, B, 填充
+#else
+    struct Pixel4f {
+        float v[4];
+        float& operator[](int i) { return v[i]; }
+        float operator[](int i) const { return v[i]; }
+        Pixel4f& operator+=(const Pixel4f& o) { for (int i = 0; i < 4; ++i) v[i] += o.v[i]; return *this; }
+        friend Pixel4f operator*(float s, const Pixel4f& p) { Pixel4f r; for (int i = 0; i < 4; ++i) r.v[i] = s * p.v[i]; return r; }
+    };
+#endif
+
+    /**
+     * 串行执行 (Downsampler::push_rows 的默认 parallel_for)
+     */
+    struct SerialFor {
+        template <typename Body>
+        void operator()(int count, Body&& body) const {
+            for (int i = 0; i < count; ++i) body(i);
+        }
+    };
+
+    class Downsampler {
+    public:
+        /**
+         * @param src_width 输入宽度
+         * @param src_height 输入高度
+         * @param dst_width 输出宽度 (任意比例; 超采样时为输入的整数分之一)
+         * @param dst_height 输出高度
+         * @param filter 滤波器
+         */
+        Downsampler(int src_width, int src_height, int dst_width, int dst_height, ResampleFilter filter)
+            : src_width_(src_width), src_height_(src_height), dst_width_(dst_width), dst_height_(dst_height),
+              horizontal_(make_weights(src_width, dst_width, filter)),
+              vertical_(make_weights(src_height, dst_height, filter)) {
+            for (int i = 0; i < 256; ++i) {
+                const double c = i / 255.0;
+                to_linear_[i] = static_cast<float>(c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+            }
+            for (int i = 0; i < kEncodeSize; ++i) {
+                const double l = static_cast<double>(i) / (kEncodeSize - 1);
+                const double c = l <= 0.0031308 ? l * 12.92 : 1.055 * std::pow(l, 1.0 / 2.4) - 0.055;
+                to_srgb_[i] = static_cast<unsigned char>(std::min(255.0, c * 255.0 + 0.5));
+            }
+        }
+
+        int dst_width() const { return dst_width_; }
+        int dst_height() const { return dst_height_; }
+        int rows_pushed() const { return rows_pushed_; }
+        int rows_emitted() const { return next_out_; }
+
+        /**
+         * 追加count行输入 (RGB8, 行跨度 src_width * 3), 并输出所有输入已到齐的输出行
+         * @param emit emit(y, row): 按输出行顺序在调用线程上调用, row为 dst_width * 3 字节
+         * @param parallel_for parallel_for(n, body): 对 body(0..n-1) 并行执行 (各次调用互不相干)
+         */
+        template <typename Emit, typename ParallelFor = SerialFor>
+        void push_rows(const unsigned char* rows, int count, Emit&& emit, ParallelFor&& parallel_for = ParallelFor()) {
+            count = std::min(count, src_height_ - rows_pushed_);
+            if (count <= 0) return;
+
+            // 1. 水平滤波: 每个输入行独立, 结果放入窗口
+            const size_t first_new = rows_.size();
+            for (int i = 0; i < count; ++i) {
+                if (free_rows_.empty()) {
+                    rows_.emplace_back(dst_width_);
+                } else {
+                    rows_.push_back(std::move(free_rows_.back()));
+                    free_rows_.pop_back();
+                }
+            }
+            parallel_for(count, [&](int i) {
+                filter_row(rows + static_cast<size_t>(i) * src_width_ * 3, rows_[first_new + i].data());
+            });
+            rows_pushed_ += count;
+
+            // 2. 垂直滤波: 所需输入行都已到齐的输出行
+            int ready_end = next_out_;
+            while (ready_end < dst_height_ && vertical_.start[ready_end] + vertical_.taps <= rows_pushed_) {
+                ++ready_end;
+            }
+            const int ready = ready_end - next_out_;
+            if (ready == 0) return;
+
+            const size_t dst_row_bytes = static_cast<size_t>(dst_width_) * 3;
+            out_.resize(ready * dst_row_bytes);
+            parallel_for(ready, [&](int i) {
+                encode_row(next_out_ + i, out_.data() + i * dst_row_bytes);
+            });
+            for (int i = 0; i < ready; ++i) emit(next_out_ + i, out_.data() + i * dst_row_bytes);
+            next_out_ = ready_end;
+
+            // 3. 丢弃之后的输出行不再需要的输入行
+            const int keep_from = next_out_ < dst_height_ ? vertical_.start[next_out_] : rows_pushed_;
+            while (first_row_ < keep_from && !rows_.empty()) {
+                free_rows_.push_back(std::move(rows_.front()));
+                rows_.pop_front();
+                ++first_row_;
+            }
+        }
+
+    private:
+        static constexpr int kEncodeSize = 4096;  // 线性光 -> sRGB 查找表精度 (12位)
+
+        // 每个输出位置: 从start起连续taps个输入的权重 (已归一化, 边缘复制已并入)
+        struct Weights {
+            int taps = 0;
+            std::vector<int> start;
+            std::vector<float> weights;  // [output * taps + k]
+        };
+
+        static double filter_support(ResampleFilter filter) {
+            switch (filter) {
+                case ResampleFilter::Box: return 0.5;
+                case ResampleFilter::Tent: return 1.0;
+                default: return 3.0;
+            }
+        }
+
+        static double filter_weight(ResampleFilter filter, double x) {
+            switch (filter) {
+                case ResampleFilter::Box:
+                    return x >= -0.5 && x < 0.5 ? 1.0 : 0.0;
+                case ResampleFilter::Tent:
+                    return std::max(0.0, 1.0 - std::abs(x));
+                default: {
+                    if (x == 0.0) return 1.0;
+                    if (std::abs(x) >= 3.0) return 0.0;
+                    const double pi_x = 3.14159265358979323846 * x;
+                    return 3.0 * std::sin(pi_x) * std::sin(pi_x / 3.0) / (pi_x * pi_x);
+                }
+            }
+        }
+
+        static Weights make_weights(int src, int dst, ResampleFilter filter) {
+            const double scale = static_cast<double>(src) / dst;
+            const double stretch = std::max(1.0, scale);  // 缩小时展宽滤波器
+            const double radius = filter_support(filter) * stretch;
+
+            Weights result;
+            result.taps = std::min(src, static_cast<int>(std::ceil(2.0 * radius)) + 1);
+            result.start.resize(dst);
+            result.weights.assign(static_cast<size_t>(dst) * result.taps, 0.0f);
+
+            std::vector<double> accum(result.taps);
+            for (int j = 0; j < dst; ++j) {
+                const double center = (j + 0.5) * scale - 0.5;
+                const int lo = static_cast<int>(std::floor(center - radius));
+                const int hi = static_cast<int>(std::ceil(center + radius));
+                const int start = std::min(std::max(lo, 0), src - result.taps);
+
+                std::fill(accum.begin(), accum.end(), 0.0);
+                double sum = 0.0;
+                for (int i = lo; i <= hi; ++i) {
+                    const double w = filter_weight(filter, (i - center) / stretch);
+                    if (w == 0.0) continue;
+                    const int clamped = std::min(std::max(i, 0), src - 1);
+                    const int k = clamped - start;
+                    if (k < 0 || k >= result.taps) continue;
+                    accum[k] += w;
+                    sum += w;
+                }
+                result.start[j] = start;
+                for (int k = 0; k < result.taps; ++k) {
+                    result.weights[static_cast<size_t>(j) * result.taps + k] =
+                        static_cast<float>(sum != 0.0 ? accum[k] / sum : (k == 0 ? 1.0 : 0.0));
+                }
+            }
+            return result;
+        }
+
+        // 解码到线性光后做水平卷积
+        void filter_row(const unsigned char* src, Pixel4f* dst) const {
+            thread_local std::vector<Pixel4f> linear;
+            linear.resize(src_width_);
+            for (int x = 0; x < src_width_; ++x) {
+                linear[x] = Pixel4f{to_linear_[src[x * 3]], to_linear_[src[x * 3 + 1]], to_linear_[src[x * 3 + 2]], 0.0f};
+            }
+
+            const int taps = horizontal_.taps;
+            for (int j = 0; j < dst_width_; ++j) {
+                const Pixel4f* in = linear.data() + horizontal_.start[j];
+                const float* w = horizontal_.weights.data() + static_cast<size_t>(j) * taps;
+                Pixel4f acc = {0.0f, 0.0f, 0.0f, 0.0f};
+                for (int k = 0; k < taps; ++k) acc += w[k] * in[k];
+                dst[j] = acc;
+            }
+        }
+
+        // 垂直卷积后编码回sRGB
+        void encode_row(int y, unsigned char* dst) const {
+            thread_local std::vector<Pixel4f> acc;
+            acc.assign(dst_width_, Pixel4f{0.0f, 0.0f, 0.0f, 0.0f});
+
+            const int taps = vertical_.taps;
+            const float* w = vertical_.weights.data() + static_cast<size_t>(y) * taps;
+            for (int k = 0; k < taps; ++k) {
+                if (w[k] == 0.0f) continue;
+                const Pixel4f* in = rows_[vertical_.start[y] + k - first_row_].data();
+                const float weight = w[k];
+                for (int x = 0; x < dst_width_; ++x) acc[x] += weight * in[x];
+            }
+
+            for (int x = 0; x < dst_width_; ++x) {
+                for (int c = 0; c < 3; ++c) {
+                    const float v = std::min(1.0f, std::max(0.0f, acc[x][c]));
+                    dst[x * 3 + c] = to_srgb_[static_cast<int>(v * (kEncodeSize - 1) + 0.5f)];
+                }
+            }
+        }
+
+        int src_width_;
+        int src_height_;
+        int dst_width_;
+        int dst_height_;
+        Weights horizontal_;
+        Weights vertical_;
+
+        int rows_pushed_ = 0;
+        int next_out_ = 0;                              // 下一个待输出的行
+        int first_row_ = 0;                             // rows_[0] 对应的输入行
+        std::deque<std::vector<Pixel4f>> rows_;         // 水平滤波后的输入行窗口
+        std::vector<std::vector<Pixel4f>> free_rows_;   // 回收的行缓冲
+        std::vector<unsigned char> out_;                // 本批输出行
+
+        float to_linear_[256];
+        unsigned char to_srgb_[kEncodeSize];
+    };
+
+} // namespace MandelbrotCPU
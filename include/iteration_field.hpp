@@ -0,0 +1,101 @@
+#pragma once
+
+#include "image_buffer.hpp"
+#include "tile_order.hpp"
+#include <vector>
+
+/**
+ * 迭代场 - 按Morton顺序存放的分块迭代次数
+ *
+ * 内存布局:
+ * - 图像划分为 tile_size x tile_size 的分块 (tile_size 为2的幂次)
+ * - 每个分块占一段连续内存 (块内行优先, 边缘分块同样占满整块)
+ * - 分块之间按Morton顺序排列: 空间相邻的分块在内存中也相邻
+ *
+ * 相比整图行优先存储, 访问单个分块及其邻域只触及少量连续页面,
+ * 分块渲染时每个分块的写入也恰好落在一段连续内存上 (利于first-touch和预取)。
+ */
+
+namespace MandelbrotOMP {
+
+    class IterationField {
+    public:
+        IterationField() = default;
+
+        /**
+         * @param width 图像宽度
+         * @param height 图像高度
+         * @param tile_size 分块边长 (向上取整为2的幂次)
+         */
+        IterationField(int width, int height, int tile_size)
+            : width_(width), height_(height) {
+            tile_shift_ = 0;
+            while ((1 << tile_shift_) < tile_size) ++tile_shift_;
+            tile_size_ = 1 << tile_shift_;
+            tile_mask_ = tile_size_ - 1;
+            tiles_x_ = (width + tile_size_ - 1) / tile_size_;
+            tiles_y_ = (height + tile_size_ - 1) / tile_size_;
+
+            // 行优先分块编号 -> Morton顺序下的存储槽位
+            const std::vector<int> order = make_tile_order(tiles_x_, tiles_y_, TileOrder::Morton);
+            tile_slot_.resize(order.size());
+            for (size_t slot = 0; slot < order.size(); ++slot) {
+                tile_slot_[order[slot]] = static_cast<int>(slot);
+            }
+
+            // 不清零: 由渲染线程首次写入
+            data_.resize(order.size() * static_cast<size_t>(tile_size_) * tile_size_);
+        }
+
+        int width() const { return width_; }
+        int height() const { return height_; }
+        int tile_size() const { return tile_size_; }
+        int tiles_x() const { return tiles_x_; }
+        int tiles_y() const { return tiles_y_; }
+
+        /**
+         * 分块的连续存储 (块内行优先, 行跨度为 tile_size)
+         * @param tile_index 行优先分块编号 (ty * tiles_x + tx)
+         */
+        int* tile_data(int tile_index) {
+            return data_.data() + static_cast<size_t>(tile_slot_[tile_index]) * tile_size_ * tile_size_;
+        }
+        const int* tile_data(int tile_index) const {
+            return data_.data() + static_cast<size_t>(tile_slot_[tile_index]) * tile_size_ * tile_size_;
+        }
+
+        int& at(int x, int y) { return data_[offset(x, y)]; }
+        int at(int x, int y) const { return data_[offset(x, y)]; }
+
+        /**
+         * 转换为行优先的迭代次数数组 (size = width * height)
+         */
+        std::vector<int> to_row_major() const {
+            std::vector<int> result(static_cast<size_t>(width_) * height_);
+            for (int y = 0; y < height_; ++y) {
+                for (int x = 0; x < width_; ++x) {
+                    result[static_cast<size_t>(y) * width_ + x] = at(x, y);
+                }
+            }
+            return result;
+        }
+
+    private:
+        size_t offset(int x, int y) const {
+            const int tile_index = (y >> tile_shift_) * tiles_x_ + (x >> tile_shift_);
+            return static_cast<size_t>(tile_slot_[tile_index]) * tile_size_ * tile_size_ +
+                   static_cast<size_t>(y & tile_mask_) * tile_size_ + (x & tile_mask_);
+        }
+
+        int width_ = 0;
+        int height_ = 0;
+        int tile_size_ = 1;
+        int tile_shift_ = 0;
+        int tile_mask_ = 0;
+        int tiles_x_ = 0;
+        int tiles_y_ = 0;
+        std::vector<int> tile_slot_;
+        std::vector<int, MandelbrotCPU::DefaultInitAllocator<int>> data_;
+    };
+
+} // namespace MandelbrotOMP
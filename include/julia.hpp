@@ -10,6 +10,7 @@
 #ifndef JULIA_HPP
 #define JULIA_HPP
 
+#include "render_counters.hpp"
 #include <vector>
 #include <string>
 
@@ -56,9 +57,10 @@ public:
     /**
      * 渲染Julia集分形
      * @param params Julia集参数
+     * @param counters 非空时填充热路径计数 (迭代次数、逃逸/内部像素数)
      * @return 渲染用时（毫秒）
      */
-    static double render(const JuliaParams& params);
+    static double render(const JuliaParams& params, MandelbrotCPU::RenderCounters* counters = nullptr);
     
     /**
      * 计算单个点的Julia集迭代次数
@@ -96,7 +98,10 @@ public:
  */
 class JuliaRendererOMP {
 public:
-    static double render(const JuliaParams& params);
+    /**
+     * @param counters 非空时填充热路径计数 (每线程计数槽, 渲染结束后合并)
+     */
+    static double render(const JuliaParams& params, MandelbrotCPU::RenderCounters* counters = nullptr);
     static void set_thread_count(int threads);
 private:
     static int thread_count;
@@ -0,0 +1,351 @@
+#pragma once
+
+/**
+ * Mandelbulb ray marcher - power-N distance estimator evaluated on ray packets.
+ *
+ * Shared by fractal_api and the OpenMP driver (mandelbulb_test).
+ *
+ * - Distance estimate: triplex power z -> z^n + c in spherical form, d = 0.5 ln r * r / dr.
+ *   The power is an integer, so cos/sin of n*theta and n*phi come from raising
+ *   (cos + i sin) to the n-th power by repeated squaring: no acos/atan2/pow in the loop,
+ *   only + * / sqrt, which the vector extensions evaluate on every lane at once.
+ * - Packets: kBulbLanes horizontally adjacent primary rays (4 with AVX, 2 with SSE2/NEON)
+ *   march together; lanes that hit or leave the bounding sphere are masked off and the packet
+ *   stops when no lane is active. Normals (tetrahedron of 4 estimates), ambient occlusion
+ *   (5 estimates along the normal) and soft shadow rays toward the light are evaluated on
+ *   the same packets.
+ * - Scheduling: the frame is cut into kTileSize x kTileSize tiles; renderTile() is
+ *   independent per tile, so callers run tiles serially (fractal_api, one band of tile rows
+ *   at a time) or on a thread pool (mandelbulb_test).
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Packets are passed by value, so their width follows the vector registers the build can use:
+// 4 doubles with AVX, 2 with SSE2/NEON (a wider type would not change the instructions there,
+// only the calling convention GCC warns about)
+#if defined(__GNUC__) || defined(__clang__)
+#if defined(__AVX__)
+const int kBulbLanes = 4;
+#else
+const int kBulbLanes = 2;
+#endif
+typedef double BulbVec __attribute__((vector_size(8 * kBulbLanes)));
+typedef long long BulbMask __attribute__((vector_size(8 * kBulbLanes)));
+
+inline BulbVec bulbSplat(double v) { return BulbVec{} + v; }
+inline BulbVec bulbSelect(BulbMask m, BulbVec a, BulbVec b) { return m ? a : b; }
+inline bool bulbAny(BulbMask m) {
+    long long any = 0;
+    for (int lane = 0; lane < kBulbLanes; lane++) any |= m[lane];
+    return any != 0;
+}
+inline double bulbLane(BulbVec v, int lane) { return v[lane]; }
+inline bool bulbLane(BulbMask m, int lane) { return m[lane] != 0; }
+inline void bulbSetLane(BulbVec& v, int lane, double x) { v[lane] = x; }
+inline BulbVec bulbSqrt(BulbVec v) {
+    for (int lane = 0; lane < kBulbLanes; lane++) v[lane] = std::sqrt(v[lane]);
+    return v;
+}
+inline BulbVec bulbLog(BulbVec v) {
+    for (int lane = 0; lane < kBulbLanes; lane++) v[lane] = std::log(v[lane]);
+    return v;
+}
+#else
+// One ray per "packet" when vector extensions are unavailable; the marcher code is unchanged
+typedef double BulbVec;
+typedef bool BulbMask;
+const int kBulbLanes = 1;
+
+inline BulbVec bulbSplat(double v) { return v; }
+inline BulbVec bulbSelect(BulbMask m, BulbVec a, BulbVec b) { return m ? a : b; }
+inline bool bulbAny(BulbMask m) { return m; }
+inline double bulbLane(BulbVec v, int) { return v; }
+inline bool bulbLane(BulbMask m, int) { return m; }
+inline void bulbSetLane(BulbVec& v, int, double x) { v = x; }
+inline BulbVec bulbSqrt(BulbVec v) { return std::sqrt(v); }
+inline BulbVec bulbLog(BulbVec v) { return std::log(v); }
+#endif
+
+struct MandelbulbParams {
+    int width = 800;
+    int height = 600;
+    int power = 8;              // integer power n >= 2
+    int iterations = 10;        // distance-estimator iterations per sample
+    int maxSteps = 256;         // ray-march steps per primary ray (per-pixel cost cap)
+    double yaw = 30.0;          // camera orbit around the pole axis, degrees
+    double pitch = 20.0;        // camera elevation, degrees
+    double zoom = 1.0;          // focal length multiplier
+    bool ambientOcclusion = true;
+    bool shadows = true;
+};
+
+const double kMandelbulbBailout = 2.0;
+const double kMandelbulbBoundingRadius = 2.0;   // every power >= 2 fits inside |c| <= 2
+
+// Distance estimate for kBulbLanes points; trap receives the minimum |z|^2 of each orbit (for coloring)
+inline BulbVec mandelbulbDistance4(BulbVec cx, BulbVec cy, BulbVec cz, int power, int iterations, BulbVec* trap) {
+    const BulbVec zero = bulbSplat(0.0), one = bulbSplat(1.0);
+    const BulbVec bailout = bulbSplat(kMandelbulbBailout);
+    BulbVec zx = cx, zy = cy, zz = cz;
+    BulbVec dr = one;
+    BulbVec minR2 = bulbSplat(1e30);
+
+    for (int i = 0; i < iterations; i++) {
+        BulbVec rho2 = zx * zx + zy * zy;
+        BulbVec r2 = rho2 + zz * zz;
+        BulbVec r = bulbSqrt(r2);
+        BulbMask active = r <= bailout;
+        if (!bulbAny(active)) break;
+        minR2 = bulbSelect(active & (r2 < minR2), r2, minR2);
+
+        // theta from the pole axis (z), phi around it
+        BulbVec rho = bulbSqrt(rho2);
+        BulbVec cosTheta = bulbSelect(r > zero, zz / r, one);
+        BulbVec sinTheta = bulbSelect(r > zero, rho / r, zero);
+        BulbVec cosPhi = bulbSelect(rho > zero, zx / rho, one);
+        BulbVec sinPhi = bulbSelect(rho > zero, zy / rho, zero);
+
+        // (cos + i sin)^n for both angles and r^(n-1), by repeated squaring
+        BulbVec ctn = one, stn = zero, cpn = one, spn = zero, rn1 = one;
+        BulbVec ct = cosTheta, st = sinTheta, cp = cosPhi, sp = sinPhi, rb = r;
+        for (int e = power; e > 0; e >>= 1) {
+            if (e & 1) {
+                BulbVec t = ctn * ct - stn * st;
+                stn = ctn * st + stn * ct;
+                ctn = t;
+                t = cpn * cp - spn * sp;
+                spn = cpn * sp + spn * cp;
+                cpn = t;
+                rn1 *= rb;
+            }
+            if (e == 1) break;
+            BulbVec t = ct * ct - st * st;
+            st = 2.0 * ct * st;
+            ct = t;
+            t = cp * cp - sp * sp;
+            sp = 2.0 * cp * sp;
+            cp = t;
+            rb *= rb;
+        }
+        BulbVec rn = rn1;   // r^n
+        rn1 = bulbSelect(r > zero, rn / r, zero);
+
+        BulbVec nx = rn * stn * cpn + cx;
+        BulbVec ny = rn * stn * spn + cy;
+        BulbVec nz = rn * ctn + cz;
+        BulbVec ndr = double(power) * rn1 * dr + one;
+
+        // Escaped lanes keep their last z and derivative
+        zx = bulbSelect(active, nx, zx);
+        zy = bulbSelect(active, ny, zy);
+        zz = bulbSelect(active, nz, zz);
+        dr = bulbSelect(active, ndr, dr);
+    }
+
+    if (trap) *trap = minR2;
+    BulbVec r = bulbSqrt(zx * zx + zy * zy + zz * zz);
+    r = bulbSelect(r > zero, r, bulbSplat(1e-300));
+    return 0.5 * bulbLog(r) * r / dr;
+}
+
+class MandelbulbRenderer {
+public:
+    static const int kTileSize = 16;
+
+    explicit MandelbulbRenderer(const MandelbulbParams& params) : params_(params) {
+        const double toRadians = 3.14159265358979323846 / 180.0;
+        const double yaw = params.yaw * toRadians, pitch = params.pitch * toRadians;
+        const double distance = 3.5;
+        eye_[0] = distance * std::cos(pitch) * std::cos(yaw);
+        eye_[1] = distance * std::cos(pitch) * std::sin(yaw);
+        eye_[2] = distance * std::sin(pitch);
+
+        // forward looks at the origin; the pole axis (z) is up
+        for (int k = 0; k < 3; k++) forward_[k] = -eye_[k] / distance;
+        const double worldUp[3] = {0.0, 0.0, 1.0};
+        cross(forward_, worldUp, right_);
+        if (!normalize(right_)) { right_[0] = 0.0; right_[1] = 1.0; right_[2] = 0.0; }   // looking down the pole
+        cross(right_, forward_, up_);
+
+        // Light from over the viewer's right shoulder, fixed relative to the camera
+        for (int k = 0; k < 3; k++) light_[k] = 0.5 * right_[k] + 0.8 * up_[k] - 0.4 * forward_[k];
+        normalize(light_);
+
+        focal_ = 2.0 * params.zoom;
+        pixelAngle_ = 2.0 / (params.height * focal_);
+    }
+
+    int tilesX() const { return (params_.width + kTileSize - 1) / kTileSize; }
+    int tilesY(int rows) const { return (rows + kTileSize - 1) / kTileSize; }
+
+    /**
+     * Shade one tile of a band of rows [y0, y0 + rows).
+     * rgb is the band (rows * width * 3 bytes, row 0 = frame row y0); steps (optional, rows * width)
+     * receives the primary-ray march steps per pixel. Tiles touch disjoint pixels.
+     */
+    void renderTile(int tile, int y0, int rows, uint8_t* rgb, int* steps) const {
+        const int tx = tile % tilesX(), ty = tile / tilesX();
+        const int xBegin = tx * kTileSize, xEnd = std::min(xBegin + kTileSize, params_.width);
+        const int rBegin = ty * kTileSize, rEnd = std::min(rBegin + kTileSize, rows);
+
+        for (int r = rBegin; r < rEnd; r++) {
+            for (int x = xBegin; x < xEnd; x += kBulbLanes) {
+                double color[kBulbLanes][3];
+                int laneSteps[kBulbLanes];
+                shadePacket(x, y0 + r, color, laneSteps);
+
+                for (int lane = 0; lane < kBulbLanes && x + lane < xEnd; lane++) {
+                    size_t idx = size_t(r) * params_.width + x + lane;
+                    for (int k = 0; k < 3; k++) {
+                        double c = std::min(1.0, std::max(0.0, color[lane][k]));
+                        rgb[idx * 3 + k] = uint8_t(255.0 * std::pow(c, 1.0 / 2.2) + 0.5);
+                    }
+                    if (steps) steps[idx] = laneSteps[lane];
+                }
+            }
+        }
+    }
+
+private:
+    static void cross(const double* a, const double* b, double* out) {
+        out[0] = a[1] * b[2] - a[2] * b[1];
+        out[1] = a[2] * b[0] - a[0] * b[2];
+        out[2] = a[0] * b[1] - a[1] * b[0];
+    }
+
+    static bool normalize(double* v) {
+        double len = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        if (len < 1e-12) return false;
+        for (int k = 0; k < 3; k++) v[k] /= len;
+        return true;
+    }
+
+    BulbVec distance(BulbVec x, BulbVec y, BulbVec z, BulbVec* trap = nullptr) const {
+        return mandelbulbDistance4(x, y, z, params_.power, params_.iterations, trap);
+    }
+
+    // Primary rays for pixels x..x+lanes-1 of frame row y (lanes past the edge repeat the last pixel)
+    void shadePacket(int x, int y, double color[][3], int* laneSteps) const {
+        BulbVec dx, dy, dz, background;
+        const double v = (params_.height - 2.0 * (y + 0.5)) / params_.height;
+        for (int lane = 0; lane < kBulbLanes; lane++) {
+            const int px = std::min(x + lane, params_.width - 1);
+            const double u = (2.0 * (px + 0.5) - params_.width) / params_.height;
+            double d[3];
+            for (int k = 0; k < 3; k++) d[k] = focal_ * forward_[k] + u * right_[k] + v * up_[k];
+            normalize(d);
+            bulbSetLane(dx, lane, d[0]);
+            bulbSetLane(dy, lane, d[1]);
+            bulbSetLane(dz, lane, d[2]);
+            bulbSetLane(background, lane, 0.5 + 0.5 * d[2]);
+        }
+
+        const BulbVec zero = bulbSplat(0.0), one = bulbSplat(1.0);
+        const BulbVec ox = bulbSplat(eye_[0]), oy = bulbSplat(eye_[1]), oz = bulbSplat(eye_[2]);
+
+        // Clip to the bounding sphere
+        BulbVec b = -(ox * dx + oy * dy + oz * dz);
+        BulbVec disc = b * b - bulbSplat(eye_[0] * eye_[0] + eye_[1] * eye_[1] + eye_[2] * eye_[2] -
+                                         kMandelbulbBoundingRadius * kMandelbulbBoundingRadius);
+        BulbMask active = disc > zero;
+        BulbVec root = bulbSqrt(bulbSelect(active, disc, zero));
+        BulbVec t = bulbSelect(b - root > zero, b - root, zero);
+        BulbVec tFar = b + root;
+
+        // March: hit when the estimate drops below the pixel footprint at distance t
+        const BulbVec hitScale = bulbSplat(0.5 * pixelAngle_);
+        BulbMask hit = active & (zero > one);
+        BulbVec stepCount = zero;
+        for (int step = 0; step < params_.maxSteps && bulbAny(active); step++) {
+            stepCount = bulbSelect(active, stepCount + one, stepCount);
+            BulbVec d = distance(ox + t * dx, oy + t * dy, oz + t * dz);
+            BulbMask hitNow = active & (d < hitScale * t);
+            hit = hit | hitNow;
+            active = active & (hitNow == 0);
+            t = bulbSelect(active, t + d, t);
+            active = active & (t < tFar);
+        }
+
+        for (int lane = 0; lane < kBulbLanes; lane++) {
+            laneSteps[lane] = int(bulbLane(stepCount, lane));
+            double g = bulbLane(background, lane);
+            color[lane][0] = 0.01 + 0.05 * g;
+            color[lane][1] = 0.01 + 0.06 * g;
+            color[lane][2] = 0.03 + 0.12 * g;
+        }
+        if (!bulbAny(hit)) return;
+
+        BulbVec px = ox + t * dx, py = oy + t * dy, pz = oz + t * dz;
+        BulbVec h = bulbSelect(pixelAngle_ * t > bulbSplat(1e-6), pixelAngle_ * t, bulbSplat(1e-6));
+
+        // Normal from a tetrahedron of 4 estimates
+        BulbVec d0 = distance(px + h, py - h, pz - h);
+        BulbVec d1 = distance(px - h, py - h, pz + h);
+        BulbVec d2 = distance(px - h, py + h, pz - h);
+        BulbVec d3 = distance(px + h, py + h, pz + h);
+        BulbVec nx = d0 - d1 - d2 + d3, ny = -d0 - d1 + d2 + d3, nz = -d0 + d1 - d2 + d3;
+        BulbVec len = bulbSqrt(nx * nx + ny * ny + nz * nz);
+        len = bulbSelect(len > zero, len, one);
+        nx /= len; ny /= len; nz /= len;
+
+        BulbVec trap;
+        distance(px, py, pz, &trap);
+
+        // Ambient occlusion: compare the estimate with the distance travelled along the normal
+        BulbVec ao = one;
+        if (params_.ambientOcclusion) {
+            BulbVec occlusion = zero;
+            double weight = 1.0;
+            for (int i = 1; i <= 5; i++) {
+                const double s = 0.02 * i;
+                BulbVec d = distance(px + s * nx, py + s * ny, pz + s * nz);
+                occlusion += weight * (bulbSplat(s) - d);
+                weight *= 0.5;
+            }
+            ao = one - 6.0 * occlusion;
+            ao = bulbSelect(ao < zero, zero, bulbSelect(ao > one, one, ao));
+        }
+
+        // Soft shadow ray toward the light: the closest approach relative to distance travelled
+        const BulbVec lx = bulbSplat(light_[0]), ly = bulbSplat(light_[1]), lz = bulbSplat(light_[2]);
+        BulbVec diffuse = nx * lx + ny * ly + nz * lz;
+        diffuse = bulbSelect(diffuse > zero, diffuse, zero);
+        BulbVec shadow = one;
+        if (params_.shadows) {
+            BulbVec sx = px + 4.0 * h * nx, sy = py + 4.0 * h * ny, sz = pz + 4.0 * h * nz;
+            BulbMask marching = hit & (diffuse > zero);
+            BulbVec st = bulbSplat(0.01);
+            const BulbVec sharpness = bulbSplat(12.0), minStep = bulbSplat(0.002), maxDist = bulbSplat(2.5);
+            for (int step = 0; step < 64 && bulbAny(marching); step++) {
+                BulbVec d = distance(sx + st * lx, sy + st * ly, sz + st * lz);
+                BulbVec soft = sharpness * d / st;
+                shadow = bulbSelect(marching & (soft < shadow), soft, shadow);
+                marching = marching & (d > bulbSplat(1e-5)) & (shadow > bulbSplat(0.01));
+                st = bulbSelect(marching, st + bulbSelect(d > minStep, d, minStep), st);
+                marching = marching & (st < maxDist);
+            }
+            shadow = bulbSelect(shadow < zero, zero, shadow);
+        }
+
+        for (int lane = 0; lane < kBulbLanes; lane++) {
+            if (!bulbLane(hit, lane)) continue;
+            // Orbit trap (closest approach of the orbit, mostly 0.5..1 on the surface) picks
+            // between a cool albedo in the crevices and a warm one on the outer shell
+            const double m = std::min(1.0, std::max(0.0, 2.0 * (std::sqrt(bulbLane(trap, lane)) - 0.5)));
+            const double albedo[3] = {0.25 + 0.65 * m, 0.30 + 0.32 * m, 0.55 - 0.30 * m};
+            const double a = bulbLane(ao, lane);
+            const double light = 1.1 * bulbLane(diffuse, lane) * bulbLane(shadow, lane);
+            const double sky = 0.25 * a * (0.6 + 0.4 * bulbLane(nz, lane));
+            for (int k = 0; k < 3; k++) color[lane][k] = albedo[k] * (light + sky) + 0.03 * a;
+        }
+    }
+
+    MandelbulbParams params_;
+    double eye_[3], forward_[3], right_[3], up_[3], light_[3];
+    double focal_;
+    double pixelAngle_;     // view angle of one pixel (hit threshold and normal offset scale)
+};
+
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+
+/**
+ * 每次渲染的内存统计 - 峰值RSS增量 + 分配次数/字节数
+ *
+ * - 峰值RSS: 开始时向 /proc/self/clear_refs 写入5, 把 VmHWM 重置为当前RSS
+ *   (容器中不可写时退化为进程生命周期峰值), 结束时 VmHWM - 开始时VmRSS 即本次渲染的峰值增量
+ * - 分配计数: 可选的全局 operator new 钩子, 每次分配两次relaxed原子加法。
+ *   在程序的某一个翻译单元中先 #define MANDELBROT_COUNT_ALLOCATIONS 再包含本头文件即可启用;
+ *   未启用时只报告RSS。BufferPool 直接向系统申请, 不经过 operator new, 其统计需另行加入
+ */
+
+namespace MandelbrotCPU {
+
+    /**
+     * 全局分配计数 (由 operator new 钩子累加)
+     */
+    struct AllocationCounters {
+        static inline std::atomic<long long> count{0};
+        static inline std::atomic<long long> bytes{0};
+        static inline std::atomic<bool> installed{false};
+
+        static void record(size_t size) {
+            count.fetch_add(1, std::memory_order_relaxed);
+            bytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * 单次渲染的内存统计 (-1 表示不可用)
+     */
+    struct MemoryUsage {
+        long long peak_rss_bytes = -1;          // 结束时的峰值RSS
+        long long peak_rss_delta_bytes = -1;    // 峰值RSS - 开始时RSS
+        long long allocations = -1;             // 分配次数 (钩子未启用时为-1)
+        long long allocated_bytes = -1;         // 分配字节数
+
+        /**
+         * 计入绕过 operator new 的分配 (如 BufferPool 向系统申请的块)
+         */
+        void add_allocations(long long count, long long bytes) {
+            allocations = (allocations < 0 ? 0 : allocations) + count;
+            allocated_bytes = (allocated_bytes < 0 ? 0 : allocated_bytes) + bytes;
+        }
+
+        /**
+         * JSON字段片段 (以", "开头, 追加到 RenderCounters::to_json)
+         */
+        std::string json_fields() const {
+            std::ostringstream json;
+            json << ", \"peak_rss_bytes\": " << peak_rss_bytes
+                 << ", \"peak_rss_delta_bytes\": " << peak_rss_delta_bytes
+                 << ", \"allocations\": " << allocations
+                 << ", \"allocated_bytes\": " << allocated_bytes;
+            return json.str();
+        }
+    };
+
+    class MemoryTracker {
+    public:
+        MemoryTracker() {
+            std::ofstream clear_refs("/proc/self/clear_refs");
+            if (clear_refs) clear_refs << "5";
+            start_rss_ = read_status_kb("VmRSS:");
+            start_count_ = AllocationCounters::count.load(std::memory_order_relaxed);
+            start_bytes_ = AllocationCounters::bytes.load(std::memory_order_relaxed);
+        }
+
+        MemoryUsage finish() const {
+            MemoryUsage usage;
+            const long long peak = read_status_kb("VmHWM:");
+            if (peak >= 0) {
+                usage.peak_rss_bytes = peak * 1024;
+                if (start_rss_ >= 0) usage.peak_rss_delta_bytes = (peak - start_rss_) * 1024;
+            }
+            if (AllocationCounters::installed.load(std::memory_order_relaxed)) {
+                usage.allocations = AllocationCounters::count.load(std::memory_order_relaxed) - start_count_;
+                usage.allocated_bytes = AllocationCounters::bytes.load(std::memory_order_relaxed) - start_bytes_;
+            }
+            return usage;
+        }
+
+    private:
+        // /proc/self/status 中以key开头的行 (单位kB), 不可读时返回-1
+        static long long read_status_kb(const char* key) {
+            std::ifstream status("/proc/self/status");
+            std::string line;
+            const std::string prefix(key);
+            while (std::getline(status, line)) {
+                if (line.compare(0, prefix.size(), prefix) == 0) {
+                    return std::atoll(line.c_str() + prefix.size());
+                }
+            }
+            return -1;
+        }
+
+        long long start_rss_ = -1;
+        long long start_count_ = 0;
+        long long start_bytes_ = 0;
+    };
+
+} // namespace MandelbrotCPU
+
+#ifdef MANDELBROT_COUNT_ALLOCATIONS
+
+// 全局分配钩子: 统计后转交 malloc / aligned_alloc, 释放统一走 free。
+// 两个函数禁止内联: 否则 GCC 在内联后会把内建 operator new 与 free 配对, 报 -Wmismatched-new-delete
+namespace MandelbrotCPU {
+    namespace {
+        const bool allocation_hook_installed = (AllocationCounters::installed = true);
+
+        [[gnu::noinline]] void* counted_alloc(size_t size, size_t alignment) {
+            AllocationCounters::record(size);
+            if (size == 0) size = 1;
+            if (alignment <= alignof(std::max_align_t)) return std::malloc(size);
+            return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        }
+
+        [[gnu::noinline]] void counted_free(void* ptr) {
+            std::free(ptr);
+        }
+    }
+}
+
+void* operator new(size_t size) {
+    if (void* ptr = MandelbrotCPU::counted_alloc(size, 0)) return ptr;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+    if (void* ptr = MandelbrotCPU::counted_alloc(size, 0)) return ptr;
+    throw std::bad_alloc();
+}
+void* operator new(size_t size, std::align_val_t alignment) {
+    if (void* ptr = MandelbrotCPU::counted_alloc(size, static_cast<size_t>(alignment))) return ptr;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    if (void* ptr = MandelbrotCPU::counted_alloc(size, static_cast<size_t>(alignment))) return ptr;
+    throw std::bad_alloc();
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return MandelbrotCPU::counted_alloc(size, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return MandelbrotCPU::counted_alloc(size, 0); }
+
+void operator delete(void* ptr) noexcept { MandelbrotCPU::counted_free(ptr); }
+void operator delete[](void* ptr) noexcept { MandelbrotCPU::counted_free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { MandelbrotCPU::counted_free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { MandelbrotCPU::counted_free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { MandelbrotCPU::counted_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { MandelbrotCPU::counted_free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { MandelbrotCPU::counted_free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { MandelbrotCPU::counted_free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { MandelbrotCPU::counted_free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { MandelbrotCPU::counted_free(ptr); }
+
+#endif // MANDELBROT_COUNT_ALLOCATIONS
@@ -3,6 +3,7 @@
 #include <vector>
 #include <string>
 #include <chrono>
+#include "render_counters.hpp"
 
 /**
  * Newton Fractal Renderer
@@ -29,9 +30,9 @@ public:
     // Constructor with default parameters
     NewtonFractalCPU(int width = 800, int height = 600, int max_iterations = 100);
     
-    // Core rendering methods
-    void render(double center_x = 0.0, double center_y = 0.0, double zoom = 1.0);
-    void renderToFile(const std::string& filename, double center_x = 0.0, 
+    // Core rendering methods (return the render time in milliseconds)
+    double render(double center_x = 0.0, double center_y = 0.0, double zoom = 1.0);
+    double renderToFile(const std::string& filename, double center_x = 0.0, 
                      double center_y = 0.0, double zoom = 1.0);
     
     // Newton method computation
@@ -49,6 +50,9 @@ public:
     int getHeight() const { return height_; }
     int getMaxIterations() const { return max_iterations_; }
     
+    // Hot-path counters of the last render() ("escaped" counts pixels that converged to a root)
+    const MandelbrotCPU::RenderCounters& getCounters() const { return counters_; }
+    
     // Preset configurations for interesting Newton fractal regions
     static std::vector<std::tuple<std::string, double, double, double>> getPresets();
     
@@ -57,6 +61,7 @@ private:
     int height_;
     int max_iterations_;
     std::vector<std::vector<std::pair<int, int>>> fractal_data_; // {root, iterations}
+    MandelbrotCPU::RenderCounters counters_;
     
     // The three cube roots of unity
     static constexpr double ROOT1_REAL = 1.0;
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <string>
+
+/**
+ * NUMA拓扑检测与线程绑定
+ *
+ * 通过 /sys/devices/system/node 读取节点与CPU对应关系 (不依赖libnuma),
+ * 并与进程当前的CPU亲和性掩码求交集, 因此在taskset/cgroup限制下同样正确。
+ * 非Linux系统或无sysfs信息时退化为单节点。
+ */
+
+namespace MandelbrotOMP {
+
+    // 单个NUMA节点
+    struct NumaNode {
+        int id;                     // 系统节点编号
+        std::vector<int> cpus;      // 本进程可用的CPU编号
+    };
+
+    // NUMA拓扑 (仅包含有可用CPU的节点)
+    struct NumaTopology {
+        std::vector<NumaNode> nodes;
+
+        int total_cpus() const;
+        bool is_numa() const { return nodes.size() > 1; }
+    };
+
+    /**
+     * 检测NUMA拓扑 (结果在首次调用后缓存)
+     * @return 节点列表, 至少包含一个节点
+     */
+    const NumaTopology& get_numa_topology();
+
+    /**
+     * 按节点CPU数量比例将线程划分到节点 (连续线程编号属于同一节点)
+     * @param topology NUMA拓扑
+     * @param num_threads 线程总数
+     * @return 每个线程所属的节点下标 (nodes数组下标)
+     */
+    std::vector<int> assign_threads_to_nodes(const NumaTopology& topology, int num_threads);
+
+    /**
+     * 将当前线程绑定到指定CPU集合
+     * @param cpus CPU编号列表
+     * @return 是否成功
+     */
+    bool pin_current_thread(const std::vector<int>& cpus);
+
+    /**
+     * 获取NUMA拓扑描述字符串
+     */
+    std::string get_numa_info();
+
+} // namespace MandelbrotOMP
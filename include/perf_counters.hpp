@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ * 硬件性能计数器 - 基于Linux perf_event_open
+ *
+ * 只统计本线程的用户态事件 (exclude_kernel), perf_event_paranoid <= 2 时无需特权。
+ * 每个事件单独打开: 某个事件不被支持 (虚拟机常见) 时只缺这一项, 其余照常计数;
+ * 计数器复用时按 enabled/running 时间比例缩放。
+ * 非Linux平台或全部事件都无法打开时 available() 为false, 调用方退回只报告计时。
+ */
+
+namespace MandelbrotCPU {
+
+    /**
+     * 一次测量的计数值 (valid[i] 为false表示该事件不可用)
+     */
+    struct PerfSample {
+        enum Event { Cycles = 0, Instructions, BranchMisses, CacheMisses, NumEvents };
+
+        uint64_t values[NumEvents] = {0, 0, 0, 0};
+        bool valid[NumEvents] = {false, false, false, false};
+
+        bool has(Event event) const { return valid[event]; }
+        double get(Event event) const { return static_cast<double>(values[event]); }
+
+        /**
+         * 每周期指令数 (周期或指令不可用时为0)
+         */
+        double ipc() const {
+            return valid[Cycles] && valid[Instructions] && values[Cycles] > 0
+                ? static_cast<double>(values[Instructions]) / values[Cycles] : 0.0;
+        }
+
+        void add(const PerfSample& other);
+    };
+
+    class PerfCounters {
+    public:
+        PerfCounters();
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        /**
+         * 至少一个事件可用
+         */
+        bool available() const { return num_open_ > 0; }
+
+        /**
+         * 不可用 (或部分不可用) 的原因, 全部可用时为空
+         */
+        const std::string& unavailable_reason() const { return reason_; }
+
+        /**
+         * 清零并开始计数
+         */
+        void start();
+
+        /**
+         * 停止计数并读取
+         */
+        PerfSample stop();
+
+    private:
+        int fds_[PerfSample::NumEvents];
+        int num_open_ = 0;
+        std::string reason_;
+    };
+
+} // namespace MandelbrotCPU
@@ -2,6 +2,8 @@
 
 #include <vector>
 #include <string>
+#include "image_buffer.hpp"
+#include "render_counters.hpp"
 
 /**
  * Mandelbrot 分形渲染器 - 头文件定义
@@ -13,8 +15,6 @@
  * 日期: 2025-08-12
  */
 
-#ifndef RENDER_HPP
-
 namespace MandelbrotCPU {
 
     // 渲染参数结构体
@@ -45,9 +45,10 @@ namespace MandelbrotCPU {
     /**
      * CPU单线程版本 - Mandelbrot集合渲染
      * @param params 渲染参数
+     * @param counters 非空时输出热路径计数 (迭代次数、逃逸/内部像素数)
      * @return RGB像素数据向量 (size = width * height * 3)
      */
-    std::vector<unsigned char> render_mandelbrot_cpu(const RenderParams& params);
+    ImageBuffer render_mandelbrot_cpu(const RenderParams& params, RenderCounters* counters = nullptr);
 
     /**
      * 将像素数据保存为PPM格式文件
@@ -59,6 +60,9 @@ namespace MandelbrotCPU {
     void save_ppm(const std::string& filename, 
                   const std::vector<unsigned char>& image_data,
                   int width, int height);
+    void save_ppm(const std::string& filename,
+                  const ImageBuffer& image_data,
+                  int width, int height);
 
     /**
      * 计算单个像素的迭代次数
@@ -76,4 +80,11 @@ namespace MandelbrotCPU {
      */
     RGB iterations_to_color(int iterations, int max_iter);
 
+    /**
+     * 彩虹色谱 (iterations_to_color 与直方图均衡着色共用)
+     * @param t 色谱位置 [0, 1]
+     * @return RGB颜色
+     */
+    RGB palette_color(double t);
+
 } // namespace MandelbrotCPU
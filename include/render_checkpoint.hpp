@@ -0,0 +1,93 @@
+#pragma once
+
+#include "render.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <mutex>
+
+/**
+ * Mandelbrot 分形渲染器 - 分块检查点日志
+ *
+ * 长时间渲染 (如 50k x 50k 深度缩放) 的断点续渲支持:
+ * - 已完成的分块先缓存在内存中, 按固定间隔批量追加到日志文件并fsync
+ * - 落盘时只在锁内交换缓存, 写文件与fsync在锁外由单个线程完成, 其他线程继续记录分块
+ * - 重启后读取日志, 恢复已完成分块的像素并跳过对应计算
+ *
+ * 日志文件格式 (本机字节序):
+ *   文件头: magic "MBCK" | version | 渲染参数 | 分块尺寸 | 分块总数
+ *   记录:   tile_index (u32) | payload_size (u32) | RGB数据 | FNV-1a校验 (u32)
+ *
+ * 进程被中断时最后一条记录可能不完整, 续渲时校验失败的尾部记录会被截断丢弃。
+ * 检查点粒度为分块: 中断时仅丢失各线程正在计算的分块。
+ */
+
+namespace MandelbrotOMP {
+
+    struct Tile;
+
+    class CheckpointJournal {
+    public:
+        /**
+         * @param filename 日志文件路径
+         * @param params 渲染参数 (写入文件头, 续渲时校验)
+         * @param tile_size 分块边长
+         * @param num_tiles 分块总数
+         * @param interval_ms 落盘间隔 (毫秒)
+         */
+        CheckpointJournal(const std::string& filename, const MandelbrotCPU::RenderParams& params,
+                          int tile_size, int num_tiles, int interval_ms = 5000);
+        ~CheckpointJournal();
+
+        CheckpointJournal(const CheckpointJournal&) = delete;
+        CheckpointJournal& operator=(const CheckpointJournal&) = delete;
+
+        /**
+         * 从已有日志恢复已完成分块 (文件不存在时视为全新渲染)
+         * 参数不匹配时抛出std::runtime_error
+         * @param tiles 分块列表
+         * @param image_data 整图RGB缓冲区, 恢复的像素写入其中
+         * @param completed 输出: 每个分块是否已完成
+         * @return 恢复的分块数
+         */
+        int restore(const std::vector<Tile>& tiles, MandelbrotCPU::ImageBuffer& image_data,
+                    std::vector<char>& completed);
+
+        /**
+         * 创建新日志 (覆盖旧文件) 或以追加方式打开已恢复的日志
+         * 必须在restore之后、record_tile之前调用
+         */
+        void open(bool append);
+
+        /**
+         * 记录一个已完成的分块 (线程安全, 到达落盘间隔时自动flush)
+         */
+        void record_tile(int tile_index, const Tile& tile, const MandelbrotCPU::ImageBuffer& image_data);
+
+        /**
+         * 将缓存的分块写入日志并fsync (线程安全)
+         */
+        void flush();
+
+        const std::string& filename() const { return filename_; }
+
+    private:
+        void write_header();
+
+        std::string filename_;
+        MandelbrotCPU::RenderParams params_;
+        int tile_size_;
+        int num_tiles_;
+        std::chrono::milliseconds interval_;
+
+        std::FILE* file_ = nullptr;
+        std::mutex mutex_;                     // 保护pending_, last_flush_, flushing_
+        std::vector<unsigned char> pending_;   // 待写入的完整记录
+        std::chrono::steady_clock::time_point last_flush_;
+        bool flushing_ = false;                // 已有线程负责本轮落盘
+        std::mutex io_mutex_;                  // 串行化文件写入, 保护writing_
+        std::vector<unsigned char> writing_;   // 正在写入的批次 (与pending_交换)
+        long long restored_bytes_ = 0;         // 续渲时有效数据的长度
+    };
+
+} // namespace MandelbrotOMP
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <sstream>
+#include <string>
+
+/**
+ * 渲染热路径计数器 - 每线程独立计数, 渲染结束后合并
+ *
+ * 按像素累加 (每像素几次整数加法), 不进入逐次迭代的内层循环:
+ * - iterations: 实际执行的迭代次数 (被跳过判定命中的像素不计)
+ * - escaped / max_iter_hits: 逃逸 (Newton为收敛) 与跑满max_iter的像素数
+ * - cardioid_skips / bulb_skips: 被主心形 / 周期2球判定直接判为内部的像素数
+ *
+ * 结构体按缓存行对齐, 可直接作为每线程计数槽放入数组而不产生伪共享。
+ */
+
+namespace MandelbrotCPU {
+
+    struct alignas(64) RenderCounters {
+        long long pixels = 0;           // 已计算的像素数
+        long long iterations = 0;       // 实际执行的迭代次数
+        long long escaped = 0;          // 逃逸 (收敛) 的像素数
+        long long max_iter_hits = 0;    // 跑满max_iter的像素数 (含跳过判定命中的像素)
+        long long cardioid_skips = 0;   // 主心形判定跳过的像素数
+        long long bulb_skips = 0;       // 周期2球判定跳过的像素数
+
+        /**
+         * 记录一个逐次迭代得到结果的像素
+         * @param executed 实际执行的迭代次数
+         * @param did_escape 是否逃逸 (收敛)
+         */
+        void add_pixel(long long executed, bool did_escape) {
+            ++pixels;
+            iterations += executed;
+            if (did_escape) ++escaped;
+            else ++max_iter_hits;
+        }
+
+        /**
+         * 记录一个逃逸时间像素 (返回值即执行的迭代次数, 等于max_iter视为未逃逸)
+         */
+        void add_escape_time(int iter, int max_iter) {
+            add_pixel(iter, iter < max_iter);
+        }
+
+        void add_cardioid_skip() {
+            ++pixels;
+            ++max_iter_hits;
+            ++cardioid_skips;
+        }
+
+        void add_bulb_skip() {
+            ++pixels;
+            ++max_iter_hits;
+            ++bulb_skips;
+        }
+
+        void merge(const RenderCounters& other) {
+            pixels += other.pixels;
+            iterations += other.iterations;
+            escaped += other.escaped;
+            max_iter_hits += other.max_iter_hits;
+            cardioid_skips += other.cardioid_skips;
+            bulb_skips += other.bulb_skips;
+        }
+
+        /**
+         * 单行JSON (CLI与fractal_api在--stats时输出到stderr)
+         * @param engine 引擎名
+         * @param seconds 渲染耗时 (秒)
+         * @param extra_fields 追加的字段 (以", "开头, 如 MemoryUsage::json_fields)
+         */
+        std::string to_json(const std::string& engine, double seconds, const std::string& extra_fields = "") const {
+            std::ostringstream json;
+            json << "{\"engine\": \"" << engine << "\""
+                 << ", \"seconds\": " << seconds
+                 << ", \"pixels\": " << pixels
+                 << ", \"iterations\": " << iterations
+                 << ", \"escaped\": " << escaped
+                 << ", \"max_iter\": " << max_iter_hits
+                 << ", \"cardioid_skips\": " << cardioid_skips
+                 << ", \"bulb_skips\": " << bulb_skips
+                 << ", \"iterations_per_second\": " << (seconds > 0.0 ? iterations / seconds : 0.0)
+                 << extra_fields << "}";
+            return json.str();
+        }
+    };
+
+} // namespace MandelbrotCPU
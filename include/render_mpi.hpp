@@ -0,0 +1,69 @@
+#pragma once
+
+#include "render_omp.hpp"
+#include "cost_map.hpp"
+#include <mpi.h>
+
+/**
+ * Mandelbrot 分形渲染器 - MPI集群版本
+ *
+ * 本文件定义了基于MPI的多节点分布式渲染接口
+ * 架构:
+ * - rank 0 作为调度节点, 按需向工作节点分发行带分块 (动态master/worker调度)
+ * - 工作节点使用OpenMP并行渲染分块 (复用render_omp.cpp)
+ * - 所有节点通过MPI-IO集合写入 (MPI_File_write_all) 生成同一个PPM文件
+ *
+ * 单节点测试:
+ *   mpirun -np 4 ./mandelbrot_mpi --width 4096 --height 4096 --output output/mandelbrot_mpi.ppm
+ *
+ * 说明:
+ * - 仅1个进程时, rank 0 独立完成全部分块
+ * - 启用代价划分时, 大部分行带按探测代价静态分配, 只有余量经master动态分发
+ * - 行带分块在文件中连续存储, 集合写入时每个节点只需一个文件视图
+ */
+
+namespace MandelbrotMPI {
+
+    using RenderParams = MandelbrotCPU::RenderParams;
+    using Tile = MandelbrotOMP::Tile;
+
+    // MPI渲染配置
+    struct MPIRenderConfig {
+        int band_height = 64;       // 每个分块的行数
+        int num_threads = 0;        // 每个节点的OpenMP线程数 (0=自动检测)
+        bool verbose = true;        // rank 0 是否输出调度进度
+        bool cost_partition = false;    // 按探测代价图为每个worker静态分配连续行带
+        int probe_scale = 4;            // 探测图每轴缩小倍数
+        double steal_fraction = 0.1;    // 留给动态调度的代价比例
+    };
+
+    // MPI渲染统计 (仅rank 0 上有效)
+    struct MPIRenderStats {
+        int num_ranks = 0;          // 参与的进程总数
+        int num_tiles = 0;          // 分块总数
+        double render_seconds = 0;  // 分块计算耗时 (含调度)
+        double write_seconds = 0;   // 集合写入耗时
+        std::vector<int> tiles_per_rank;  // 每个进程完成的分块数
+        MandelbrotCPU::RenderCounters counters;  // 全部进程合并后的热路径计数
+    };
+
+    /**
+     * MPI分布式渲染并写入PPM文件 (所有rank必须同时调用)
+     * @param params 渲染参数
+     * @param output_filename 输出PPM文件名
+     * @param config MPI渲染配置
+     * @param comm MPI通信域
+     * @return 渲染统计 (非rank 0 返回空统计)
+     */
+    MPIRenderStats render_mandelbrot_mpi(const RenderParams& params,
+                                         const std::string& output_filename,
+                                         const MPIRenderConfig& config = MPIRenderConfig(),
+                                         MPI_Comm comm = MPI_COMM_WORLD);
+
+    /**
+     * 获取MPI运行环境信息
+     * @return 版本和进程信息字符串
+     */
+    std::string get_mpi_info(MPI_Comm comm = MPI_COMM_WORLD);
+
+} // namespace MandelbrotMPI
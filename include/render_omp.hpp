@@ -1,6 +1,11 @@
 #pragma once
 
 #include "render.hpp"
+#include "iteration_field.hpp"
+#include "tile_order.hpp"
+#include "render_progress.hpp"
+#include "render_trace.hpp"
+#include "image_resample.hpp"
 #include <omp.h>
 
 /**
@@ -15,7 +20,7 @@
  * 特性:
  * - 自动线程数检测和配置
  * - 动态负载均衡优化
- * - 内存访问局部性优化
+ * - 内存访问局部性优化 (NUMA感知的线程绑定与first-touch)
  * - 与CPU版本完全兼容的接口
  */
 
@@ -31,20 +36,204 @@ namespace MandelbrotOMP {
      * @param num_threads 线程数 (0=自动检测)
      * @return RGB像素数据向量 (size = width * height * 3)
      */
-    std::vector<unsigned char> render_mandelbrot_omp(const RenderParams& params, int num_threads = 0);
+    MandelbrotCPU::ImageBuffer render_mandelbrot_omp(const RenderParams& params, int num_threads = 0);
 
     /**
-     * 获取系统最优线程数
+     * 分块渲染统计 (RenderOptions::stats 非空时由渲染函数填充)
+     */
+    struct RenderStats {
+        double wall_seconds = 0.0;                  // 分块渲染阶段耗时 (不含代价探测和预缺页)
+        std::vector<double> thread_busy_seconds;    // 每线程渲染分块的累计时间
+        std::vector<long long> thread_tiles;        // 每线程完成的分块数
+        long long steals = 0;                       // 跨队列窃取的分块数
+        MandelbrotCPU::RenderCounters counters;     // 热路径计数 (各线程计数槽合并)
+    };
+
+    /**
+     * OpenMP分块渲染选项
+     */
+    struct RenderOptions {
+        int num_threads = 0;                // 线程数 (0=自动检测)
+        int tile_size = 64;                 // 分块边长 (像素)
+        std::string checkpoint_file;        // 检查点日志路径 (空=不启用)
+        bool resume = false;                // 从检查点日志恢复已完成分块
+        int checkpoint_interval_ms = 5000;  // 检查点落盘间隔 (毫秒)
+        bool pin_threads = true;            // 多NUMA节点时将线程绑定到所属节点 (设置OMP_PROC_BIND时不生效)
+        TileOrder tile_order = TileOrder::RowMajor;  // 分块遍历顺序
+        bool cost_partition = false;        // 按低分辨率探测的代价图静态划分分块
+        int probe_scale = 4;                // 探测图每轴缩小倍数 (4 = 1/16像素数)
+        double steal_fraction = 0.1;        // 代价划分时留作可窃取余量的代价比例
+        ProgressCallback progress_callback; // 进度回调 (由报告线程调用; 空=输出到控制台)
+        int progress_interval_ms = 1000;    // 进度回调间隔 (毫秒)
+        bool prefault = false;              // 渲染前由线程池并行预缺页 (多NUMA节点时总是按节点首次写入)
+        RenderStats* stats = nullptr;       // 非空时逐分块计时, 填充每线程忙碌时间与热路径计数
+        MandelbrotCPU::TraceRecorder* trace = nullptr;  // 非空时记录各阶段与每线程分块的时间线区间
+        std::vector<int>* pixel_costs = nullptr;        // 非空时填充每像素迭代次数 (行优先, 用于代价热力图)
+    };
+
+    /**
+     * OpenMP并行版本 - 分块渲染 (支持检查点与断点续渲)
+     * 多NUMA节点时: 每个节点拥有一段连续的分块行, 由本节点线程并行首次写入(first-touch)
+     * 并优先渲染, 本节点分块耗尽后再窃取其他节点的分块
+     * 启用代价划分时: 节点行区间与每线程的连续分块段均按探测代价均衡,
+     * 线程先渲染自己的段, 再领取本节点的余量, 最后才窃取
+     * 启用检查点时, 日志在渲染完成后保留, 调用方保存图像后应调用
+     * remove_checkpoint() 删除
+     * @param params 渲染参数
+     * @param options 分块/线程/检查点选项
+     * @return RGB像素数据向量 (size = width * height * 3)
+     */
+    MandelbrotCPU::ImageBuffer render_mandelbrot_omp(const RenderParams& params, const RenderOptions& options);
+
+    /**
+     * OpenMP并行计算迭代场 (不着色, 不输出日志)
+     * 迭代场按Morton顺序分块存储, 分块边长取不小于options.tile_size的2的幂次
+     * @param params 渲染参数
+     * @param options 线程/分块/遍历顺序选项 (检查点选项不生效; 仅设置progress_callback时报告进度)
+     * @return 迭代场
+     */
+    IterationField render_iterations_omp(const RenderParams& params, const RenderOptions& options);
+
+    /**
+     * OpenMP并行将迭代场着色为RGB图像 (复用CPU版本的着色函数)
+     * @param field 迭代场
+     * @param max_iter 最大迭代次数
+     * @param trace 非空时记录每个分块的着色区间
+     * @return RGB像素数据向量 (size = width * height * 3)
+     */
+    MandelbrotCPU::ImageBuffer colorize_omp(const IterationField& field, int max_iter,
+                                            MandelbrotCPU::TraceRecorder* trace = nullptr);
+
+    /**
+     * 直方图均衡着色: 按迭代次数的累积分布 (而非 iterations / max_iter) 在色谱上取色,
+     * 深度视图中迭代次数集中在窄区间时仍能铺满整个色谱, 不必靠加大max_iter换取对比度
+     *
+     * 每线程子直方图 -> 按区间并行归约 -> 计算一次CDF并生成颜色查找表 -> 并行查表着色;
+     * 额外开销为一次迭代场遍历和 O(max_iter) 的归约
+     * @param field 迭代场 (值域 [0, max_iter])
+     * @param max_iter 最大迭代次数 (内部像素着黑色, 不参与分布)
+     * @param trace 非空时记录直方图、归约、查找表与每个分块的着色区间
+     * @return RGB像素数据向量 (size = width * height * 3)
+     */
+    MandelbrotCPU::ImageBuffer colorize_equalized_omp(const IterationField& field, int max_iter,
+                                                      MandelbrotCPU::TraceRecorder* trace = nullptr);
+
+    /**
+     * 按颜色查找表并行着色
+     * @param palette 颜色查找表 (size = max_iter + 1, 下标为迭代次数)
+     */
+    MandelbrotCPU::ImageBuffer colorize_omp(const IterationField& field, const std::vector<RGB>& palette,
+                                            MandelbrotCPU::TraceRecorder* trace = nullptr);
+
+    /**
+     * 线性着色的查找表 (palette[i] = iterations_to_color(i, max_iter))
+     */
+    std::vector<RGB> linear_palette(int max_iter);
+
+    /**
+     * 直方图均衡着色的查找表 (colorize_equalized_omp 的前三步)
+     */
+    std::vector<RGB> equalized_palette_omp(const IterationField& field, int max_iter,
+                                           MandelbrotCPU::TraceRecorder* trace = nullptr);
+
+    /**
+     * 边缘自适应超采样选项
+     */
+    struct SupersampleOptions {
+        int samples = 9;                    // 每个边缘像素的子采样数 (取整为 n x n 分层网格, n >= 2)
+        int color_threshold = 48;           // 与4邻域颜色差 (各通道绝对差之和) 超过该值即为边缘
+        MandelbrotCPU::TraceRecorder* trace = nullptr;  // 非空时记录每个分块的补采样区间
+    };
+
+    /**
+     * 边缘超采样统计
+     */
+    struct SupersampleStats {
+        long long edge_pixels = 0;          // 补采样的像素数
+        int samples_per_pixel = 0;          // 每个边缘像素的实际子采样数
+        MandelbrotCPU::RenderCounters counters;  // 子采样的热路径计数 (每个子采样计为一个像素)
+    };
+
+    /**
+     * 边缘自适应超采样抗锯齿
+     * 以基础分辨率的迭代场为准找出边缘像素 (与4邻域跨越集合边界或颜色突变),
+     * 只对这些像素做分层抖动子采样并取平均颜色, 其余像素保持不变;
+     * 边缘像素通常只占几个百分点, 代价远低于整图2x/3x渲染再缩小
+     * @param params 渲染参数 (须与field一致)
+     * @param field 基础分辨率的迭代场
+     * @param palette 着色查找表 (空 = 线性着色), 须与image的着色方式一致
+     * @param image 已着色的图像, 边缘像素被原地替换
+     * @param options 子采样数/边缘阈值
+     * @return 边缘像素数与子采样计数
+     */
+    SupersampleStats supersample_edges_omp(const RenderParams& params, const IterationField& field,
+                                           const std::vector<RGB>& palette, MandelbrotCPU::ImageBuffer& image,
+                                           const SupersampleOptions& options = SupersampleOptions());
+
+    /**
+     * OpenMP并行缩放图像 (线性光空间可分离滤波, 见 image_resample.hpp)
+     * 输入按64行一带推入缩放器, 每带内的水平滤波与已就绪输出行的垂直滤波由线程池并行
+     * @param image 输入RGB图像 (size = width * height * 3)
+     * @param dst_width 输出宽度 (整图超采样时为 width / 倍数)
+     * @param dst_height 输出高度
+     * @param filter 滤波器
+     * @param trace 非空时记录每一带的缩放区间
+     * @return 缩放后的RGB图像 (size = dst_width * dst_height * 3)
+     */
+    MandelbrotCPU::ImageBuffer downsample_omp(const MandelbrotCPU::ImageBuffer& image, int width, int height,
+                                              int dst_width, int dst_height, MandelbrotCPU::ResampleFilter filter,
+                                              MandelbrotCPU::TraceRecorder* trace = nullptr);
+
+    /**
+     * 删除检查点日志 (图像保存成功后调用)
+     * @param checkpoint_file 检查点日志路径
+     */
+    void remove_checkpoint(const std::string& checkpoint_file);
+
+    /**
+     * 获取系统最优线程数 (全部可用处理器, 受进程CPU亲和性限制)
      * @return 推荐的线程数
      */
     int get_optimal_thread_count();
 
     /**
-     * 设置OpenMP线程数和调度策略
+     * 配置全局渲染线程池 (见render_pool.hpp), 配置不变时复用已有线程组
      * @param num_threads 线程数
-     * @param chunk_size 块大小 (用于动态调度)
+     * @param chunk_size 块大小 (保留参数, 分块调度由TileScheduler完成)
+     * @param pin_threads 多NUMA节点时将线程绑定到所属节点
+     */
+    void configure_openmp(int num_threads = 0, int chunk_size = 1, bool pin_threads = true);
+
+    /**
+     * 图像分块 (像素坐标下的矩形区域)
+     */
+    struct Tile {
+        int x0;         // 左上角X像素坐标
+        int y0;         // 左上角Y像素坐标
+        int width;      // 分块宽度
+        int height;     // 分块高度
+    };
+
+    /**
+     * 将图像划分为规则分块 (边缘分块自动裁剪)
+     * @param width 图像宽度
+     * @param height 图像高度
+     * @param tile_width 分块宽度 (传入图像宽度即得到行带分块)
+     * @param tile_height 分块高度
+     * @return 按行优先顺序排列的分块列表
+     */
+    std::vector<Tile> make_tiles(int width, int height, int tile_width, int tile_height);
+
+    /**
+     * OpenMP并行渲染单个分块 (坐标映射与整图渲染一致)
+     * 不输出日志, 供MPI等上层调度器在节点内调用
+     * @param params 整图渲染参数
+     * @param tile 待渲染分块
+     * @param counters 非空时将本分块的热路径计数累加到其中
+     * @return 分块RGB像素数据 (size = tile.width * tile.height * 3)
      */
-    void configure_openmp(int num_threads = 0, int chunk_size = 1);
+    MandelbrotCPU::ImageBuffer render_tile_omp(const RenderParams& params, const Tile& tile,
+                                               MandelbrotCPU::RenderCounters* counters = nullptr);
 
     /**
      * OpenMP并行版本的迭代计算 (内联优化)
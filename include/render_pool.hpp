@@ -0,0 +1,110 @@
+#pragma once
+
+#include "numa_topology.hpp"
+#include "tile_scheduler.hpp"
+#include <omp.h>
+#include <vector>
+
+/**
+ * 渲染线程池 - 进程级持久线程组
+ *
+ * OpenMP运行时在并行区域之间保留工作线程, 但每次渲染重新设置线程数、
+ * 重新计算NUMA布局并逐线程绑定CPU, 小图和缩略图的固定开销会超过渲染本身。
+ * RenderPool 把这些一次性工作集中起来:
+ * - 线程数、NUMA节点归属、CPU绑定只在首次使用或配置变化时执行
+ * - 每次渲染只需提交自己的任务 (分块调度器或循环体), 在同一组线程上执行
+ * - 所有渲染器 (Mandelbrot OpenMP/MPI节点内、Julia OpenMP) 共享同一个线程池
+ *
+ * 线程池不是可重入的: 同一时刻只应由一个宿主线程提交任务。
+ */
+
+namespace MandelbrotOMP {
+
+    class RenderPool {
+    public:
+        /**
+         * 进程级全局线程池
+         */
+        static RenderPool& global();
+
+        /**
+         * 配置线程池 (线程数与绑定策略不变时不做任何事)
+         * @param num_threads 线程数 (0=全部可用处理器)
+         * @param pin_threads 多NUMA节点时将线程绑定到所属节点 (设置OMP_PROC_BIND/OMP_PLACES时不生效)
+         * @return 是否重新配置了线程组
+         */
+        bool configure(int num_threads = 0, bool pin_threads = true);
+
+        int num_threads() const { return num_threads_; }
+        bool pinned() const { return pinned_; }
+
+        /**
+         * 线程所属的NUMA节点下标 (连续线程编号属于同一节点)
+         */
+        const std::vector<int>& thread_nodes() const { return thread_nodes_; }
+
+        /**
+         * 已提交的任务数 (每次 run/run_tiles/parallel_for 计一次)
+         */
+        long long jobs() const { return jobs_; }
+
+        /**
+         * 在线程组的每个线程上执行 body(thread_id)
+         */
+        template <typename Body>
+        void run(Body&& body);
+
+        /**
+         * 线程组从调度器领取分块直到耗尽, 对每个分块执行 body(thread_id, tile_index)
+         */
+        template <typename Body>
+        void run_tiles(TileScheduler& scheduler, Body&& body);
+
+        /**
+         * 动态调度的并行循环, 对 [0, count) 执行 body(index)
+         */
+        template <typename Body>
+        void parallel_for(int count, Body&& body);
+
+    private:
+        RenderPool() = default;
+        void ensure_configured();
+
+        int num_threads_ = 0;
+        bool pin_requested_ = true;
+        bool pinned_ = false;
+        std::vector<int> thread_nodes_;
+        long long jobs_ = 0;
+    };
+
+    template <typename Body>
+    void RenderPool::run(Body&& body) {
+        ensure_configured();
+        ++jobs_;
+
+        #pragma omp parallel num_threads(num_threads_)
+        body(omp_get_thread_num());
+    }
+
+    template <typename Body>
+    void RenderPool::run_tiles(TileScheduler& scheduler, Body&& body) {
+        run([&](int thread_id) {
+            int tile_index = 0;
+            while (scheduler.next(thread_id, tile_index)) {
+                body(thread_id, tile_index);
+            }
+        });
+    }
+
+    template <typename Body>
+    void RenderPool::parallel_for(int count, Body&& body) {
+        ensure_configured();
+        ++jobs_;
+
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads_)
+        for (int index = 0; index < count; ++index) {
+            body(index);
+        }
+    }
+
+} // namespace MandelbrotOMP
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <chrono>
+
+/**
+ * 渲染进度 - 无锁计数 + 限频回调
+ *
+ * 渲染线程每完成一个分块只对自己独占缓存行的计数器做一次relaxed写入
+ * (单写者, 无需原子读改写), 热循环中没有锁也没有I/O。
+ * 汇总与输出由独立的报告线程按固定间隔完成, 也可随时调用 status() 轮询。
+ */
+
+namespace MandelbrotOMP {
+
+    /**
+     * 进度快照
+     */
+    struct ProgressStatus {
+        long long tiles_done = 0;       // 已完成分块数
+        long long tiles_total = 0;      // 分块总数
+        long long pixels_done = 0;      // 已完成像素数
+        long long pixels_total = 0;     // 像素总数
+        double elapsed_seconds = 0.0;   // 开始以来的耗时
+        bool finished = false;          // 渲染是否结束 (最后一次回调)
+
+        double fraction() const {
+            if (pixels_total > 0) return static_cast<double>(pixels_done) / pixels_total;
+            return finished ? 1.0 : 0.0;
+        }
+    };
+
+    using ProgressCallback = std::function<void(const ProgressStatus&)>;
+
+    class ProgressTracker {
+    public:
+        /**
+         * @param num_threads 渲染线程数 (每个线程一个计数槽)
+         * @param tiles_total 分块总数
+         * @param pixels_total 像素总数
+         */
+        ProgressTracker(int num_threads, long long tiles_total, long long pixels_total);
+        ~ProgressTracker();
+
+        ProgressTracker(const ProgressTracker&) = delete;
+        ProgressTracker& operator=(const ProgressTracker&) = delete;
+
+        /**
+         * 记录完成一个分块 (仅由thread_id对应的线程调用)
+         */
+        void add_tile(int thread_id, long long pixels) {
+            Slot& slot = slots_[thread_id % num_slots_];
+            slot.tiles.store(slot.tiles.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            slot.pixels.store(slot.pixels.load(std::memory_order_relaxed) + pixels, std::memory_order_relaxed);
+        }
+
+        /**
+         * 当前进度快照 (任意线程可调用)
+         */
+        ProgressStatus status() const;
+
+        /**
+         * 启动报告线程, 每隔interval_ms调用一次callback (callback为空时不启动)
+         */
+        void start_reporter(ProgressCallback callback, int interval_ms);
+
+        /**
+         * 停止报告线程, 并以 finished=true 调用最后一次回调
+         */
+        void finish();
+
+    private:
+        // 每个线程的计数独占缓存行, 避免伪共享
+        struct alignas(64) Slot {
+            std::atomic<long long> tiles{0};
+            std::atomic<long long> pixels{0};
+        };
+
+        std::unique_ptr<Slot[]> slots_;
+        int num_slots_;
+        long long tiles_total_;
+        long long pixels_total_;
+        std::chrono::steady_clock::time_point start_;
+
+        ProgressCallback callback_;
+        std::thread reporter_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        bool stop_ = false;
+        bool finished_ = false;
+    };
+
+} // namespace MandelbrotOMP
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * 渲染时间线追踪 - Chrome trace-event 格式 (chrome://tracing / Perfetto 可直接打开)
+ *
+ * 每个线程一条独立的事件缓冲 (独占缓存行, 只由所属线程追加), 记录时无锁无I/O;
+ * 渲染结束后由主线程一次性写出JSON。未启用追踪时 TraceSpan 只多一次空指针判断。
+ *
+ * 线程编号: kMainThread (-1) 为调用渲染函数的主线程, 0..n-1 为线程池工作线程。
+ */
+
+namespace MandelbrotCPU {
+
+    class TraceRecorder {
+    public:
+        using Clock = std::chrono::steady_clock;
+        static constexpr int kMainThread = -1;
+
+        /**
+         * @param process_name 时间线中显示的进程名
+         * @param reserve_per_thread 每线程预留的事件数 (超出时按vector规则扩容)
+         */
+        explicit TraceRecorder(std::string process_name, size_t reserve_per_thread = 4096)
+            : process_name_(std::move(process_name)), reserve_(reserve_per_thread), origin_(Clock::now()) {
+            ensure_threads(0);
+        }
+
+        TraceRecorder(const TraceRecorder&) = delete;
+        TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+        /**
+         * 保证工作线程 0..num_threads-1 各有一条事件缓冲 (只能在并行区域之外调用)
+         */
+        void ensure_threads(int num_threads) {
+            while (static_cast<int>(lanes_.size()) < num_threads + 1) {
+                lanes_.push_back(std::make_unique<Lane>());
+                lanes_.back()->events.reserve(reserve_);
+            }
+        }
+
+        /**
+         * 记录一个完整区间 (仅由thread对应的线程调用)
+         * @param name 区间名 (须为字符串字面量, 写出时才读取)
+         * @param category 分类: compute / colorize / encode / io / schedule
+         * @param arg 附加参数 (如分块下标, <0 表示无)
+         */
+        void add(int thread, const char* name, const char* category,
+                 Clock::time_point start, Clock::time_point end, long long arg = -1) {
+            lanes_[thread + 1]->events.push_back({name, category, micros(start), micros(end) - micros(start), arg});
+        }
+
+        /**
+         * 写出 {"traceEvents": [...]} JSON, 失败时返回false
+         */
+        bool write(const std::string& filename) const {
+            std::ofstream file(filename);
+            if (!file) return false;
+
+            file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+            file << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, \"args\": {\"name\": \""
+                 << process_name_ << "\"}}";
+            char buffer[64];
+            for (size_t lane = 0; lane < lanes_.size(); ++lane) {
+                const std::string thread_name = lane == 0 ? "main" : "worker " + std::to_string(lane - 1);
+                file << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << lane
+                     << ", \"args\": {\"name\": \"" << thread_name << "\"}}";
+                file << ",\n{\"name\": \"thread_sort_index\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << lane
+                     << ", \"args\": {\"sort_index\": " << lane << "}}";
+
+                for (const Event& event : lanes_[lane]->events) {
+                    std::snprintf(buffer, sizeof(buffer), "\"ts\": %.3f, \"dur\": %.3f", event.ts_us, event.dur_us);
+                    file << ",\n{\"name\": \"" << event.name << "\", \"cat\": \"" << event.category
+                         << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << lane << ", " << buffer;
+                    if (event.arg >= 0) file << ", \"args\": {\"index\": " << event.arg << "}";
+                    file << "}";
+                }
+            }
+            file << "\n]}\n";
+            return static_cast<bool>(file);
+        }
+
+        /**
+         * 已记录的事件总数
+         */
+        size_t event_count() const {
+            size_t count = 0;
+            for (const auto& lane : lanes_) count += lane->events.size();
+            return count;
+        }
+
+    private:
+        struct Event {
+            const char* name;
+            const char* category;
+            double ts_us;       // 相对追踪开始的时间 (微秒)
+            double dur_us;      // 持续时间 (微秒)
+            long long arg;
+        };
+
+        // 每线程事件缓冲独占缓存行, 避免伪共享
+        struct alignas(64) Lane {
+            std::vector<Event> events;
+        };
+
+        double micros(Clock::time_point t) const {
+            return std::chrono::duration<double, std::micro>(t - origin_).count();
+        }
+
+        std::string process_name_;
+        size_t reserve_;
+        Clock::time_point origin_;
+        std::vector<std::unique_ptr<Lane>> lanes_;  // [0] = 主线程, [t + 1] = 工作线程t
+    };
+
+    /**
+     * 作用域区间: 构造时计时, 析构时记录; trace为空时不做任何事
+     */
+    class TraceSpan {
+    public:
+        TraceSpan(TraceRecorder* trace, int thread, const char* name, const char* category, long long arg = -1)
+            : trace_(trace), thread_(thread), name_(name), category_(category), arg_(arg) {
+            if (trace_) start_ = TraceRecorder::Clock::now();
+        }
+
+        ~TraceSpan() {
+            if (trace_) trace_->add(thread_, name_, category_, start_, TraceRecorder::Clock::now(), arg_);
+        }
+
+        TraceSpan(const TraceSpan&) = delete;
+        TraceSpan& operator=(const TraceSpan&) = delete;
+
+    private:
+        TraceRecorder* trace_;
+        int thread_;
+        const char* name_;
+        const char* category_;
+        long long arg_;
+        TraceRecorder::Clock::time_point start_;
+    };
+
+} // namespace MandelbrotCPU
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * 分块遍历顺序 - 行优先 / Morton (Z序) / Hilbert 空间填充曲线
+ *
+ * 按空间填充曲线排序后, 时间上相邻处理的分块在图像上也相邻:
+ * 分块级状态 (邻域检查、参考轨道、保留的迭代场等) 更可能仍在L2中。
+ * 非2的幂次网格按外接的2的幂次网格计算曲线编号后排序, 空位自动跳过。
+ */
+
+namespace MandelbrotOMP {
+
+    enum class TileOrder {
+        RowMajor,   // 行优先 (从上到下, 从左到右)
+        Morton,     // Z序曲线: 计算最快, 象限内局部性好
+        Hilbert     // Hilbert曲线: 相邻编号的分块必定相邻, 局部性最好
+    };
+
+    // 将16位以上的坐标位间隔展开: ...b2 b1 b0 -> ...0 b2 0 b1 0 b0
+    inline uint64_t morton_spread_bits(uint32_t value) {
+        uint64_t x = value;
+        x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+        x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+        x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+        x = (x | (x << 2)) & 0x3333333333333333ull;
+        x = (x | (x << 1)) & 0x5555555555555555ull;
+        return x;
+    }
+
+    /**
+     * Morton编码 (x占偶数位, y占奇数位)
+     */
+    inline uint64_t morton_encode(uint32_t x, uint32_t y) {
+        return morton_spread_bits(x) | (morton_spread_bits(y) << 1);
+    }
+
+    /**
+     * Hilbert曲线编号
+     * @param n 网格边长 (2的幂次)
+     * @param x 网格X坐标 (< n)
+     * @param y 网格Y坐标 (< n)
+     */
+    inline uint64_t hilbert_index(uint32_t n, uint32_t x, uint32_t y) {
+        uint64_t d = 0;
+        for (uint32_t s = n / 2; s > 0; s /= 2) {
+            uint32_t rx = (x & s) ? 1 : 0;
+            uint32_t ry = (y & s) ? 1 : 0;
+            d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+
+            // 旋转象限, 保证子曲线首尾相接
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = n - 1 - x;
+                    y = n - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return d;
+    }
+
+    /**
+     * 计算行优先分块网格的遍历顺序
+     * @param tiles_x 网格列数
+     * @param tiles_y 网格行数
+     * @param order 遍历顺序
+     * @return 分块索引 (index = ty * tiles_x + tx) 的遍历序列
+     */
+    inline std::vector<int> make_tile_order(int tiles_x, int tiles_y, TileOrder order) {
+        const int count = std::max(0, tiles_x) * std::max(0, tiles_y);
+        std::vector<int> indices(count);
+        for (int i = 0; i < count; ++i) indices[i] = i;
+        if (order == TileOrder::RowMajor || count == 0) return indices;
+
+        uint32_t n = 1;
+        while (n < static_cast<uint32_t>(std::max(tiles_x, tiles_y))) n <<= 1;
+
+        std::vector<uint64_t> keys(count);
+        for (int i = 0; i < count; ++i) {
+            uint32_t tx = static_cast<uint32_t>(i % tiles_x);
+            uint32_t ty = static_cast<uint32_t>(i / tiles_x);
+            keys[i] = (order == TileOrder::Morton) ? morton_encode(tx, ty) : hilbert_index(n, tx, ty);
+        }
+
+        std::sort(indices.begin(), indices.end(), [&keys](int a, int b) { return keys[a] < keys[b]; });
+        return indices;
+    }
+
+    /**
+     * 解析遍历顺序名称 (row / morton / hilbert)
+     * @return 是否识别
+     */
+    inline bool parse_tile_order(const std::string& name, TileOrder& order) {
+        if (name == "row") order = TileOrder::RowMajor;
+        else if (name == "morton") order = TileOrder::Morton;
+        else if (name == "hilbert") order = TileOrder::Hilbert;
+        else return false;
+        return true;
+    }
+
+    inline const char* tile_order_name(TileOrder order) {
+        switch (order) {
+            case TileOrder::Morton: return "morton";
+            case TileOrder::Hilbert: return "hilbert";
+            default: return "row";
+        }
+    }
+
+} // namespace MandelbrotOMP
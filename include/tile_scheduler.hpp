@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * 分块调度器 - 多队列 + 工作窃取
+ *
+ * 每个队列是一段固定的分块索引序列, 由一个原子游标推进 (无锁)。
+ * 每个线程有一个"本地"队列和可选的"共享"队列, 两者耗尽后按固定顺序从其他队列窃取。
+ *
+ * 典型用法:
+ * - 单队列: 所有线程共享, 等价于 schedule(dynamic, 1)
+ * - 每NUMA节点一个队列: 线程优先处理本节点内存上的分块
+ * - 每线程一个代价均衡的连续段 + 共享余量队列: 近似静态划分, 仅余量参与竞争
+ */
+
+namespace MandelbrotOMP {
+
+    class TileScheduler {
+    public:
+        explicit TileScheduler(int num_threads);
+
+        /**
+         * 添加一个分块队列
+         * @param tiles 分块索引 (按处理顺序)
+         * @return 队列编号
+         */
+        int add_queue(std::vector<int> tiles);
+
+        /**
+         * 设置线程的本地队列 (默认: 队列0)
+         */
+        void set_home_queue(int thread_id, int queue);
+
+        /**
+         * 设置线程的共享队列: 本地队列耗尽后优先从此队列领取 (不计为窃取)
+         */
+        void set_shared_queue(int thread_id, int queue);
+
+        /**
+         * 获取下一个待处理分块 (线程安全, 无锁)
+         * @param thread_id 线程编号
+         * @param tile_index 输出: 分块索引
+         * @return 是否还有分块
+         */
+        bool next(int thread_id, int& tile_index);
+
+        int num_queues() const { return static_cast<int>(queues_.size()); }
+
+        /**
+         * 分块被窃取 (非本地队列获取) 的次数
+         */
+        long long steal_count() const { return steals_.load(std::memory_order_relaxed); }
+
+    private:
+        // 独占缓存行, 避免不同队列游标之间的伪共享
+        struct alignas(64) Queue {
+            std::vector<int> tiles;
+            std::atomic<int> cursor{0};
+        };
+
+        bool pop(Queue& queue, int& tile_index);
+
+        std::vector<std::unique_ptr<Queue>> queues_;
+        std::vector<int> home_;
+        std::vector<int> shared_;
+        std::atomic<long long> steals_{0};
+    };
+
+    inline TileScheduler::TileScheduler(int num_threads)
+        : home_(std::max(1, num_threads), 0), shared_(std::max(1, num_threads), -1) {}
+
+    inline int TileScheduler::add_queue(std::vector<int> tiles) {
+        queues_.push_back(std::make_unique<Queue>());
+        queues_.back()->tiles = std::move(tiles);
+        return static_cast<int>(queues_.size()) - 1;
+    }
+
+    inline void TileScheduler::set_home_queue(int thread_id, int queue) {
+        if (thread_id >= 0 && thread_id < static_cast<int>(home_.size())) {
+            home_[thread_id] = queue;
+        }
+    }
+
+    inline void TileScheduler::set_shared_queue(int thread_id, int queue) {
+        if (thread_id >= 0 && thread_id < static_cast<int>(shared_.size())) {
+            shared_[thread_id] = queue;
+        }
+    }
+
+    inline bool TileScheduler::pop(Queue& queue, int& tile_index) {
+        const int size = static_cast<int>(queue.tiles.size());
+        // 先读再抢, 避免耗尽的队列被反复fetch_add
+        if (queue.cursor.load(std::memory_order_relaxed) >= size) return false;
+
+        int position = queue.cursor.fetch_add(1, std::memory_order_relaxed);
+        if (position >= size) return false;
+
+        tile_index = queue.tiles[position];
+        return true;
+    }
+
+    inline bool TileScheduler::next(int thread_id, int& tile_index) {
+        const int num_queues = static_cast<int>(queues_.size());
+        if (num_queues == 0) return false;
+
+        const int home = home_[thread_id % home_.size()] % num_queues;
+        if (pop(*queues_[home], tile_index)) return true;
+
+        const int shared = shared_[thread_id % shared_.size()];
+        if (shared >= 0 && shared < num_queues && pop(*queues_[shared], tile_index)) return true;
+
+        for (int offset = 1; offset < num_queues; ++offset) {
+            const int queue = (home + offset) % num_queues;
+            if (queue == shared) continue;
+            if (pop(*queues_[queue], tile_index)) {
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+} // namespace MandelbrotOMP
@@ -0,0 +1,219 @@
+#!/usr/bin/env python3
+"""
+性能回归检测脚本 (基于 fractal_bench 的内核微基准测试)
+
+功能:
+1. 运行 fractal_bench 并读取其JSON结果
+2. 按机器指纹 (CPU型号 + 编译指令集 + 硬件线程数) 在基线文件中查找基线
+3. 逐内核比较最快一次的 ns/迭代, 超过噪声阈值即判定为回归, 以非零退出码结束
+4. 当前机器没有基线时自动记录; --update 用本次结果覆盖基线
+
+噪声阈值:
+    允许变化 = max(--threshold, --noise-factor * sqrt(cv_基线^2 + cv_本次^2))
+    其中 cv 为多次重复耗时的变异系数。判定为回归的内核会单独重新测量
+    (--confirm 次), 取最快结果后再判定, 避免偶发的调度抖动造成误报。
+
+退出码:
+    0 - 无回归 (或已记录新基线)
+    1 - 存在显著回归
+    2 - 运行错误 (基准程序失败、迭代总数与基线不一致等)
+
+使用示例:
+python scripts/perf_regress.py --bench build/fractal_bench --baseline output/perf_baselines.json
+python scripts/perf_regress.py --bench build/fractal_bench --baseline output/perf_baselines.json --update
+python scripts/perf_regress.py --results bench.json --baseline output/perf_baselines.json
+
+依赖: 仅Python标准库
+"""
+
+import argparse
+import json
+import math
+import os
+import subprocess
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+BASELINE_VERSION = 1
+
+
+def machine_fingerprint(machine):
+    """机器指纹: 只有指纹相同的结果之间才可比"""
+    return "{} | {} | {} threads".format(machine.get("cpu", "unknown"),
+                                         machine.get("isa", "generic"),
+                                         machine.get("threads", 0))
+
+
+def run_bench(bench, points, repeat, kernel_filter=None):
+    """运行 fractal_bench, 返回解析后的JSON结果"""
+    fd, json_path = tempfile.mkstemp(suffix=".json", prefix="fractal_bench_")
+    os.close(fd)
+    try:
+        cmd = [bench, "--points", str(points), "--repeat", str(repeat), "--json", json_path]
+        if kernel_filter:
+            cmd += ["--filter", kernel_filter]
+        proc = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.PIPE, universal_newlines=True)
+        if proc.returncode != 0:
+            raise RuntimeError("基准程序失败 (退出码 {}):\n{}{}".format(proc.returncode, proc.stdout, proc.stderr))
+        with open(json_path) as f:
+            return json.load(f)
+    finally:
+        os.unlink(json_path)
+
+
+def load_baselines(path):
+    if not Path(path).exists():
+        return {"version": BASELINE_VERSION, "machines": {}}
+    with open(path) as f:
+        data = json.load(f)
+    if data.get("version") != BASELINE_VERSION:
+        raise RuntimeError("不支持的基线文件版本: {}".format(data.get("version")))
+    return data
+
+
+def save_baselines(path, data):
+    Path(path).parent.mkdir(parents=True, exist_ok=True)
+    tmp_path = str(path) + ".tmp"
+    with open(tmp_path, "w") as f:
+        json.dump(data, f, indent=2, sort_keys=True)
+        f.write("\n")
+    os.replace(tmp_path, path)
+
+
+def make_baseline_entry(results):
+    return {
+        "machine": results["machine"],
+        "points_per_axis": results["points_per_axis"],
+        "recorded": time.strftime("%Y-%m-%d %H:%M:%S"),
+        "kernels": {
+            k["name"]: {
+                "iterations": k["iterations"],
+                "min_ns_per_iter": k["min_ns_per_iter"],
+                "cv": k["cv"],
+            }
+            for k in results["kernels"]
+        },
+    }
+
+
+def allowed_change(base, current, threshold, noise_factor):
+    noise = noise_factor * math.sqrt(base["cv"] ** 2 + current["cv"] ** 2)
+    return max(threshold, noise)
+
+
+def compare(baseline, results, threshold, noise_factor):
+    """
+    逐内核比较, 返回 (报告行列表, 回归内核名列表, 错误列表)
+    """
+    rows, regressions, errors = [], [], []
+    base_kernels = baseline["kernels"]
+
+    for kernel in results["kernels"]:
+        name = kernel["name"]
+        base = base_kernels.get(name)
+        if base is None:
+            rows.append((name, None, kernel["min_ns_per_iter"], None, None, "新内核"))
+            continue
+        if base["iterations"] != kernel["iterations"]:
+            errors.append("{}: 迭代总数 {} 与基线 {} 不一致 (内核语义已改变, 请用 --update 重新记录)"
+                          .format(name, kernel["iterations"], base["iterations"]))
+            continue
+
+        change = kernel["min_ns_per_iter"] / base["min_ns_per_iter"] - 1.0
+        limit = allowed_change(base, kernel, threshold, noise_factor)
+        if change > limit:
+            status = "回归"
+            regressions.append(name)
+        elif change < -limit:
+            status = "提升"
+        else:
+            status = "持平"
+        rows.append((name, base["min_ns_per_iter"], kernel["min_ns_per_iter"], change, limit, status))
+
+    return rows, regressions, errors
+
+
+def print_report(rows):
+    print("{:<24}{:>14}{:>14}{:>10}{:>10}  {}".format("内核", "基线ns/迭代", "本次ns/迭代", "变化%", "阈值%", "结论"))
+    for name, base, current, change, limit, status in rows:
+        print("{:<24}{:>14}{:>14.3f}{:>10}{:>10}  {}".format(
+            name,
+            "-" if base is None else "{:.3f}".format(base),
+            current,
+            "-" if change is None else "{:+.1f}".format(change * 100),
+            "-" if limit is None else "{:.1f}".format(limit * 100),
+            status))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="基于 fractal_bench 的性能回归检测")
+    parser.add_argument("--bench", default="./build/fractal_bench", help="fractal_bench 可执行文件路径")
+    parser.add_argument("--results", help="直接使用已有的 fractal_bench JSON 结果 (不运行基准程序)")
+    parser.add_argument("--baseline", default="output/perf_baselines.json", help="基线文件路径")
+    parser.add_argument("--points", type=int, default=128, help="每视图网格边长 (默认: 128)")
+    parser.add_argument("--repeat", type=int, default=7, help="计时重复次数 (默认: 7)")
+    parser.add_argument("--threshold", type=float, default=0.05, help="最小回归阈值 (默认: 0.05 = 5%%)")
+    parser.add_argument("--noise-factor", type=float, default=3.0, help="噪声阈值倍数 (默认: 3.0)")
+    parser.add_argument("--confirm", type=int, default=1, help="回归内核的重新测量次数 (默认: 1)")
+    parser.add_argument("--update", action="store_true", help="用本次结果覆盖当前机器的基线")
+    args = parser.parse_args()
+
+    try:
+        if args.results:
+            with open(args.results) as f:
+                results = json.load(f)
+        else:
+            results = run_bench(args.bench, args.points, args.repeat)
+
+        fingerprint = machine_fingerprint(results["machine"])
+        baselines = load_baselines(args.baseline)
+        print("机器指纹: {}".format(fingerprint))
+
+        baseline = baselines["machines"].get(fingerprint)
+        if baseline is None or args.update:
+            baselines["machines"][fingerprint] = make_baseline_entry(results)
+            save_baselines(args.baseline, baselines)
+            print("{}基线: {} ({} 个内核)".format("更新" if baseline else "记录", args.baseline,
+                                                 len(results["kernels"])))
+            return 0
+
+        if baseline["points_per_axis"] != results["points_per_axis"]:
+            print("错误: 基线点集 {} 与本次 {} 不同".format(baseline["points_per_axis"], results["points_per_axis"]),
+                  file=sys.stderr)
+            return 2
+
+        rows, regressions, errors = compare(baseline, results, args.threshold, args.noise_factor)
+
+        # 对疑似回归的内核单独重新测量, 取最快结果
+        if regressions and not args.results:
+            by_name = {k["name"]: k for k in results["kernels"]}
+            for _ in range(args.confirm):
+                for name in regressions:
+                    rerun = run_bench(args.bench, args.points, args.repeat, name)
+                    for kernel in rerun["kernels"]:
+                        if kernel["name"] == name and kernel["min_ns_per_iter"] < by_name[name]["min_ns_per_iter"]:
+                            by_name[name].update(kernel)
+                rows, regressions, errors = compare(baseline, results, args.threshold, args.noise_factor)
+                if not regressions:
+                    break
+
+        print_report(rows)
+        for message in errors:
+            print("错误: " + message, file=sys.stderr)
+        if errors:
+            return 2
+        if regressions:
+            print("检测到性能回归: {}".format(", ".join(regressions)), file=sys.stderr)
+            return 1
+        print("未检测到性能回归 (基线记录于 {})".format(baseline["recorded"]))
+        return 0
+
+    except (OSError, RuntimeError, ValueError, KeyError) as e:
+        print("错误: {}".format(e), file=sys.stderr)
+        return 2
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -9,9 +9,40 @@ const app = express();
 const PORT = process.env.PORT || 3000;
 const BINARY_PATH = process.env.FRACTAL_BIN || path.join(__dirname, '..', 'build', 'fractal_api');
 
-// Concurrency limiter for render requests (prevents OOM on small instances)
-const MAX_CONCURRENT_RENDERS = parseInt(process.env.MAX_RENDERS) || 2;
+// Memory-budget admission for render requests (prevents OOM on small instances).
+// Each render reserves its estimated peak: the fractal_api child's RSS plus the PPM held three
+// times on the Node side (execFile's buffered stdout, sharp's raw input, the encoded output).
+// The child's share is learned from the peak_rss_bytes field of its --stats line.
+const RENDER_MEMORY_BUDGET = (parseInt(process.env.RENDER_MEMORY_BUDGET_MB) || 256) * 1024 * 1024;
+const MAX_CONCURRENT_RENDERS = parseInt(process.env.MAX_RENDERS) || Infinity; // optional hard cap
 let activeRenders = 0;
+let reservedBytes = 0;
+let childPeakBytes = 16 * 1024 * 1024; // prior until the first stats line arrives
+
+function estimateRenderBytes(w, h) {
+    return childPeakBytes + 3 * w * h * 3;
+}
+
+// Track the typical child peak, but never estimate below the latest observation
+function observeChildPeak(bytes) {
+    if (!(bytes > 0)) return;
+    childPeakBytes = Math.max(bytes, 0.9 * childPeakBytes + 0.1 * bytes);
+}
+
+// Progress of in-flight renders, keyed by client-supplied renderId.
+// Fed from the binary's "progress <0..1>" stderr lines; kept briefly after completion.
+const renderProgress = new Map();
+const PROGRESS_TTL_MS = 60000;
+const RENDER_ID_PATTERN = /^[A-Za-z0-9_-]{1,64}$/;
+
+function setProgress(renderId, state, progress) {
+    if (!renderId) return;
+    const entry = renderProgress.get(renderId) || {};
+    clearTimeout(entry.expiry);
+    const expiry = setTimeout(() => renderProgress.delete(renderId), PROGRESS_TTL_MS);
+    expiry.unref();
+    renderProgress.set(renderId, { state, progress, expiry, updated: Date.now() });
+}
 
 app.use(cors());
 app.use(compression());
@@ -19,7 +50,14 @@ app.use(express.json());
 
 // Health check
 app.get('/api/health', (req, res) => {
-    res.json({ status: 'ok', version: '1.0.0', renderer: 'fractal-api' });
+    res.json({
+        status: 'ok', version: '1.0.0', renderer: 'fractal-api',
+        renders: {
+            active: activeRenders,
+            reservedMB: Math.round(reservedBytes / 1048576),
+            budgetMB: Math.round(RENDER_MEMORY_BUDGET / 1048576)
+        }
+    });
 });
 
 // Server-side fractal rendering API
@@ -35,28 +73,76 @@ app.get('/api/render', (req, res) => {
         iter = '1000',
         juliaReal = '-0.7269',
         juliaImag = '0.1889',
-        format = 'png'
+        format = 'png',
+        aa,
+        supersample = '1',
+        filter = 'lanczos3',
+        renderId
     } = req.query;
 
+    if (renderId !== undefined && !RENDER_ID_PATTERN.test(renderId)) {
+        return res.status(400).json({ error: 'Invalid renderId' });
+    }
+
     // Validate dimensions (cap at 4K for safety)
     const w = Math.min(Math.max(parseInt(width) || 800, 1), 3840);
     const h = Math.min(Math.max(parseInt(height) || 600, 1), 2160);
     const maxIter = Math.min(Math.max(parseInt(iter) || 1000, 50), 10000);
     const zoomVal = Math.max(parseFloat(zoom) || 1.0, 0.001);
 
-    const validFractals = ['mandelbrot', 'julia', 'burning_ship', 'newton', 'tricorn', 'phoenix'];
+    const validFractals = ['mandelbrot', 'julia', 'burning_ship', 'newton', 'tricorn', 'phoenix', 'mandelbulb', 'custom'];
     if (!validFractals.includes(fractal)) {
         return res.status(400).json({ error: 'Invalid fractal type' });
     }
 
-    // Concurrency guard — reject if too many renders in-flight
-    if (activeRenders >= MAX_CONCURRENT_RENDERS) {
+    // Distance-estimator anti-aliasing (no extra samples) for the escape-time fractals with a derivative
+    const deFractals = ['mandelbrot', 'julia', 'burning_ship', 'tricorn'];
+    if (aa !== undefined && (aa !== 'de' || !deFractals.includes(fractal))) {
+        return res.status(400).json({ error: 'Invalid anti-aliasing mode', supported: { de: deFractals } });
+    }
+
+    // Mandelbulb: integer power and camera angles; iter caps the ray-march steps per pixel
+    const { power = '8', yaw = '30', pitch = '20' } = req.query;
+    const powerVal = parseInt(power);
+    if (fractal === 'mandelbulb' && !(powerVal >= 2 && powerVal <= 16)) {
+        return res.status(400).json({ error: 'Invalid power (2-16)' });
+    }
+
+    // Custom formulas are compiled by fractal_api; only the length and character set are checked here
+    const { formula } = req.query;
+    if ((fractal === 'custom') !== (formula !== undefined)) {
+        return res.status(400).json({ error: 'formula is required by, and only valid with, fractal=custom' });
+    }
+    if (formula !== undefined && (typeof formula !== 'string' || formula.length > 200 ||
+                                  !/^[A-Za-z0-9_.+\-*\/^(), ]+$/.test(formula))) {
+        return res.status(400).json({ error: 'Invalid formula' });
+    }
+
+    // Supersampling renders n x n more pixels but streams them through the downsampler,
+    // so it costs CPU time, not memory
+    const ss = Math.min(Math.max(parseInt(supersample) || 1, 1), 4);
+    if (!['box', 'tent', 'lanczos3'].includes(filter)) {
+        return res.status(400).json({ error: 'Invalid filter' });
+    }
+
+    // Memory guard — reject if this render does not fit next to the in-flight ones.
+    // A render larger than the whole budget is still admitted when nothing else is running.
+    const reservation = estimateRenderBytes(w, h);
+    if (activeRenders > 0 &&
+        (reservedBytes + reservation > RENDER_MEMORY_BUDGET || activeRenders >= MAX_CONCURRENT_RENDERS)) {
         return res.status(503).json({
             error: 'Server busy',
-            detail: `${activeRenders} renders in progress, max ${MAX_CONCURRENT_RENDERS}`
+            detail: `${activeRenders} renders in progress, ${Math.round(reservedBytes / 1048576)} MB of ` +
+                `${Math.round(RENDER_MEMORY_BUDGET / 1048576)} MB reserved, this render needs ~` +
+                `${Math.round(reservation / 1048576)} MB`
         });
     }
     activeRenders++;
+    reservedBytes += reservation;
+    const release = () => {
+        activeRenders--;
+        reservedBytes -= reservation;
+    };
 
     const args = [
         '--fractal', fractal,
@@ -79,17 +165,48 @@ app.get('/api/render', (req, res) => {
         args.push('--phoenix-py', String(parseFloat(phoenixPy) || 0.0));
     }
 
-    execFile(BINARY_PATH, args, {
+    if (fractal === 'mandelbulb') {
+        args.push('--power', String(powerVal));
+        args.push('--yaw', String(parseFloat(yaw) || 0));
+        args.push('--pitch', String(parseFloat(pitch) || 0));
+    }
+
+    if (formula !== undefined) {
+        args.push('--formula', formula);
+    }
+
+    if (aa) {
+        args.push('--aa', aa);
+    }
+    if (ss > 1) {
+        args.push('--supersample', String(ss), '--filter', filter);
+    }
+
+    // Hot-path counters and peak RSS / allocations for cost accounting and admission
+    args.push('--stats');
+
+    if (renderId) {
+        args.push('--progress');
+        setProgress(renderId, 'rendering', 0);
+    }
+
+    const child = execFile(BINARY_PATH, args, {
         encoding: 'buffer',
         maxBuffer: 30 * 1024 * 1024, // 30MB — enough for 4K PPM (24MB)
         timeout: 30000 // 30s timeout
     }, async (err, stdout, stderr) => {
         if (err) {
-            activeRenders--;
+            release();
+            setProgress(renderId, 'failed', 0);
             console.error('Render failed:', err.message);
             if (stderr && stderr.length > 0) {
                 console.error('stderr:', stderr.toString());
             }
+            // Syntax errors in a custom formula are the client's, reported with their position
+            const message = stderr ? stderr.toString().trim() : '';
+            if (message.startsWith('Invalid formula')) {
+                return res.status(400).json({ error: 'Invalid formula', details: message });
+            }
             return res.status(500).json({
                 error: 'Render failed',
                 details: err.message
@@ -135,11 +252,44 @@ app.get('/api/render', (req, res) => {
             console.error('Image conversion failed:', convErr.message);
             res.status(500).json({ error: 'Image conversion failed', details: convErr.message });
         } finally {
-            activeRenders--;
+            release();
+            setProgress(renderId, 'done', 1);
+        }
+    });
+
+    let pending = '';
+    child.stderr.on('data', (chunk) => {
+        pending += chunk.toString();
+        const lines = pending.split('\n');
+        pending = lines.pop();
+        for (const line of lines) {
+            const text = line.trim();
+            const match = /^progress ([0-9.eE+-]+)$/.exec(text);
+            if (match) {
+                if (renderId) setProgress(renderId, 'rendering', Math.min(Math.max(parseFloat(match[1]), 0), 1));
+            } else if (text.startsWith('{')) {
+                try {
+                    const stats = JSON.parse(text);
+                    observeChildPeak(stats.peak_rss_bytes);
+                    console.log('Render stats:', JSON.stringify({ fractal, width: w, height: h, ...stats }));
+                } catch (e) {
+                    // Not a stats line; ignore
+                }
+            }
         }
     });
 });
 
+// Poll progress of a render started with ?renderId=<id>
+app.get('/api/progress/:renderId', (req, res) => {
+    const entry = renderProgress.get(req.params.renderId);
+    if (!entry) {
+        return res.status(404).json({ error: 'Unknown renderId' });
+    }
+    res.set('Cache-Control', 'no-store');
+    res.json({ renderId: req.params.renderId, state: entry.state, progress: entry.progress });
+});
+
 // Serve high-resolution wallpaper presets
 app.get('/api/wallpaper/:preset', (req, res) => {
     const presets = {
@@ -172,6 +322,10 @@ app.get('/api/wallpaper/:preset', (req, res) => {
         'phoenix': {
             fractal: 'phoenix', cx: '0', cy: '0', zoom: '1', iter: '1000',
             phoenixPx: '0.5667', phoenixPy: '0'
+        },
+        'mandelbulb': {
+            fractal: 'mandelbulb', cx: '0', cy: '0', zoom: '1', iter: '256',
+            power: '8', yaw: '30', pitch: '20'
         }
     };
 
@@ -191,7 +345,10 @@ app.get('/api/wallpaper/:preset', (req, res) => {
         ...preset,
         width: String(Math.min(width || 1920, 3840)),
         height: String(Math.min(height || 1080, 2160)),
-        format
+        format,
+        ...(req.query.aa ? { aa: String(req.query.aa) } : {}),
+        ...(req.query.supersample ? { supersample: String(req.query.supersample) } : {}),
+        ...(req.query.renderId ? { renderId: String(req.query.renderId) } : {})
     });
 
     // Internal redirect via query rewrite (avoids client redirect)
@@ -207,10 +364,11 @@ app.get('/api', (req, res) => {
         version: '1.0.0',
         endpoints: {
             'GET /api/health': 'Health check',
-            'GET /api/render': 'Render fractal image (params: fractal, width, height, cx, cy, zoom, iter, format)',
-            'GET /api/wallpaper/:preset': 'High-res wallpaper presets (params: resolution, format)',
+            'GET /api/render': 'Render fractal image (params: fractal, width, height, cx, cy, zoom, iter, format, aa, supersample, filter, power, yaw, pitch, formula, renderId)',
+            'GET /api/progress/:renderId': 'Progress of a render started with renderId (state, progress 0..1)',
+            'GET /api/wallpaper/:preset': 'High-res wallpaper presets (params: resolution, format, aa, supersample)',
         },
-        fractals: ['mandelbrot', 'julia', 'burning_ship', 'newton'],
+        fractals: ['mandelbrot', 'julia', 'burning_ship', 'newton', 'tricorn', 'phoenix', 'mandelbulb', 'custom'],
         formats: ['png', 'webp', 'jpeg', 'ppm'],
         maxResolution: '3840x2160'
     });
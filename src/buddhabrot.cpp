@@ -0,0 +1,280 @@
+/**
+ * Buddhabrot 轨道密度渲染器实现
+ *
+ * 作者: Geoffrey Wang (with Claude AI assistance)
+ * 日期: 2025-08-14
+ */
+
+#include "../include/buddhabrot.hpp"
+#include "../include/fractal_kernels.hpp"
+#include "../include/render_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <omp.h>
+
+namespace MandelbrotOMP {
+
+    namespace {
+
+        // 采样域 [-2, 2] x [-2, 2]: 集合在其中, 其外的c第一步就逃逸, 轨道不可能满足min_iter
+        const double DOMAIN_MIN = -2.0;
+        const double DOMAIN_SIZE = 4.0;
+        const int BATCH_SIZE = 16384;       // 每批样本数 (动态派发的粒度)
+        const int MAP_SUBSAMPLES = 4;       // 重要性图每格每轴子采样数
+        const double MAP_FLOOR = 0.05;      // 膨胀格子相对平均权重的下限
+        const double MAP_FAR_FLOOR = 0.001; // 远离命中格的格子相对平均权重的下限 (保证无偏)
+
+        // splitmix64: 每批一个独立的随机数流, 种子只取决于批次编号
+        struct SplitMix64 {
+            uint64_t state;
+
+            uint64_t next() {
+                uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                return z ^ (z >> 31);
+            }
+
+            double uniform() { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0); }
+        };
+
+        // 每线程计数槽 (独占缓存行)
+        struct alignas(64) ThreadTotals {
+            long long samples = 0;
+            long long accepted = 0;
+            long long orbit_points = 0;
+            long long iterations = 0;
+        };
+
+        /**
+         * 用逃逸时间内核判定c的轨道是否累加
+         * @param iterations 输出: 轨道长度 (需要累加的点数)
+         * @param executed 输出: 判定实际执行的迭代次数 (跳过判定命中时为0)
+         */
+        bool accepts(double cr, double ci, const BuddhabrotParams& params, int& iterations, int& executed) {
+            if (mandelbrotShortcut(cr, ci) != NoShortcut) {
+                iterations = params.max_iter;
+                executed = 0;
+                return params.anti;
+            }
+            iterations = executed = mandelbrotEscapeIterations(cr, ci, params.max_iter);
+            return params.anti ? iterations == params.max_iter
+                               : iterations >= params.min_iter && iterations < params.max_iter;
+        }
+
+        // 重要性采样表: 格子按累积概率二分查找, 样本权重 = 均匀概率 / 格子概率
+        struct ImportanceMap {
+            int grid = 0;
+            std::vector<double> cdf;
+            std::vector<double> weight;
+            double uniform_acceptance = 0.0;
+        };
+
+        ImportanceMap build_importance_map(RenderPool& pool, const BuddhabrotParams& params) {
+            const int grid = std::max(1, params.importance_grid);
+            const double cell = DOMAIN_SIZE / grid;
+            std::vector<double> fraction(static_cast<size_t>(grid) * grid);
+
+            // 每格 MAP_SUBSAMPLES^2 个分层子采样中满足条件的比例
+            pool.parallel_for(grid, [&](int gy) {
+                for (int gx = 0; gx < grid; ++gx) {
+                    int hits = 0;
+                    for (int sy = 0; sy < MAP_SUBSAMPLES; ++sy) {
+                        for (int sx = 0; sx < MAP_SUBSAMPLES; ++sx) {
+                            const double cr = DOMAIN_MIN + (gx + (sx + 0.5) / MAP_SUBSAMPLES) * cell;
+                            const double ci = DOMAIN_MIN + (gy + (sy + 0.5) / MAP_SUBSAMPLES) * cell;
+                            int iterations = 0, executed = 0;
+                            if (accepts(cr, ci, params, iterations, executed)) ++hits;
+                        }
+                    }
+                    fraction[static_cast<size_t>(gy) * grid + gx] = static_cast<double>(hits) / (MAP_SUBSAMPLES * MAP_SUBSAMPLES);
+                }
+            });
+
+            ImportanceMap map;
+            map.grid = grid;
+            double sum = 0.0;
+            int nonzero = 0;
+            for (double f : fraction) {
+                sum += f;
+                if (f > 0.0) ++nonzero;
+            }
+            map.uniform_acceptance = sum / fraction.size();
+
+            // 子采样全未命中的格子若与命中格相邻, 仍以下限权重保留 (细丝可能从子采样之间穿过);
+            // 远离命中格的格子取更小的下限: 极少被采到, 但概率不为0, 估计保持无偏
+            const double floor = nonzero > 0 ? MAP_FLOOR * sum / nonzero : 1.0;
+            const double far_floor = nonzero > 0 ? MAP_FAR_FLOOR * sum / nonzero : 1.0;
+            std::vector<double> probability(fraction.size(), far_floor);
+            for (int gy = 0; gy < grid; ++gy) {
+                for (int gx = 0; gx < grid; ++gx) {
+                    const size_t index = static_cast<size_t>(gy) * grid + gx;
+                    bool near_hit = nonzero == 0;
+                    for (int dy = -1; dy <= 1 && !near_hit; ++dy) {
+                        for (int dx = -1; dx <= 1 && !near_hit; ++dx) {
+                            const int nx = gx + dx, ny = gy + dy;
+                            near_hit = nx >= 0 && ny >= 0 && nx < grid && ny < grid &&
+                                       fraction[static_cast<size_t>(ny) * grid + nx] > 0.0;
+                        }
+                    }
+                    if (near_hit) probability[index] = std::max(fraction[index], floor);
+                }
+            }
+
+            double total = 0.0;
+            map.cdf.resize(probability.size());
+            map.weight.resize(probability.size());
+            for (size_t i = 0; i < probability.size(); ++i) {
+                total += probability[i];
+                map.cdf[i] = total;
+            }
+            for (size_t i = 0; i < probability.size(); ++i) {
+                map.weight[i] = total / (probability[i] * probability.size());
+            }
+            for (double& c : map.cdf) c /= total;
+            return map;
+        }
+
+    } // namespace
+
+    BuddhabrotImage render_buddhabrot_omp(const BuddhabrotParams& params) {
+        using Clock = std::chrono::steady_clock;
+        RenderPool& pool = RenderPool::global();
+        pool.configure(params.num_threads);
+        const int num_threads = pool.num_threads();
+        MandelbrotCPU::TraceRecorder* trace = params.trace;
+        if (trace) trace->ensure_threads(num_threads);
+        const int kMain = MandelbrotCPU::TraceRecorder::kMainThread;
+
+        BuddhabrotImage image;
+        image.width = params.width;
+        image.height = params.height;
+        const size_t num_pixels = static_cast<size_t>(params.width) * params.height;
+
+        // 1. 重要性图
+        auto phase_start = Clock::now();
+        ImportanceMap map;
+        if (params.sampling == BuddhabrotSampling::Importance) {
+            MandelbrotCPU::TraceSpan span(trace, kMain, "importance_map", "schedule");
+            map = build_importance_map(pool, params);
+            image.stats.uniform_acceptance = map.uniform_acceptance;
+        }
+        image.stats.map_seconds = std::chrono::duration<double>(Clock::now() - phase_start).count();
+
+        // 2. 采样与累加: 每线程独占密度图 (由本线程首次写入)
+        phase_start = Clock::now();
+        std::vector<std::vector<double>> thread_density(num_threads);
+        std::vector<ThreadTotals> totals(num_threads);
+        pool.run([&](int tid) { thread_density[tid].assign(num_pixels, 0.0); });
+
+        const double x_scale = params.width / (params.x_max - params.x_min);
+        const double y_scale = params.height / (params.y_max - params.y_min);
+        const double cell = map.grid > 0 ? DOMAIN_SIZE / map.grid : 0.0;
+        const long long num_batches = (params.samples + BATCH_SIZE - 1) / BATCH_SIZE;
+
+        {
+            MandelbrotCPU::TraceSpan span(trace, kMain, "sample", "compute");
+            pool.parallel_for(static_cast<int>(num_batches), [&](int batch) {
+                const int tid = omp_get_thread_num();
+                MandelbrotCPU::TraceSpan batch_span(trace, tid, "sample_batch", "compute", batch);
+                double* density = thread_density[tid].data();
+                ThreadTotals& t = totals[tid];
+                SplitMix64 rng{params.seed * 0x2545F4914F6CDD1DULL + static_cast<uint64_t>(batch)};
+                const long long count = std::min<long long>(BATCH_SIZE, params.samples - batch * static_cast<long long>(BATCH_SIZE));
+
+                for (long long s = 0; s < count; ++s) {
+                    double cr, ci;
+                    double weight = 1.0;
+                    if (map.grid > 0) {
+                        const size_t index = std::upper_bound(map.cdf.begin(), map.cdf.end(), rng.uniform()) - map.cdf.begin();
+                        const size_t cell_index = std::min(index, map.cdf.size() - 1);
+                        weight = map.weight[cell_index];
+                        cr = DOMAIN_MIN + (static_cast<int>(cell_index % map.grid) + rng.uniform()) * cell;
+                        ci = DOMAIN_MIN + (static_cast<int>(cell_index / map.grid) + rng.uniform()) * cell;
+                    } else {
+                        cr = DOMAIN_MIN + rng.uniform() * DOMAIN_SIZE;
+                        ci = DOMAIN_MIN + rng.uniform() * DOMAIN_SIZE;
+                    }
+
+                    int length = 0, executed = 0;
+                    const bool accepted = accepts(cr, ci, params, length, executed);
+                    t.iterations += executed;
+                    if (!accepted) continue;
+                    ++t.accepted;
+
+                    // 第二遍: 重新迭代, 把轨道点累加到本线程的密度图
+                    double zx = 0.0, zy = 0.0;
+                    for (int i = 0; i < length; ++i) {
+                        const double next_x = zx * zx - zy * zy + cr;
+                        zy = 2.0 * zx * zy + ci;
+                        zx = next_x;
+                        const double px = (zx - params.x_min) * x_scale;
+                        const double py = (zy - params.y_min) * y_scale;
+                        if (px >= 0.0 && py >= 0.0 && px < params.width && py < params.height) {
+                            density[static_cast<size_t>(py) * params.width + static_cast<size_t>(px)] += weight;
+                        }
+                    }
+                    t.orbit_points += length;
+                    t.iterations += length;
+                }
+                t.samples += count;
+            });
+        }
+        image.stats.sample_seconds = std::chrono::duration<double>(Clock::now() - phase_start).count();
+
+        // 3. 按行带并行归约每线程密度图
+        phase_start = Clock::now();
+        {
+            MandelbrotCPU::TraceSpan span(trace, kMain, "merge", "compute");
+            image.density.resize(num_pixels);
+            const int band_rows = 16;
+            pool.parallel_for((params.height + band_rows - 1) / band_rows, [&](int band) {
+                const size_t begin = static_cast<size_t>(band) * band_rows * params.width;
+                const size_t end = std::min(num_pixels, begin + static_cast<size_t>(band_rows) * params.width);
+                for (size_t i = begin; i < end; ++i) {
+                    double sum = 0.0;
+                    for (const std::vector<double>& d : thread_density) sum += d[i];
+                    image.density[i] = sum;
+                }
+            });
+        }
+        image.stats.merge_seconds = std::chrono::duration<double>(Clock::now() - phase_start).count();
+
+        for (const ThreadTotals& t : totals) {
+            image.stats.samples += t.samples;
+            image.stats.accepted += t.accepted;
+            image.stats.orbit_points += t.orbit_points;
+            image.stats.iterations += t.iterations;
+        }
+        return image;
+    }
+
+    MandelbrotCPU::ImageBuffer buddhabrot_to_rgb(const BuddhabrotImage& image, double gamma) {
+        // 按非零密度的99.9百分位归一化, 少数热点像素不至于把整图压暗
+        // 累加结束后才降为float: 色调映射只需要相对亮度
+        std::vector<float> nonzero;
+        nonzero.reserve(image.density.size());
+        for (double d : image.density) {
+            if (d > 0.0) nonzero.push_back(static_cast<float>(d));
+        }
+        float reference = 1.0f;
+        if (!nonzero.empty()) {
+            const size_t k = static_cast<size_t>(0.999 * (nonzero.size() - 1));
+            std::nth_element(nonzero.begin(), nonzero.begin() + k, nonzero.end());
+            reference = std::max(nonzero[k], 1e-12f);
+        }
+
+        MandelbrotCPU::ImageBuffer rgb(image.density.size() * 3);
+        for (size_t i = 0; i < image.density.size(); ++i) {
+            const float density = static_cast<float>(image.density[i]);
+            const double v = std::pow(std::min(1.0, density / static_cast<double>(reference)), gamma);
+            // 暗部偏蓝, 亮部趋白
+            rgb[i * 3] = static_cast<unsigned char>(255.0 * std::pow(v, 1.6) + 0.5);
+            rgb[i * 3 + 1] = static_cast<unsigned char>(255.0 * std::pow(v, 1.15) + 0.5);
+            rgb[i * 3 + 2] = static_cast<unsigned char>(255.0 * std::pow(v, 0.75) + 0.5);
+        }
+        return rgb;
+    }
+
+} // namespace MandelbrotOMP
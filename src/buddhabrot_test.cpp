@@ -0,0 +1,152 @@
+/**
+ * Buddhabrot / anti-Buddhabrot 轨道密度渲染测试
+ *
+ * 随机采样c, 把满足条件的轨道累加成密度图后做色调映射, 报告:
+ * - 采样吞吐 (样本/秒) 与累加的轨道点数
+ * - 接受率: 重要性采样的实际接受率 vs 均匀采样的估计接受率
+ * - 各阶段耗时 (重要性图 / 采样累加 / 每线程密度图归约)
+ *
+ * 使用示例:
+ * ./buddhabrot_test --width 1000 --height 1000 --samples 20000000 --iter 5000
+ * ./buddhabrot_test --anti --iter 500 --output output/anti_buddhabrot.ppm
+ * ./buddhabrot_test --uniform --samples 2000000   # 对比均匀采样
+ *
+ * 作者: Geoffrey Wang (with Claude AI assistance)
+ */
+
+#include "../include/buddhabrot.hpp"
+#include "../include/render.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace MandelbrotOMP;
+
+namespace {
+
+    void print_usage(const char* program_name) {
+        std::cout << "\n=== Buddhabrot 轨道密度渲染 ===" << std::endl;
+        std::cout << "用法: " << program_name << " [选项]" << std::endl;
+        std::cout << "\n选项:" << std::endl;
+        std::cout << "  --width <w>      图像宽度 (默认: 1000)" << std::endl;
+        std::cout << "  --height <h>     图像高度 (默认: 1000)" << std::endl;
+        std::cout << "  --samples <n>    采样的c个数 (默认: 10000000)" << std::endl;
+        std::cout << "  --min-iter <n>   只累加迭代次数不少于n的轨道 (默认: 20)" << std::endl;
+        std::cout << "  --iter <n>       最大迭代次数 (默认: 5000)" << std::endl;
+        std::cout << "  --anti           anti-Buddhabrot: 累加不逃逸的轨道" << std::endl;
+        std::cout << "  --uniform        均匀采样 (默认按粗逃逸时间图重要性采样)" << std::endl;
+        std::cout << "  --seed <n>       随机数种子 (默认: 1)" << std::endl;
+        std::cout << "  --threads <n>    线程数 (默认: 自动检测)" << std::endl;
+        std::cout << "  --gamma <g>      色调映射的亮度指数 (默认: 0.5)" << std::endl;
+        std::cout << "  --output <file>  输出文件 (默认: output/buddhabrot.ppm)" << std::endl;
+        std::cout << "  --trace <file>   输出Chrome trace-event时间线 (各阶段与每批采样)" << std::endl;
+        std::cout << "  --help           显示此帮助信息" << std::endl;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BuddhabrotParams params;
+    double gamma = 0.5;
+    std::string output_file = "output/buddhabrot.ppm";
+    std::string trace_file;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "--width" && i + 1 < argc) {
+            params.width = std::atoi(argv[++i]);
+        } else if (arg == "--height" && i + 1 < argc) {
+            params.height = std::atoi(argv[++i]);
+        } else if (arg == "--samples" && i + 1 < argc) {
+            params.samples = std::atoll(argv[++i]);
+        } else if (arg == "--min-iter" && i + 1 < argc) {
+            params.min_iter = std::atoi(argv[++i]);
+        } else if (arg == "--iter" && i + 1 < argc) {
+            params.max_iter = std::atoi(argv[++i]);
+        } else if (arg == "--anti") {
+            params.anti = true;
+        } else if (arg == "--uniform") {
+            params.sampling = BuddhabrotSampling::Uniform;
+        } else if (arg == "--seed" && i + 1 < argc) {
+            params.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            params.num_threads = std::atoi(argv[++i]);
+        } else if (arg == "--gamma" && i + 1 < argc) {
+            gamma = std::atof(argv[++i]);
+        } else if (arg == "--output" && i + 1 < argc) {
+            output_file = argv[++i];
+        } else if (arg == "--trace" && i + 1 < argc) {
+            trace_file = argv[++i];
+        } else {
+            std::cerr << "错误: 未知参数 " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (params.width < 2 || params.height < 2 || params.samples <= 0 || params.max_iter <= 0) {
+        std::cerr << "错误: 图像尺寸至少为2x2, 采样数与最大迭代次数必须为正数" << std::endl;
+        return 1;
+    }
+    if (!params.anti && (params.min_iter < 0 || params.min_iter >= params.max_iter)) {
+        std::cerr << "错误: --min-iter 必须在 [0, --iter) 范围内" << std::endl;
+        return 1;
+    }
+    if (gamma <= 0.0) {
+        std::cerr << "错误: --gamma 必须为正数" << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<MandelbrotCPU::TraceRecorder> trace;
+    if (!trace_file.empty()) {
+        trace = std::make_unique<MandelbrotCPU::TraceRecorder>("buddhabrot_test");
+        params.trace = trace.get();
+    }
+
+    std::cout << "\n=== " << (params.anti ? "anti-Buddhabrot" : "Buddhabrot") << " 轨道密度渲染 ===" << std::endl;
+    std::cout << "图像: " << params.width << "x" << params.height
+              << ", 样本: " << params.samples
+              << ", 迭代: " << (params.anti ? params.max_iter : params.min_iter) << ".." << params.max_iter
+              << ", 采样: " << (params.sampling == BuddhabrotSampling::Importance ? "重要性" : "均匀") << std::endl;
+
+    auto start_time = std::chrono::steady_clock::now();  // 单调时钟, 与时间线追踪共用时间基准
+    BuddhabrotImage image = render_buddhabrot_omp(params);
+    MandelbrotCPU::ImageBuffer rgb = buddhabrot_to_rgb(image, gamma);
+    auto render_time = std::chrono::steady_clock::now();
+
+    MandelbrotCPU::save_ppm(output_file, rgb, image.width, image.height);
+    auto save_time = std::chrono::steady_clock::now();
+
+    const BuddhabrotStats& stats = image.stats;
+    const double total_seconds = std::chrono::duration<double>(render_time - start_time).count();
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "⏱️  总耗时: " << total_seconds << "s (重要性图 " << stats.map_seconds
+              << "s, 采样 " << stats.sample_seconds << "s, 归约 " << stats.merge_seconds << "s)" << std::endl;
+    std::cout << std::setprecision(2);
+    std::cout << "🎲 采样吞吐: " << (stats.sample_seconds > 0.0 ? stats.samples / stats.sample_seconds / 1e6 : 0.0)
+              << " M样本/s, 累加轨道点 " << stats.orbit_points
+              << ", 总迭代 " << stats.iterations << std::endl;
+    std::cout << "🎯 接受率: " << stats.acceptance() * 100.0 << "% (" << stats.accepted << "/" << stats.samples << ")";
+    if (stats.uniform_acceptance > 0.0) {
+        std::cout << ", 均匀采样估计 " << stats.uniform_acceptance * 100.0 << "%"
+                  << ", 提升 " << stats.acceptance() / stats.uniform_acceptance << "x";
+    }
+    std::cout << std::endl;
+
+    if (trace) {
+        trace->add(MandelbrotCPU::TraceRecorder::kMainThread, "render", "compute", start_time, render_time);
+        trace->add(MandelbrotCPU::TraceRecorder::kMainThread, "write_ppm", "io", render_time, save_time);
+        if (trace->write(trace_file)) {
+            std::cout << "🧭 时间线已保存: " << trace_file << " (" << trace->event_count() << " 个区间)" << std::endl;
+        } else {
+            std::cerr << "[ERROR] 无法写入时间线文件: " << trace_file << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+/**
+ * 缓冲区池实现
+ *
+ * 作者: Geoffrey Wang (with Claude AI assistance)
+ * 日期: 2025-08-12
+ */
+
+#include "../include/buffer_pool.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace MandelbrotCPU {
+
+    BufferPool& BufferPool::global() {
+        static BufferPool* pool = new BufferPool();
+        return *pool;
+    }
+
+    size_t BufferPool::size_class(size_t bytes) {
+        if (bytes <= MIN_POOLED_BYTES) return MIN_POOLED_BYTES;
+
+        // 2^k 到 2^(k+1) 之间等分为4级; 不小于8MB时每级步长本身就是2MB的整数倍
+        size_t power = MIN_POOLED_BYTES;
+        while (power * 2 < bytes) power *= 2;
+        const size_t step = power / 4;
+        return (bytes + step - 1) / step * step;
+    }
+
+    void* BufferPool::allocate_block(size_t bytes) const {
+        const bool huge = huge_pages_ && bytes >= HUGE_PAGE_BYTES;
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, huge ? HUGE_PAGE_BYTES : 64, bytes) != 0) {
+            throw std::bad_alloc();
+        }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if (huge) {
+            madvise(ptr, bytes, MADV_HUGEPAGE);
+        }
+#endif
+        return ptr;
+    }
+
+    void* BufferPool::acquire(size_t bytes) {
+        const size_t block_bytes = size_class(bytes);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = std::find_if(free_blocks_.begin(), free_blocks_.end(),
+                                   [block_bytes](const Block& block) { return block.bytes == block_bytes; });
+            if (it != free_blocks_.end()) {
+                void* ptr = it->ptr;
+                *it = free_blocks_.back();
+                free_blocks_.pop_back();
+
+                ++stats_.hits;
+                stats_.cached_bytes -= block_bytes;
+                stats_.outstanding_bytes += block_bytes;
+                stats_.peak_outstanding_bytes = std::max(stats_.peak_outstanding_bytes, stats_.outstanding_bytes);
+                return ptr;
+            }
+            ++stats_.misses;
+            stats_.allocated_bytes += block_bytes;
+            stats_.outstanding_bytes += block_bytes;
+            stats_.peak_outstanding_bytes = std::max(stats_.peak_outstanding_bytes, stats_.outstanding_bytes);
+        }
+
+        // 向系统申请时不持有锁
+        try {
+            return allocate_block(block_bytes);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.outstanding_bytes -= block_bytes;
+            throw;
+        }
+    }
+
+    void BufferPool::release(void* ptr, size_t bytes) {
+        if (!ptr) return;
+        const size_t block_bytes = size_class(bytes);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.outstanding_bytes -= block_bytes;
+            if (stats_.cached_bytes + block_bytes <= capacity_) {
+                free_blocks_.push_back({ptr, block_bytes});
+                stats_.cached_bytes += block_bytes;
+                return;
+            }
+        }
+        std::free(ptr);
+    }
+
+    void BufferPool::set_capacity(size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        capacity_ = bytes;
+        trim_to(capacity_);
+    }
+
+    void BufferPool::set_huge_pages(bool enabled) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        huge_pages_ = enabled;
+    }
+
+    void BufferPool::trim() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        trim_to(0);
+    }
+
+    void BufferPool::trim_to(size_t capacity) {
+        // 优先释放最大的空闲块
+        std::sort(free_blocks_.begin(), free_blocks_.end(),
+                  [](const Block& a, const Block& b) { return a.bytes < b.bytes; });
+        while (!free_blocks_.empty() && stats_.cached_bytes > capacity) {
+            stats_.cached_bytes -= free_blocks_.back().bytes;
+            std::free(free_blocks_.back().ptr);
+            free_blocks_.pop_back();
+        }
+    }
+
+    std::string BufferPool::transparent_huge_page_mode() {
+        // 格式: "always [madvise] never", 方括号内为当前模式
+        std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+        std::string line;
+        std::getline(file, line);
+        const size_t open = line.find('[');
+        const size_t close = line.find(']', open);
+        if (open == std::string::npos || close == std::string::npos) return "";
+        return line.substr(open + 1, close - open - 1);
+    }
+
+    BufferPool::Stats BufferPool::stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+} // namespace MandelbrotCPU
@@ -10,7 +10,7 @@ BurningShipCPU::BurningShipCPU(int width, int height, int max_iterations)
     fractal_data_.resize(height_, std::vector<int>(width_, 0));
 }
 
-void BurningShipCPU::render(double center_x, double center_y, double zoom) {
+double BurningShipCPU::render(double center_x, double center_y, double zoom) {
     auto start_time = std::chrono::high_resolution_clock::now();
     
     // Calculate the complex plane bounds
@@ -19,6 +19,7 @@ void BurningShipCPU::render(double center_x, double center_y, double zoom) {
     double max_x = center_x + scale / 2.0;
     double min_y = center_y - scale / 2.0;
     double max_y = center_y + scale / 2.0;
+    counters_ = MandelbrotCPU::RenderCounters();
     
     // Render each pixel
     for (int y = 0; y < height_; ++y) {
@@ -29,6 +30,7 @@ void BurningShipCPU::render(double center_x, double center_y, double zoom) {
             
             // Compute Burning Ship iterations for this point
             fractal_data_[y][x] = computeBurningShip(cx, cy);
+            counters_.add_escape_time(fractal_data_[y][x], max_iterations_);
         }
     }
     
@@ -40,13 +42,16 @@ void BurningShipCPU::render(double center_x, double center_y, double zoom) {
     std::cout << "分辨率: " << width_ << "x" << height_ << std::endl;
     std::cout << "渲染时间: " << duration.count() << " ms" << std::endl;
     std::cout << "性能: " << (width_ * height_) / (duration.count() / 1000.0) << " 像素/秒" << std::endl;
+    
+    return duration.count();
 }
 
-void BurningShipCPU::renderToFile(const std::string& filename, double center_x, 
+double BurningShipCPU::renderToFile(const std::string& filename, double center_x, 
                                  double center_y, double zoom) {
-    render(center_x, center_y, zoom);
+    double elapsed_ms = render(center_x, center_y, zoom);
     saveAsPPM(filename);
     std::cout << "输出文件: " << filename << std::endl;
+    return elapsed_ms;
 }
 
 int BurningShipCPU::computeBurningShip(double cx, double cy) const {
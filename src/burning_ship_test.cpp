@@ -1,25 +1,44 @@
 #include "burning_ship.hpp"
 #include <iostream>
+#include <string>
 
-int main() {
+int main(int argc, char* argv[]) {
+    // --stats: 每次渲染后在stderr输出热路径计数 (JSON)
+    bool print_stats = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--stats") {
+            print_stats = true;
+        } else {
+            std::cerr << "用法: " << argv[0] << " [--stats]" << std::endl;
+            return 1;
+        }
+    }
+    
     std::cout << "\n=== 渲染 Burning Ship Fractal ===" << std::endl;
     
     // Create Burning Ship renderer
     BurningShipCPU renderer(800, 600, 1000);
     
     // Render classic view
-    renderer.renderToFile("burning_ship_classic.ppm", 
-                         BurningShipPresets::CLASSIC_X, 
-                         BurningShipPresets::CLASSIC_Y, 
-                         BurningShipPresets::CLASSIC_ZOOM);
+    double elapsed_ms = renderer.renderToFile("burning_ship_classic.ppm", 
+                                              BurningShipPresets::CLASSIC_X, 
+                                              BurningShipPresets::CLASSIC_Y, 
+                                              BurningShipPresets::CLASSIC_ZOOM);
+    if (print_stats) {
+        std::cerr << renderer.getCounters().to_json("burning_ship", elapsed_ms / 1000.0) << std::endl;
+    }
     
     std::cout << "\n=== 渲染 Ship Detail View ===" << std::endl;
     
     // Render detailed ship view
-    renderer.renderToFile("burning_ship_detail.ppm", 
-                         BurningShipPresets::SHIP_DETAIL_X, 
-                         BurningShipPresets::SHIP_DETAIL_Y, 
-                         BurningShipPresets::SHIP_DETAIL_ZOOM);
+    elapsed_ms = renderer.renderToFile("burning_ship_detail.ppm", 
+                                       BurningShipPresets::SHIP_DETAIL_X, 
+                                       BurningShipPresets::SHIP_DETAIL_Y, 
+                                       BurningShipPresets::SHIP_DETAIL_ZOOM);
+    if (print_stats) {
+        std::cerr << renderer.getCounters().to_json("burning_ship", elapsed_ms / 1000.0) << std::endl;
+    }
     
     std::cout << "\n🔥 Burning Ship Fractal 演示完成！" << std::endl;
     std::cout << "📁 生成的文件:" << std::endl;
@@ -0,0 +1,176 @@
+/**
+ * 代价图探测与代价均衡划分实现
+ *
+ * 作者: Geoffrey Wang (with Claude AI assistance)
+ * 日期: 2025-08-12
+ */
+
+#include "../include/cost_map.hpp"
+#include "../include/render_omp.hpp"
+#include "../include/render_pool.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace MandelbrotOMP {
+
+    namespace {
+
+        // 单像素的固定开销 (着色与写回), 使全外部区域的代价不为零
+        const double PIXEL_OVERHEAD = 4.0;
+
+        double sample_cost(const MandelbrotCPU::RenderParams& params, int x, int y) {
+            const double real = params.x_min + x * (params.x_max - params.x_min) / (params.width - 1);
+            const double imag = params.y_min + y * (params.y_max - params.y_min) / (params.height - 1);
+            return mandelbrot_iterations_omp(real, imag, params.max_iter) + PIXEL_OVERHEAD;
+        }
+
+    } // namespace
+
+    double CostMap::total() const {
+        double sum = 0.0;
+        for (double cost : tile_costs) sum += cost;
+        return sum;
+    }
+
+    std::vector<double> CostMap::row_costs() const {
+        std::vector<double> rows(tiles_y, 0.0);
+        for (int ty = 0; ty < tiles_y; ++ty) {
+            for (int tx = 0; tx < tiles_x; ++tx) {
+                rows[ty] += tile_costs[static_cast<size_t>(ty) * tiles_x + tx];
+            }
+        }
+        return rows;
+    }
+
+    CostMap estimate_tile_costs(const MandelbrotCPU::RenderParams& params, int tile_size, int probe_scale) {
+        CostMap map;
+        tile_size = std::max(1, tile_size);
+        probe_scale = std::max(1, probe_scale);
+
+        map.tile_size = tile_size;
+        map.tiles_x = (params.width + tile_size - 1) / tile_size;
+        map.tiles_y = (params.height + tile_size - 1) / tile_size;
+        map.probe_width = (params.width + probe_scale - 1) / probe_scale;
+        map.probe_height = (params.height + probe_scale - 1) / probe_scale;
+
+        const int num_tiles = map.tiles_x * map.tiles_y;
+        if (num_tiles == 0) return map;
+
+        // 探测图: 每行独立汇总到所在分块行, 无需同步
+        std::vector<double> sums(num_tiles, 0.0);
+        std::vector<int> samples(num_tiles, 0);
+
+        RenderPool::global().parallel_for(map.tiles_y, [&](int ty) {
+            const int row_begin = ty * tile_size;
+            const int row_end = std::min(params.height, row_begin + tile_size);
+
+            for (int py = 0; py < map.probe_height; ++py) {
+                const int y = std::min(params.height - 1, py * probe_scale + probe_scale / 2);
+                if (y < row_begin || y >= row_end) continue;
+
+                for (int px = 0; px < map.probe_width; ++px) {
+                    const int x = std::min(params.width - 1, px * probe_scale + probe_scale / 2);
+                    const int index = ty * map.tiles_x + x / tile_size;
+                    sums[index] += sample_cost(params, x, y);
+                    ++samples[index];
+                }
+            }
+        });
+
+        // 平均代价 x 分块像素数; 无探测点的分块采样中心
+        map.tile_costs.resize(num_tiles);
+        for (int index = 0; index < num_tiles; ++index) {
+            const int x0 = (index % map.tiles_x) * tile_size;
+            const int y0 = (index / map.tiles_x) * tile_size;
+            const int width = std::min(tile_size, params.width - x0);
+            const int height = std::min(tile_size, params.height - y0);
+
+            const double mean = samples[index] > 0
+                ? sums[index] / samples[index]
+                : sample_cost(params, x0 + width / 2, y0 + height / 2);
+            map.tile_costs[index] = mean * width * height;
+        }
+
+        return map;
+    }
+
+    CostMap cost_map_from_iterations(const std::vector<int>& iterations, int width, int height, int tile_size) {
+        CostMap map;
+        map.tile_size = std::max(1, tile_size);
+        map.tiles_x = (width + map.tile_size - 1) / map.tile_size;
+        map.tiles_y = (height + map.tile_size - 1) / map.tile_size;
+        map.probe_width = width;
+        map.probe_height = height;
+        map.tile_costs.assign(static_cast<size_t>(map.tiles_x) * map.tiles_y, 0.0);
+
+        for (int y = 0; y < height; ++y) {
+            const int* row = iterations.data() + static_cast<size_t>(y) * width;
+            double* tile_row = map.tile_costs.data() + static_cast<size_t>(y / map.tile_size) * map.tiles_x;
+            for (int x = 0; x < width; ++x) {
+                tile_row[x / map.tile_size] += row[x] + PIXEL_OVERHEAD;
+            }
+        }
+
+        return map;
+    }
+
+    CostMapAccuracy compare_cost_maps(const CostMap& predicted, const CostMap& measured) {
+        CostMapAccuracy accuracy;
+        const size_t n = std::min(predicted.tile_costs.size(), measured.tile_costs.size());
+        if (n == 0) return accuracy;
+
+        const double mean_p = predicted.total() / predicted.tile_costs.size();
+        const double mean_m = measured.total() / measured.tile_costs.size();
+        double cov = 0.0, var_p = 0.0, var_m = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            const double dp = predicted.tile_costs[i] - mean_p;
+            const double dm = measured.tile_costs[i] - mean_m;
+            cov += dp * dm;
+            var_p += dp * dp;
+            var_m += dm * dm;
+        }
+        accuracy.correlation = (var_p > 0.0 && var_m > 0.0) ? cov / std::sqrt(var_p * var_m) : 1.0;
+        accuracy.total_ratio = measured.total() > 0.0 ? predicted.total() / measured.total() : 0.0;
+
+        return accuracy;
+    }
+
+    CostPartition partition_by_cost(const std::vector<int>& ordered_tiles,
+                                    const std::vector<double>& tile_costs,
+                                    int num_parts, double remainder_fraction) {
+        CostPartition partition;
+        num_parts = std::max(1, num_parts);
+        remainder_fraction = std::min(std::max(remainder_fraction, 0.0), 0.99);
+        partition.chunks.resize(num_parts);
+
+        double total = 0.0;
+        for (int index : ordered_tiles) total += tile_costs[index];
+        const double target = total * (1.0 - remainder_fraction) / num_parts;
+
+        // 切点: 前缀和越过第k个目标时, 取离目标更近的一侧
+        double prefix = 0.0;
+        size_t position = 0;
+        for (int part = 0; part < num_parts; ++part) {
+            const double boundary = target * (part + 1);
+            while (position < ordered_tiles.size()) {
+                const double cost = tile_costs[ordered_tiles[position]];
+                if (prefix + cost > boundary && boundary - prefix < prefix + cost - boundary) break;
+                partition.chunks[part].push_back(ordered_tiles[position]);
+                prefix += cost;
+                ++position;
+                if (prefix >= boundary) break;
+            }
+        }
+        partition.remainder.assign(ordered_tiles.begin() + position, ordered_tiles.end());
+
+        for (const auto& chunk : partition.chunks) {
+            double cost = 0.0;
+            for (int index : chunk) cost += tile_costs[index];
+            partition.max_chunk_cost = std::max(partition.max_chunk_cost, cost);
+            partition.mean_chunk_cost += cost / num_parts;
+        }
+
+        return partition;
+    }
+
+} // namespace MandelbrotOMP
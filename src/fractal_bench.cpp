@@ -0,0 +1,575 @@
+/**
+ * 分形迭代内核微基准测试
+ *
+ * 在固定点集上逐个测量各迭代内核 (标量 / std::complex / SIMD 以及
+ * render_api.cpp 的全部公式、Julia/Burning Ship/Newton 渲染器类的内核),
+ * 报告迭代总数、每次迭代纳秒数、每秒迭代数以及多次重复的波动。
+ *
+ * 像素每秒与视图强相关 (内部点多的视图天然更慢), 无法在不同视图之间比较;
+ * 每次迭代耗时只取决于内核本身, 适合用来评判内核级优化。
+ *
+ * 点集为固定视图上的规则网格 (坐标映射与 render_api.cpp 一致), 迭代总数是确定值:
+ * - 同一内核多次重复的迭代总数必须完全相同, 否则视为错误 (退出码1)
+ * - 同组内核 (同一公式的不同实现) 与组内第一个内核比较, 逃逸判定边界不同时会有差异
+ * - 迭代总数只计实际执行的迭代: mandelbrot/api 被心形/周期2球判定跳过的点计0次,
+ *   跳过的点数单独报告; 与组内参考比较时每个跳过点按max_iter折算
+ *
+ * 硬件计数器 (Linux perf_event_open, 可用时): 每次计时运行同时统计周期、指令、
+ * 分支未命中与缓存未命中, 报告 IPC 和每次迭代的未命中数。IPC高而周期/迭代仍高说明
+ * 受执行端口限制 (适合SIMD), IPC低且缓存未命中多说明受内存限制, IPC低而未命中少
+ * 则是依赖链延迟 (适合多路交错)。计数器不可用时自动退回只报告计时。
+ *
+ * 使用示例:
+ * ./fractal_bench --points 256 --repeat 9 --json output/bench.json
+ * ./fractal_bench --filter mandelbrot
+ */
+
+#include "../include/fractal_kernels.hpp"
+#include "../include/render.hpp"
+#include "../include/render_omp.hpp"
+#include "../include/julia.hpp"
+#include "../include/burning_ship.hpp"
+#include "../include/newton_fractal.hpp"
+#include "../include/perf_counters.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    /**
+     * 固定点集: 视图中心附近 n x n 规则网格
+     */
+    struct PointSet {
+        std::string view;
+        int n = 0;
+        int max_iter = 0;
+        std::vector<double> real;
+        std::vector<double> imag;
+    };
+
+    PointSet make_points(const std::string& view, double center_x, double center_y,
+                         double zoom, int n, int max_iter) {
+        PointSet points;
+        points.view = view;
+        points.n = n;
+        points.max_iter = max_iter;
+        points.real.resize(static_cast<size_t>(n) * n);
+        points.imag.resize(static_cast<size_t>(n) * n);
+
+        const double scale = 4.0 / zoom;
+        const double start_x = center_x - scale / 2.0;
+        const double start_y = center_y - scale / 2.0;
+        const double step = scale / n;
+        for (int y = 0; y < n; ++y) {
+            for (int x = 0; x < n; ++x) {
+                points.real[static_cast<size_t>(y) * n + x] = start_x + x * step;
+                points.imag[static_cast<size_t>(y) * n + x] = start_y + y * step;
+            }
+        }
+        return points;
+    }
+
+    /**
+     * 待测内核: 对点集逐点迭代, 返回迭代总数
+     */
+    struct KernelCase {
+        std::string name;   // 内核名 (组/实现)
+        std::string group;  // 同一公式的实现属于同一组
+        int view;           // 点集下标
+        std::function<uint64_t(const PointSet&)> run;
+        std::function<uint64_t(const PointSet&)> skips;   // 跳过判定命中的点数 (不计时; 空=无跳过判定)
+    };
+
+    struct KernelResult {
+        std::string name;
+        std::string view;
+        uint64_t iterations = 0;            // 实际执行的迭代次数
+        uint64_t skipped_points = 0;        // 跳过判定命中、未执行迭代的点数
+        int max_iter = 0;
+        bool deterministic = true;
+        bool matches_group = true;
+        double mean_ns = 0.0;
+        double stddev_ns = 0.0;
+        double min_ns = 0.0;
+        double max_ns = 0.0;
+        MandelbrotCPU::PerfSample perf;     // 全部计时运行的硬件计数之和
+        int perf_runs = 0;
+
+        // 每次迭代的硬件事件数 (事件不可用时为0)
+        double perf_per_iter(MandelbrotCPU::PerfSample::Event event) const {
+            return perf.has(event) && iterations && perf_runs
+                ? perf.get(event) / (static_cast<double>(iterations) * perf_runs) : 0.0;
+        }
+
+        // 跳过点按max_iter折算后的迭代总数 (与不带跳过判定的同组内核可比)
+        uint64_t credited_iterations() const { return iterations + skipped_points * static_cast<uint64_t>(max_iter); }
+
+        double cv() const { return mean_ns > 0.0 ? stddev_ns / mean_ns : 0.0; }
+        double ns_per_iter() const { return iterations ? mean_ns / iterations : 0.0; }
+        double min_ns_per_iter() const { return iterations ? min_ns / iterations : 0.0; }
+        double iters_per_second() const { return mean_ns > 0.0 ? iterations * 1e9 / mean_ns : 0.0; }
+    };
+
+    // 防止编译器把未使用的迭代结果整体消除
+    volatile uint64_t g_sink = 0;
+
+    template <typename Kernel>
+    uint64_t sum_points(const PointSet& points, Kernel kernel) {
+        uint64_t total = 0;
+        const size_t count = points.real.size();
+        for (size_t i = 0; i < count; ++i) {
+            total += static_cast<uint64_t>(kernel(points.real[i], points.imag[i]));
+        }
+        return total;
+    }
+
+    // render_api.cpp 的Newton内核返回 (根编号 * 1000 + 迭代下标), 未收敛返回0
+    int api_newton_iterations(double real, double imag, int max_iter) {
+        const int code = newtonIterations(real, imag, max_iter);
+        return code ? code % 1000 + 1 : max_iter;
+    }
+
+    constexpr double JULIA_C_REAL = -0.7269;
+    constexpr double JULIA_C_IMAG = 0.1889;
+    constexpr double PHOENIX_P_REAL = 0.5667;
+    constexpr double PHOENIX_P_IMAG = -0.5;
+
+    enum ViewIndex { VIEW_MANDELBROT, VIEW_JULIA, VIEW_BURNING_SHIP, VIEW_NEWTON, VIEW_TRICORN, VIEW_PHOENIX };
+
+    std::vector<PointSet> make_views(int n) {
+        // 与 render_api.cpp 各公式的默认视图一致
+        return {
+            make_points("mandelbrot", -0.5, 0.0, 1.0, n, 1000),
+            make_points("julia", 0.0, 0.0, 1.0, n, 1000),
+            make_points("burning_ship", -0.5, -0.5, 1.0, n, 1000),
+            make_points("newton", 0.0, 0.0, 1.0, n, 200),
+            make_points("tricorn", -0.3, 0.0, 1.0, n, 1000),
+            make_points("phoenix", 0.0, 0.0, 1.0, n, 1000),
+        };
+    }
+
+    std::vector<KernelCase> make_kernels() {
+        std::vector<KernelCase> kernels;
+
+        kernels.push_back({"mandelbrot/scalar", "mandelbrot", VIEW_MANDELBROT, [](const PointSet& p) {
+            return sum_points(p, [&p](double re, double im) {
+                return MandelbrotOMP::mandelbrot_iterations_omp(re, im, p.max_iter);
+            });
+        }});
+        kernels.push_back({"mandelbrot/std_complex", "mandelbrot", VIEW_MANDELBROT, [](const PointSet& p) {
+            return sum_points(p, [&p](double re, double im) {
+                return MandelbrotCPU::mandelbrot_iterations(re, im, p.max_iter);
+            });
+        }});
+        kernels.push_back({"mandelbrot/simd4", "mandelbrot", VIEW_MANDELBROT, [](const PointSet& p) {
+            uint64_t total = 0;
+            const size_t count = p.real.size();
+            size_t i = 0;
+            int out[4];
+            for (; i + 4 <= count; i += 4) {
+                mandelbrotIterations4(&p.real[i], &p.imag[i], p.max_iter, out);
+                total += static_cast<uint64_t>(out[0]) + out[1] + out[2] + out[3];
+            }
+            for (; i < count; ++i) {
+                total += MandelbrotOMP::mandelbrot_iterations_omp(p.real[i], p.imag[i], p.max_iter);
+            }
+            return total;
+        }});
+        // 与 mandelbrotIterations 相同的路径, 但跳过的点计0次迭代, 使 ns/迭代 与其他内核可比
+        kernels.push_back({"mandelbrot/api", "mandelbrot", VIEW_MANDELBROT, [](const PointSet& p) {
+            return sum_points(p, [&p](double re, double im) {
+                if (mandelbrotShortcut(re, im) != NoShortcut) return 0;
+                return mandelbrotEscapeIterations(re, im, p.max_iter);
+            });
+        }, [](const PointSet& p) {
+            return sum_points(p, [](double re, double im) { return mandelbrotShortcut(re, im) != NoShortcut ? 1 : 0; });
+        }});
+
+        kernels.push_back({"julia/api", "julia", VIEW_JULIA, [](const PointSet& p) {
+            return sum_points(p, [&p](double re, double im) {
+                return juliaIterations(re, im, JULIA_C_REAL, JULIA_C_IMAG, p.max_iter);
+            });
+        }});
+        kernels.push_back({"julia/class", "julia", VIEW_JULIA, [](const PointSet& p) {
+            return sum_points(p, [&p](double re, double im) {
+                return fractal::JuliaRenderer::julia_iterations(re, im, JULIA_C_REAL, JULIA_C_IMAG, p.max_iter);
+            });
+        }});
+
+        kernels.push_back({"burning_ship/api", "burning_ship", VIEW_BURNING_SHIP, [](const PointSet& p) {
+            return sum_points(p, [&p](double re, double im) { return burningShipIterations(re, im, p.max_iter); });
+        }});
+        kernels.push_back({"burning_ship/class", "burning_ship", VIEW_BURNING_SHIP, [](const PointSet& p) {
+            const BurningShipCPU ship(1, 1, p.max_iter);
+            return sum_points(p, [&ship](double re, double im) { return ship.computeBurningShip(re, im); });
+        }});
+
+        kernels.push_back({"newton/api", "newton", VIEW_NEWTON, [](const PointSet& p) {
+            return sum_points(p, [&p](double re, double im) { return api_newton_iterations(re, im, p.max_iter); });
+        }});
+        kernels.push_back({"newton/class", "newton", VIEW_NEWTON, [](const PointSet& p) {
+            const NewtonFractalCPU newton(1, 1, p.max_iter);
+            return sum_points(p, [&newton](double re, double im) { return newton.computeNewton(re, im); });
+        }});
+
+        kernels.push_back({"tricorn/api", "tricorn", VIEW_TRICORN, [](const PointSet& p) {
+            return sum_points(p, [&p](double re, double im) { return tricornIterations(re, im, p.max_iter); });
+        }});
+        kernels.push_back({"phoenix/api", "phoenix", VIEW_PHOENIX, [](const PointSet& p) {
+            return sum_points(p, [&p](double re, double im) {
+                return phoenixIterations(re, im, PHOENIX_P_REAL, PHOENIX_P_IMAG, p.max_iter);
+            });
+        }});
+
+        return kernels;
+    }
+
+    KernelResult run_kernel(const KernelCase& kernel, const PointSet& points, int warmup, int repeat,
+                            MandelbrotCPU::PerfCounters* perf) {
+        KernelResult result;
+        result.name = kernel.name;
+        result.view = points.view;
+        result.max_iter = points.max_iter;
+        if (kernel.skips) result.skipped_points = kernel.skips(points);
+
+        for (int i = 0; i < warmup; ++i) {
+            g_sink = g_sink + kernel.run(points);
+        }
+
+        std::vector<double> samples;
+        samples.reserve(repeat);
+        for (int i = 0; i < repeat; ++i) {
+            if (perf) perf->start();
+            auto start = std::chrono::steady_clock::now();
+            const uint64_t total = kernel.run(points);
+            auto end = std::chrono::steady_clock::now();
+            if (perf) {
+                result.perf.add(perf->stop());
+                ++result.perf_runs;
+            }
+            g_sink = g_sink + total;
+
+            if (i == 0) result.iterations = total;
+            else if (total != result.iterations) result.deterministic = false;
+            samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        }
+
+        double sum = 0.0;
+        for (double s : samples) sum += s;
+        result.mean_ns = sum / samples.size();
+        double var = 0.0;
+        for (double s : samples) var += (s - result.mean_ns) * (s - result.mean_ns);
+        result.stddev_ns = samples.size() > 1 ? std::sqrt(var / (samples.size() - 1)) : 0.0;
+        result.min_ns = *std::min_element(samples.begin(), samples.end());
+        result.max_ns = *std::max_element(samples.begin(), samples.end());
+        return result;
+    }
+
+    /**
+     * 机器指纹: CPU型号、编译时启用的指令集、硬件线程数
+     * 基线只在指纹相同的机器之间比较
+     */
+    struct MachineInfo {
+        std::string cpu;
+        std::string isa;
+        int threads = 0;
+        std::string compiler;
+    };
+
+    std::string read_cpu_model() {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            // x86: "model name", ARM: "Model" / "Hardware"
+            if (line.rfind("model name", 0) == 0 || line.rfind("Model", 0) == 0 || line.rfind("Hardware", 0) == 0) {
+                size_t colon = line.find(':');
+                if (colon == std::string::npos) continue;
+                size_t begin = line.find_first_not_of(" \t", colon + 1);
+                return begin == std::string::npos ? "unknown" : line.substr(begin);
+            }
+        }
+        return "unknown";
+    }
+
+    std::string compiled_isa() {
+        std::string isa;
+#if defined(__AVX512F__)
+        isa += "avx512f ";
+#endif
+#if defined(__AVX2__)
+        isa += "avx2 ";
+#endif
+#if defined(__FMA__)
+        isa += "fma ";
+#endif
+#if defined(__AVX__)
+        isa += "avx ";
+#endif
+#if defined(__SSE4_2__)
+        isa += "sse4.2 ";
+#endif
+#if defined(__SSE2__)
+        isa += "sse2 ";
+#endif
+#if defined(__ARM_NEON)
+        isa += "neon ";
+#endif
+        if (isa.empty()) return "generic";
+        isa.pop_back();
+        return isa;
+    }
+
+    MachineInfo detect_machine() {
+        MachineInfo info;
+        info.cpu = read_cpu_model();
+        info.isa = compiled_isa();
+        info.threads = static_cast<int>(std::thread::hardware_concurrency());
+#if defined(__VERSION__)
+        info.compiler = __VERSION__;
+#else
+        info.compiler = "unknown";
+#endif
+        return info;
+    }
+
+    // JSON字符串转义 (CPU型号和编译器版本可能含引号或反斜杠)
+    std::string json_escape(const std::string& text) {
+        std::string out;
+        for (char c : text) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out;
+    }
+
+    bool write_json(const std::string& filename, const std::vector<KernelResult>& results,
+                    const MachineInfo& machine, int points, int repeat, int warmup, bool perf_available) {
+        std::ofstream out(filename);
+        if (!out) return false;
+
+        out << std::setprecision(9);
+        out << "{\n";
+        out << "  \"machine\": {\"cpu\": \"" << json_escape(machine.cpu) << "\", \"isa\": \"" << machine.isa
+            << "\", \"threads\": " << machine.threads
+            << ", \"compiler\": \"" << json_escape(machine.compiler) << "\"},\n";
+        out << "  \"points_per_axis\": " << points << ",\n";
+        out << "  \"repeat\": " << repeat << ",\n";
+        out << "  \"warmup\": " << warmup << ",\n";
+        out << "  \"perf_counters\": " << (perf_available ? "true" : "false") << ",\n";
+        out << "  \"kernels\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const KernelResult& r = results[i];
+            out << "    {\"name\": \"" << r.name << "\", \"view\": \"" << r.view << "\""
+                << ", \"iterations\": " << r.iterations
+                << ", \"skipped_points\": " << r.skipped_points
+                << ", \"deterministic\": " << (r.deterministic ? "true" : "false")
+                << ", \"matches_group\": " << (r.matches_group ? "true" : "false")
+                << ", \"mean_ns\": " << r.mean_ns
+                << ", \"stddev_ns\": " << r.stddev_ns
+                << ", \"min_ns\": " << r.min_ns
+                << ", \"max_ns\": " << r.max_ns
+                << ", \"cv\": " << r.cv()
+                << ", \"ns_per_iter\": " << r.ns_per_iter()
+                << ", \"min_ns_per_iter\": " << r.min_ns_per_iter()
+                << ", \"iters_per_second\": " << r.iters_per_second();
+            if (r.perf_runs > 0) {
+                using Event = MandelbrotCPU::PerfSample::Event;
+                out << ", \"perf\": {";
+                const char* separator = "";
+                auto field = [&](Event event, const char* name) {
+                    if (!r.perf.has(event)) return;
+                    out << separator << "\"" << name << "\": " << r.perf_per_iter(event);
+                    separator = ", ";
+                };
+                field(Event::Cycles, "cycles_per_iter");
+                field(Event::Instructions, "instructions_per_iter");
+                field(Event::BranchMisses, "branch_misses_per_iter");
+                field(Event::CacheMisses, "cache_misses_per_iter");
+                if (r.perf.ipc() > 0.0) out << separator << "\"ipc\": " << r.perf.ipc();
+                out << "}";
+            }
+            out << "}"
+                << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n";
+        out << "}\n";
+        return static_cast<bool>(out);
+    }
+
+    void print_usage(const char* program_name) {
+        std::cout << "\n=== 分形迭代内核微基准测试 ===" << std::endl;
+        std::cout << "用法: " << program_name << " [选项]" << std::endl;
+        std::cout << "\n选项:" << std::endl;
+        std::cout << "  --points <n>    每个视图的网格边长 (默认: 128, 即128x128个点)" << std::endl;
+        std::cout << "  --repeat <n>    计时重复次数 (默认: 7)" << std::endl;
+        std::cout << "  --warmup <n>    预热次数 (默认: 1)" << std::endl;
+        std::cout << "  --filter <s>    只运行名称包含s的内核" << std::endl;
+        std::cout << "  --json <file>   将结果写入JSON文件" << std::endl;
+        std::cout << "  --no-counters   不读取硬件性能计数器 (perf_event_open)" << std::endl;
+        std::cout << "  --list          列出全部内核" << std::endl;
+        std::cout << "  --help          显示此帮助信息" << std::endl;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int points = 128;
+    int repeat = 7;
+    int warmup = 1;
+    std::string filter;
+    std::string json_file;
+    bool list_only = false;
+    bool use_counters = true;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "--points" && i + 1 < argc) {
+            points = std::atoi(argv[++i]);
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::atoi(argv[++i]);
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            warmup = std::atoi(argv[++i]);
+        } else if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg == "--json" && i + 1 < argc) {
+            json_file = argv[++i];
+        } else if (arg == "--list") {
+            list_only = true;
+        } else if (arg == "--no-counters") {
+            use_counters = false;
+        } else {
+            std::cerr << "错误: 未知参数 " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (points <= 0 || repeat <= 0 || warmup < 0) {
+        std::cerr << "错误: 点数和重复次数必须为正数" << std::endl;
+        return 1;
+    }
+
+    const std::vector<KernelCase> kernels = make_kernels();
+    if (list_only) {
+        for (const KernelCase& kernel : kernels) std::cout << kernel.name << std::endl;
+        return 0;
+    }
+
+    const std::vector<PointSet> views = make_views(points);
+    const MachineInfo machine = detect_machine();
+
+    std::cout << "=== 分形迭代内核微基准测试 ===" << std::endl;
+    std::cout << "CPU: " << machine.cpu << " (" << machine.threads << " 线程), 指令集: " << machine.isa << std::endl;
+    std::cout << "点集: " << points << "x" << points << " 每视图, 预热 " << warmup
+              << " 次, 计时 " << repeat << " 次" << std::endl;
+
+    std::unique_ptr<MandelbrotCPU::PerfCounters> perf;
+    if (use_counters) {
+        perf = std::make_unique<MandelbrotCPU::PerfCounters>();
+        if (!perf->available()) {
+            std::cout << "硬件计数器不可用: " << perf->unavailable_reason() << " (只报告计时)" << std::endl;
+            perf.reset();
+        } else if (!perf->unavailable_reason().empty()) {
+            std::cout << "部分硬件计数器不可用: " << perf->unavailable_reason() << std::endl;
+        }
+    }
+    std::cout << std::left << std::setw(24) << "内核"
+              << std::right << std::setw(14) << "迭代总数"
+              << std::setw(12) << "ns/迭代"
+              << std::setw(14) << "M迭代/秒"
+              << std::setw(12) << "平均ms"
+              << std::setw(12) << "最小ms"
+              << std::setw(9) << "CV%" << std::endl;
+
+    std::vector<KernelResult> results;
+    std::vector<std::pair<std::string, uint64_t>> group_reference;
+    bool all_deterministic = true;
+
+    for (const KernelCase& kernel : kernels) {
+        if (!filter.empty() && kernel.name.find(filter) == std::string::npos) continue;
+
+        KernelResult result = run_kernel(kernel, views[kernel.view], warmup, repeat, perf.get());
+
+        auto ref = std::find_if(group_reference.begin(), group_reference.end(),
+                                [&kernel](const std::pair<std::string, uint64_t>& g) { return g.first == kernel.group; });
+        if (ref == group_reference.end()) group_reference.emplace_back(kernel.group, result.credited_iterations());
+        else result.matches_group = (ref->second == result.credited_iterations());
+        all_deterministic = all_deterministic && result.deterministic;
+
+        std::cout << std::left << std::setw(24) << result.name
+                  << std::right << std::setw(14) << result.iterations
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(12) << result.ns_per_iter()
+                  << std::setprecision(1)
+                  << std::setw(14) << result.iters_per_second() / 1e6
+                  << std::setprecision(3)
+                  << std::setw(12) << result.mean_ns / 1e6
+                  << std::setw(12) << result.min_ns / 1e6
+                  << std::setprecision(2)
+                  << std::setw(9) << result.cv() * 100.0;
+        if (!result.deterministic) std::cout << "  [错误: 重复运行迭代总数不一致]";
+        else if (!result.matches_group) std::cout << "  [与组内参考迭代总数不同]";
+        if (result.skipped_points) std::cout << "  (跳过判定: " << result.skipped_points << " 点)";
+        std::cout << std::defaultfloat << std::endl;
+
+        results.push_back(result);
+    }
+
+    if (results.empty()) {
+        std::cerr << "错误: 没有匹配的内核: " << filter << std::endl;
+        return 1;
+    }
+
+    if (perf) {
+        using Event = MandelbrotCPU::PerfSample::Event;
+        std::cout << "\n硬件计数 (每次迭代平均):" << std::endl;
+        std::cout << std::left << std::setw(24) << "内核"
+                  << std::right << std::setw(12) << "周期/迭代"
+                  << std::setw(12) << "指令/迭代"
+                  << std::setw(8) << "IPC"
+                  << std::setw(16) << "分支未命中/迭代"
+                  << std::setw(16) << "缓存未命中/迭代" << std::endl;
+
+        // 不可用的事件显示为 "-"
+        auto cell = [](const KernelResult& r, Event event, int width, int precision) {
+            std::ostringstream text;
+            if (r.perf.has(event)) text << std::fixed << std::setprecision(precision) << r.perf_per_iter(event);
+            else text << "-";
+            std::cout << std::setw(width) << text.str();
+        };
+        for (const KernelResult& r : results) {
+            std::cout << std::left << std::setw(24) << r.name << std::right;
+            cell(r, Event::Cycles, 12, 2);
+            cell(r, Event::Instructions, 12, 2);
+            std::cout << std::setw(8) << std::fixed << std::setprecision(2) << r.perf.ipc();
+            cell(r, Event::BranchMisses, 16, 5);
+            cell(r, Event::CacheMisses, 16, 6);
+            std::cout << std::defaultfloat << std::endl;
+        }
+    }
+
+    if (!json_file.empty()) {
+        if (!write_json(json_file, results, machine, points, repeat, warmup, perf != nullptr)) {
+            std::cerr << "错误: 无法写入 " << json_file << std::endl;
+            return 1;
+        }
+        std::cout << "结果已写入: " << json_file << std::endl;
+    }
+
+    return all_deterministic ? 0 : 1;
+}
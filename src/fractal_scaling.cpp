@@ -0,0 +1,428 @@
+/**
+ * 并行渲染线程扩展性基准测试
+ *
+ * 在固定视图集合上以 1..N 个线程运行各并行引擎, 报告:
+ * - 加速比 (同一引擎单线程耗时 / N线程耗时) 与并行效率 (加速比 / N)
+ * - 每线程忙碌时间 (最小/平均/最大) 与负载不均衡度 (最大 / 平均)
+ *
+ * 引擎:
+ * - omp_rows:      OpenMP parallel for, 按行动态调度 (不经过线程池)
+ * - pool_rows:     RenderPool::parallel_for, 按行动态调度
+ * - tiles_row:     render_iterations_omp, 分块调度器 (行优先)
+ * - tiles_hilbert: render_iterations_omp, 分块调度器 (Hilbert顺序)
+ * - tiles_cost:    render_iterations_omp, 代价图划分 + 余量窃取
+ *
+ * 视图:
+ * - classic:        经典全景 (内部与外部各半)
+ * - seahorse:       海马谷 (边界细节丰富, 代价分布不均)
+ * - dense_boundary: 海马谷深处的螺旋 (几乎全部像素贴近边界, 高迭代)
+ * - interior:       主心形内部 (每个像素都跑满max_iter, 代价完全均匀)
+ *
+ * 使用示例:
+ * ./fractal_scaling --threads 1,2,4,8 --csv output/scaling.csv --json output/scaling.json
+ * ./fractal_scaling --engine tiles_cost --view seahorse
+ */
+
+#include "../include/buffer_pool.hpp"
+#include "../include/render_omp.hpp"
+#include "../include/render_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace MandelbrotOMP;
+
+namespace {
+
+    struct View {
+        std::string name;
+        double center_x;
+        double center_y;
+        double span_x;      // 复平面X跨度 (Y跨度按图像宽高比)
+        int max_iter;
+    };
+
+    const std::vector<View> VIEWS = {
+        {"classic", -0.5, 0.0, 3.0, 1000},
+        {"seahorse", -0.7453, 0.1127, 0.03, 2000},
+        {"dense_boundary", -0.743643887, 0.131825904, 0.0001, 3000},
+        {"interior", -0.15, 0.0, 0.3, 1000},
+    };
+
+    RenderParams make_params(const View& view, int width, int height) {
+        const double span_y = view.span_x * height / width;
+        return RenderParams(width, height, view.max_iter,
+                            view.center_x - view.span_x / 2, view.center_x + view.span_x / 2,
+                            view.center_y - span_y / 2, view.center_y + span_y / 2);
+    }
+
+    /**
+     * 单次运行结果
+     */
+    struct RunResult {
+        double seconds = 0.0;
+        std::vector<double> busy_seconds;   // 每线程忙碌时间
+        long long steals = 0;
+        long long checksum = 0;             // 迭代总数, 所有引擎和线程数下必须一致
+    };
+
+    using Engine = std::function<RunResult(const RenderParams&, int)>;
+
+    // 每线程计时槽 (独占缓存行, 避免计时本身引入伪共享)
+    struct alignas(64) BusySlot {
+        double seconds = 0.0;
+    };
+
+    // 按行动态调度时, 每行渲染到行优先缓冲区并计入当前线程的忙碌时间
+    void render_row(const RenderParams& params, int y, int* row) {
+        const double x_scale = (params.x_max - params.x_min) / (params.width - 1);
+        const double y_scale = (params.y_max - params.y_min) / (params.height - 1);
+        const double imag = params.y_min + y * y_scale;
+        for (int x = 0; x < params.width; ++x) {
+            row[x] = mandelbrot_iterations_omp(params.x_min + x * x_scale, imag, params.max_iter);
+        }
+    }
+
+    long long sum_iterations(const std::vector<int>& data) {
+        long long total = 0;
+        for (int v : data) total += v;
+        return total;
+    }
+
+    RunResult run_omp_rows(const RenderParams& params, int threads) {
+        RunResult result;
+        std::vector<int> data(static_cast<size_t>(params.width) * params.height);
+        std::vector<BusySlot> busy(threads);
+
+        auto start = std::chrono::steady_clock::now();
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(threads)
+        for (int y = 0; y < params.height; ++y) {
+            auto row_start = std::chrono::steady_clock::now();
+            render_row(params, y, data.data() + static_cast<size_t>(y) * params.width);
+            busy[omp_get_thread_num()].seconds +=
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - row_start).count();
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (const BusySlot& slot : busy) result.busy_seconds.push_back(slot.seconds);
+        result.checksum = sum_iterations(data);
+        return result;
+    }
+
+    RunResult run_pool_rows(const RenderParams& params, int threads) {
+        RenderPool& pool = RenderPool::global();
+        pool.configure(threads);
+
+        RunResult result;
+        std::vector<int> data(static_cast<size_t>(params.width) * params.height);
+        std::vector<BusySlot> busy(pool.num_threads());
+
+        auto start = std::chrono::steady_clock::now();
+        pool.parallel_for(params.height, [&](int y) {
+            auto row_start = std::chrono::steady_clock::now();
+            render_row(params, y, data.data() + static_cast<size_t>(y) * params.width);
+            busy[omp_get_thread_num()].seconds +=
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - row_start).count();
+        });
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (const BusySlot& slot : busy) result.busy_seconds.push_back(slot.seconds);
+        result.checksum = sum_iterations(data);
+        return result;
+    }
+
+    Engine make_tile_engine(TileOrder order, bool cost_partition) {
+        return [order, cost_partition](const RenderParams& params, int threads) {
+            RenderStats stats;
+            RenderOptions options;
+            options.num_threads = threads;
+            options.tile_order = order;
+            options.cost_partition = cost_partition;
+            options.stats = &stats;
+
+            auto start = std::chrono::steady_clock::now();
+            IterationField field = render_iterations_omp(params, options);
+            RunResult result;
+            // 代价划分的探测属于引擎开销, 计入总耗时
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            result.busy_seconds = stats.thread_busy_seconds;
+            result.steals = stats.steals;
+            result.checksum = sum_iterations(field.to_row_major());
+            return result;
+        };
+    }
+
+    struct EngineEntry {
+        std::string name;
+        Engine run;
+    };
+
+    std::vector<EngineEntry> make_engines() {
+        return {
+            {"omp_rows", run_omp_rows},
+            {"pool_rows", run_pool_rows},
+            {"tiles_row", make_tile_engine(TileOrder::RowMajor, false)},
+            {"tiles_hilbert", make_tile_engine(TileOrder::Hilbert, false)},
+            {"tiles_cost", make_tile_engine(TileOrder::Hilbert, true)},
+        };
+    }
+
+    /**
+     * 汇总后的一行报告
+     */
+    struct ScalingRow {
+        std::string engine;
+        std::string view;
+        int threads = 0;
+        double seconds = 0.0;
+        double speedup = 0.0;
+        double efficiency = 0.0;
+        double busy_min = 0.0;
+        double busy_mean = 0.0;
+        double busy_max = 0.0;
+        long long steals = 0;
+        long long checksum = 0;
+        std::vector<double> busy_seconds;
+
+        double imbalance() const { return busy_mean > 0.0 ? busy_max / busy_mean : 0.0; }
+    };
+
+    std::vector<int> parse_thread_list(const std::string& text) {
+        std::vector<int> threads;
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            int n = std::atoi(item.c_str());
+            if (n > 0) threads.push_back(n);
+        }
+        return threads;
+    }
+
+    // 默认线程数序列: 1, 2, 4, ... 直到全部可用处理器 (最后一项总是处理器数)
+    std::vector<int> default_thread_list(int max_threads) {
+        std::vector<int> threads;
+        for (int n = 1; n < max_threads; n *= 2) threads.push_back(n);
+        threads.push_back(max_threads);
+        return threads;
+    }
+
+    bool write_csv(const std::string& filename, const std::vector<ScalingRow>& rows) {
+        std::ofstream out(filename);
+        if (!out) return false;
+        out << "engine,view,threads,seconds,speedup,efficiency,busy_min,busy_mean,busy_max,imbalance,steals\n";
+        out << std::setprecision(6);
+        for (const ScalingRow& r : rows) {
+            out << r.engine << "," << r.view << "," << r.threads << "," << r.seconds << ","
+                << r.speedup << "," << r.efficiency << "," << r.busy_min << "," << r.busy_mean << ","
+                << r.busy_max << "," << r.imbalance() << "," << r.steals << "\n";
+        }
+        return static_cast<bool>(out);
+    }
+
+    bool write_json(const std::string& filename, const std::vector<ScalingRow>& rows,
+                    int width, int height, int repeat) {
+        std::ofstream out(filename);
+        if (!out) return false;
+        out << std::setprecision(6);
+        out << "{\n";
+        out << "  \"width\": " << width << ",\n";
+        out << "  \"height\": " << height << ",\n";
+        out << "  \"repeat\": " << repeat << ",\n";
+        out << "  \"processors\": " << get_optimal_thread_count() << ",\n";
+        out << "  \"runs\": [\n";
+        for (size_t i = 0; i < rows.size(); ++i) {
+            const ScalingRow& r = rows[i];
+            out << "    {\"engine\": \"" << r.engine << "\", \"view\": \"" << r.view << "\""
+                << ", \"threads\": " << r.threads
+                << ", \"seconds\": " << r.seconds
+                << ", \"speedup\": " << r.speedup
+                << ", \"efficiency\": " << r.efficiency
+                << ", \"imbalance\": " << r.imbalance()
+                << ", \"steals\": " << r.steals
+                << ", \"iterations\": " << r.checksum
+                << ", \"thread_busy_seconds\": [";
+            for (size_t t = 0; t < r.busy_seconds.size(); ++t) {
+                out << (t ? ", " : "") << r.busy_seconds[t];
+            }
+            out << "]}" << (i + 1 < rows.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n";
+        out << "}\n";
+        return static_cast<bool>(out);
+    }
+
+    void print_usage(const char* program_name) {
+        std::cout << "\n=== 并行渲染线程扩展性基准测试 ===" << std::endl;
+        std::cout << "用法: " << program_name << " [选项]" << std::endl;
+        std::cout << "\n选项:" << std::endl;
+        std::cout << "  --width <w>      图像宽度 (默认: 640)" << std::endl;
+        std::cout << "  --height <h>     图像高度 (默认: 480)" << std::endl;
+        std::cout << "  --threads <list> 线程数列表, 如 1,2,4,8 (默认: 1,2,4...直到全部处理器)" << std::endl;
+        std::cout << "  --repeat <n>     每个配置重复次数, 取最快一次 (默认: 3)" << std::endl;
+        std::cout << "  --engine <name>  只运行指定引擎 (omp_rows|pool_rows|tiles_row|tiles_hilbert|tiles_cost)" << std::endl;
+        std::cout << "  --view <name>    只运行指定视图 (classic|seahorse|dense_boundary|interior)" << std::endl;
+        std::cout << "  --csv <file>     将结果写入CSV文件" << std::endl;
+        std::cout << "  --json <file>    将结果写入JSON文件 (含每线程忙碌时间)" << std::endl;
+        std::cout << "  --help           显示此帮助信息" << std::endl;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int width = 640;
+    int height = 480;
+    int repeat = 3;
+    std::vector<int> thread_list;
+    std::string engine_filter;
+    std::string view_filter;
+    std::string csv_file;
+    std::string json_file;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "--width" && i + 1 < argc) {
+            width = std::atoi(argv[++i]);
+        } else if (arg == "--height" && i + 1 < argc) {
+            height = std::atoi(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            thread_list = parse_thread_list(argv[++i]);
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::atoi(argv[++i]);
+        } else if (arg == "--engine" && i + 1 < argc) {
+            engine_filter = argv[++i];
+        } else if (arg == "--view" && i + 1 < argc) {
+            view_filter = argv[++i];
+        } else if (arg == "--csv" && i + 1 < argc) {
+            csv_file = argv[++i];
+        } else if (arg == "--json" && i + 1 < argc) {
+            json_file = argv[++i];
+        } else {
+            std::cerr << "错误: 未知参数 " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (width < 2 || height < 2 || repeat <= 0) {
+        std::cerr << "错误: 图像尺寸至少为2x2, 重复次数必须为正数" << std::endl;
+        return 1;
+    }
+    if (thread_list.empty()) {
+        thread_list = default_thread_list(get_optimal_thread_count());
+    }
+    std::sort(thread_list.begin(), thread_list.end());
+    thread_list.erase(std::unique(thread_list.begin(), thread_list.end()), thread_list.end());
+
+    std::cout << "=== 并行渲染线程扩展性基准测试 ===" << std::endl;
+    std::cout << "分辨率: " << width << "x" << height << ", 可用处理器: " << get_optimal_thread_count()
+              << ", 每配置取 " << repeat << " 次中最快" << std::endl;
+    if (thread_list.front() != 1) {
+        std::cout << "注意: 线程数列表不含1, 加速比以最小线程数为基准" << std::endl;
+    }
+
+    std::vector<ScalingRow> rows;
+    bool consistent = true;
+
+    for (const View& view : VIEWS) {
+        if (!view_filter.empty() && view.name != view_filter) continue;
+        const RenderParams params = make_params(view, width, height);
+        long long view_checksum = -1;
+
+        std::cout << "\n[视图] " << view.name << " (max_iter=" << view.max_iter << ")" << std::endl;
+        std::cout << std::left << std::setw(16) << "引擎" << std::right << std::setw(8) << "线程"
+                  << std::setw(12) << "耗时ms" << std::setw(10) << "加速比" << std::setw(10) << "效率%"
+                  << std::setw(12) << "忙碌min" << std::setw(12) << "忙碌max" << std::setw(10) << "不均衡"
+                  << std::setw(8) << "窃取" << std::endl;
+
+        for (const EngineEntry& engine : make_engines()) {
+            if (!engine_filter.empty() && engine.name != engine_filter) continue;
+            double base_seconds = 0.0;
+
+            for (int threads : thread_list) {
+                RunResult best;
+                for (int r = 0; r < repeat; ++r) {
+                    RunResult run = engine.run(params, threads);
+                    if (r == 0 || run.seconds < best.seconds) best = run;
+                }
+
+                if (view_checksum < 0) view_checksum = best.checksum;
+                if (best.checksum != view_checksum) {
+                    consistent = false;
+                    std::cerr << "错误: " << engine.name << " @ " << threads << " 线程的迭代总数 "
+                              << best.checksum << " 与参考值 " << view_checksum << " 不一致" << std::endl;
+                }
+                if (base_seconds == 0.0) base_seconds = best.seconds;
+
+                ScalingRow row;
+                row.engine = engine.name;
+                row.view = view.name;
+                row.threads = threads;
+                row.seconds = best.seconds;
+                row.speedup = best.seconds > 0.0 ? base_seconds / best.seconds * thread_list.front() : 0.0;
+                row.efficiency = row.speedup / threads;
+                row.steals = best.steals;
+                row.checksum = best.checksum;
+                row.busy_seconds = best.busy_seconds;
+                if (!best.busy_seconds.empty()) {
+                    row.busy_min = *std::min_element(best.busy_seconds.begin(), best.busy_seconds.end());
+                    row.busy_max = *std::max_element(best.busy_seconds.begin(), best.busy_seconds.end());
+                    double sum = 0.0;
+                    for (double b : best.busy_seconds) sum += b;
+                    row.busy_mean = sum / best.busy_seconds.size();
+                }
+
+                std::cout << std::left << std::setw(16) << row.engine << std::right << std::setw(8) << threads
+                          << std::fixed << std::setprecision(2)
+                          << std::setw(12) << row.seconds * 1000.0
+                          << std::setw(10) << row.speedup
+                          << std::setprecision(1)
+                          << std::setw(10) << row.efficiency * 100.0
+                          << std::setprecision(2)
+                          << std::setw(12) << row.busy_min * 1000.0
+                          << std::setw(12) << row.busy_max * 1000.0
+                          << std::setw(10) << row.imbalance()
+                          << std::setw(8) << row.steals
+                          << std::defaultfloat << std::endl;
+                rows.push_back(row);
+            }
+        }
+    }
+
+    if (rows.empty()) {
+        std::cerr << "错误: 没有匹配的引擎或视图" << std::endl;
+        return 1;
+    }
+
+    // 分块引擎的迭代场经过全局缓冲区池: 除首次外, 同尺寸的重复渲染应复用已缺页的块
+    const MandelbrotCPU::BufferPool::Stats pool_stats = MandelbrotCPU::BufferPool::global().stats();
+    std::cout << "\n缓冲区池: 命中 " << pool_stats.hits << ", 未命中 " << pool_stats.misses
+              << ", 向系统申请 " << std::fixed << std::setprecision(1)
+              << pool_stats.allocated_bytes / (1024.0 * 1024.0) << " MB" << std::endl;
+
+    if (!csv_file.empty()) {
+        if (!write_csv(csv_file, rows)) {
+            std::cerr << "错误: 无法写入 " << csv_file << std::endl;
+            return 1;
+        }
+        std::cout << "\nCSV已写入: " << csv_file << std::endl;
+    }
+    if (!json_file.empty()) {
+        if (!write_json(json_file, rows, width, height, repeat)) {
+            std::cerr << "错误: 无法写入 " << json_file << std::endl;
+            return 1;
+        }
+        std::cout << "JSON已写入: " << json_file << std::endl;
+    }
+
+    return consistent ? 0 : 1;
+}
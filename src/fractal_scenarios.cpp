@@ -0,0 +1,406 @@
+/**
+ * 分形渲染基准场景驱动
+ *
+ * 从场景文件 (默认 bench/scenarios.txt) 读取视图, 用同一套网格依次交给各渲染引擎,
+ * 报告每个场景、每个引擎的耗时、像素吞吐、迭代总数与每次迭代纳秒数。
+ * 场景覆盖用户实际渲染的预设 (/api/wallpaper、BurningShip/Newton/Julia预设)
+ * 以及最坏情况 (全内部、边界密集、高迭代迷你集、双精度极限)。
+ *
+ * 引擎:
+ * - cpu: 各分形的CPU参考实现 (MandelbrotCPU / JuliaRenderer / BurningShipCPU / NewtonFractalCPU)
+ * - omp: OpenMP分块渲染 (render_iterations_omp, 仅Mandelbrot)
+ * - api: 服务端渲染内核 (fractal_kernels.hpp, 全部六种分形)
+ *
+ * 目前没有深度缩放 (扰动/任意精度) 引擎: 像素间距接近或小于坐标ulp的场景会被标注,
+ * 其结果只反映双精度引擎在该视图下的耗时, 图像本身已失去精度。
+ *
+ * 使用示例:
+ * ./fractal_scenarios --scenarios bench/scenarios.txt --json output/scenarios.json
+ * ./fractal_scenarios --filter adversarial --engine omp --threads 8
+ */
+
+#include "../include/fractal_kernels.hpp"
+#include "../include/render.hpp"
+#include "../include/render_omp.hpp"
+#include "../include/julia.hpp"
+#include "../include/burning_ship.hpp"
+#include "../include/newton_fractal.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    /**
+     * 场景: 视图与分形参数
+     */
+    struct Scenario {
+        std::string name;
+        std::string fractal;
+        double cx = 0.0;
+        double cy = 0.0;
+        double zoom = 1.0;
+        int max_iter = 1000;
+        double param_re = 0.0;  // Julia的c / Phoenix的p
+        double param_im = 0.0;
+        std::string source;
+    };
+
+    /**
+     * 像素网格 (所有引擎共用, 方形像素)
+     */
+    struct Grid {
+        int width;
+        int height;
+        double x_min;
+        double y_min;
+        double step;
+
+        MandelbrotCPU::RenderParams render_params(int max_iter) const {
+            return MandelbrotCPU::RenderParams(width, height, max_iter,
+                                               x_min, x_min + step * (width - 1),
+                                               y_min, y_min + step * (height - 1));
+        }
+    };
+
+    Grid make_grid(const Scenario& s, int width, int height) {
+        const double span = 4.0 / s.zoom;
+        Grid grid;
+        grid.width = width;
+        grid.height = height;
+        grid.step = span / width;
+        grid.x_min = s.cx - span / 2.0;
+        grid.y_min = s.cy - grid.step * height / 2.0;
+        return grid;
+    }
+
+    // 像素间距相对坐标ulp的倍数 (小于1时相邻像素的坐标已无法区分)
+    double step_in_ulps(const Scenario& s, const Grid& grid) {
+        const double magnitude = std::max(std::fabs(s.cx), std::fabs(s.cy)) + 2.0 / s.zoom;
+        const double ulp = std::nextafter(magnitude, std::numeric_limits<double>::infinity()) - magnitude;
+        return grid.step / ulp;
+    }
+
+    bool parse_scenarios(const std::string& filename, std::vector<Scenario>& scenarios, std::string& error) {
+        std::ifstream in(filename);
+        if (!in) {
+            error = "无法打开场景文件 " + filename;
+            return false;
+        }
+
+        std::string line;
+        int line_number = 0;
+        while (std::getline(in, line)) {
+            ++line_number;
+            const size_t first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#') continue;
+
+            std::istringstream fields(line);
+            Scenario s;
+            if (!(fields >> s.name >> s.fractal >> s.cx >> s.cy >> s.zoom >> s.max_iter
+                         >> s.param_re >> s.param_im >> s.source)) {
+                error = filename + ":" + std::to_string(line_number) + ": 字段不足或格式错误";
+                return false;
+            }
+            if (s.zoom <= 0.0 || s.max_iter <= 0) {
+                error = filename + ":" + std::to_string(line_number) + ": 缩放和最大迭代必须为正数";
+                return false;
+            }
+            scenarios.push_back(s);
+        }
+        return true;
+    }
+
+    /**
+     * 渲染引擎: 对网格全部像素计算迭代次数, 返回迭代总数
+     */
+    struct Engine {
+        std::string name;
+        std::function<bool(const std::string&)> supports;
+        std::function<long long(const Scenario&, const Grid&, int threads)> run;
+    };
+
+    template <typename Kernel>
+    long long sum_grid(const Grid& grid, Kernel kernel) {
+        long long total = 0;
+        for (int y = 0; y < grid.height; ++y) {
+            const double imag = grid.y_min + y * grid.step;
+            for (int x = 0; x < grid.width; ++x) {
+                total += kernel(grid.x_min + x * grid.step, imag);
+            }
+        }
+        return total;
+    }
+
+    // render_api.cpp 的Newton内核返回 (根编号 * 1000 + 迭代下标), 未收敛返回0
+    int api_newton_iterations(double real, double imag, int max_iter) {
+        const int code = newtonIterations(real, imag, max_iter);
+        return code ? code % 1000 + 1 : max_iter;
+    }
+
+    long long run_cpu(const Scenario& s, const Grid& grid, int) {
+        const int max_iter = s.max_iter;
+        if (s.fractal == "mandelbrot") {
+            return sum_grid(grid, [max_iter](double re, double im) {
+                return MandelbrotCPU::mandelbrot_iterations(re, im, max_iter);
+            });
+        }
+        if (s.fractal == "julia") {
+            return sum_grid(grid, [&s, max_iter](double re, double im) {
+                return fractal::JuliaRenderer::julia_iterations(re, im, s.param_re, s.param_im, max_iter);
+            });
+        }
+        if (s.fractal == "burning_ship") {
+            const BurningShipCPU ship(grid.width, grid.height, max_iter);
+            return sum_grid(grid, [&ship](double re, double im) { return ship.computeBurningShip(re, im); });
+        }
+        const NewtonFractalCPU newton(grid.width, grid.height, max_iter);
+        return sum_grid(grid, [&newton](double re, double im) { return newton.computeNewton(re, im); });
+    }
+
+    long long run_omp(const Scenario& s, const Grid& grid, int threads) {
+        MandelbrotOMP::RenderOptions options;
+        options.num_threads = threads;
+        options.tile_order = MandelbrotOMP::TileOrder::Hilbert;
+        const MandelbrotOMP::IterationField field =
+            MandelbrotOMP::render_iterations_omp(grid.render_params(s.max_iter), options);
+
+        long long total = 0;
+        for (int v : field.to_row_major()) total += v;
+        return total;
+    }
+
+    long long run_api(const Scenario& s, const Grid& grid, int) {
+        const int max_iter = s.max_iter;
+        if (s.fractal == "mandelbrot") {
+            return sum_grid(grid, [max_iter](double re, double im) { return mandelbrotIterations(re, im, max_iter); });
+        }
+        if (s.fractal == "julia") {
+            return sum_grid(grid, [&s, max_iter](double re, double im) {
+                return juliaIterations(re, im, s.param_re, s.param_im, max_iter);
+            });
+        }
+        if (s.fractal == "burning_ship") {
+            return sum_grid(grid, [max_iter](double re, double im) { return burningShipIterations(re, im, max_iter); });
+        }
+        if (s.fractal == "newton") {
+            return sum_grid(grid, [max_iter](double re, double im) { return api_newton_iterations(re, im, max_iter); });
+        }
+        if (s.fractal == "tricorn") {
+            return sum_grid(grid, [max_iter](double re, double im) { return tricornIterations(re, im, max_iter); });
+        }
+        return sum_grid(grid, [&s, max_iter](double re, double im) {
+            return phoenixIterations(re, im, s.param_re, s.param_im, max_iter);
+        });
+    }
+
+    std::vector<Engine> make_engines() {
+        return {
+            {"cpu", [](const std::string& f) {
+                return f == "mandelbrot" || f == "julia" || f == "burning_ship" || f == "newton";
+            }, run_cpu},
+            {"omp", [](const std::string& f) { return f == "mandelbrot"; }, run_omp},
+            {"api", [](const std::string& f) {
+                return f == "mandelbrot" || f == "julia" || f == "burning_ship" || f == "newton" ||
+                       f == "tricorn" || f == "phoenix";
+            }, run_api},
+        };
+    }
+
+    struct ScenarioResult {
+        std::string scenario;
+        std::string source;
+        std::string engine;
+        double seconds = 0.0;
+        long long iterations = 0;
+        double step_ulps = 0.0;
+        long long pixels = 0;
+
+        double pixels_per_second() const { return seconds > 0.0 ? pixels / seconds : 0.0; }
+        double ns_per_iter() const { return iterations > 0 ? seconds * 1e9 / iterations : 0.0; }
+    };
+
+    bool write_json(const std::string& filename, const std::vector<ScenarioResult>& results,
+                    int width, int height, int threads) {
+        std::ofstream out(filename);
+        if (!out) return false;
+        out << std::setprecision(9);
+        out << "{\n";
+        out << "  \"width\": " << width << ",\n";
+        out << "  \"height\": " << height << ",\n";
+        out << "  \"omp_threads\": " << threads << ",\n";
+        out << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const ScenarioResult& r = results[i];
+            out << "    {\"scenario\": \"" << r.scenario << "\", \"source\": \"" << r.source << "\""
+                << ", \"engine\": \"" << r.engine << "\""
+                << ", \"seconds\": " << r.seconds
+                << ", \"iterations\": " << r.iterations
+                << ", \"pixels_per_second\": " << r.pixels_per_second()
+                << ", \"ns_per_iter\": " << r.ns_per_iter()
+                << ", \"step_ulps\": " << r.step_ulps << "}"
+                << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n";
+        out << "}\n";
+        return static_cast<bool>(out);
+    }
+
+    void print_usage(const char* program_name) {
+        std::cout << "\n=== 分形渲染基准场景驱动 ===" << std::endl;
+        std::cout << "用法: " << program_name << " [选项]" << std::endl;
+        std::cout << "\n选项:" << std::endl;
+        std::cout << "  --scenarios <file> 场景文件 (默认: bench/scenarios.txt)" << std::endl;
+        std::cout << "  --width <w>        图像宽度 (默认: 320)" << std::endl;
+        std::cout << "  --height <h>       图像高度 (默认: 240)" << std::endl;
+        std::cout << "  --threads <n>      omp引擎线程数 (默认: 0=全部处理器)" << std::endl;
+        std::cout << "  --repeat <n>       每个场景重复次数, 取最快一次 (默认: 1)" << std::endl;
+        std::cout << "  --engine <name>    只运行指定引擎 (cpu|omp|api)" << std::endl;
+        std::cout << "  --filter <s>       只运行名称或来源包含s的场景" << std::endl;
+        std::cout << "  --json <file>      将结果写入JSON文件" << std::endl;
+        std::cout << "  --list             列出场景后退出" << std::endl;
+        std::cout << "  --help             显示此帮助信息" << std::endl;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string scenario_file = "bench/scenarios.txt";
+    int width = 320;
+    int height = 240;
+    int threads = 0;
+    int repeat = 1;
+    std::string engine_filter;
+    std::string filter;
+    std::string json_file;
+    bool list_only = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "--scenarios" && i + 1 < argc) {
+            scenario_file = argv[++i];
+        } else if (arg == "--width" && i + 1 < argc) {
+            width = std::atoi(argv[++i]);
+        } else if (arg == "--height" && i + 1 < argc) {
+            height = std::atoi(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::atoi(argv[++i]);
+        } else if (arg == "--engine" && i + 1 < argc) {
+            engine_filter = argv[++i];
+        } else if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg == "--json" && i + 1 < argc) {
+            json_file = argv[++i];
+        } else if (arg == "--list") {
+            list_only = true;
+        } else {
+            std::cerr << "错误: 未知参数 " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (width < 2 || height < 2 || repeat <= 0) {
+        std::cerr << "错误: 图像尺寸至少为2x2, 重复次数必须为正数" << std::endl;
+        return 1;
+    }
+
+    std::vector<Scenario> scenarios;
+    std::string error;
+    if (!parse_scenarios(scenario_file, scenarios, error)) {
+        std::cerr << "错误: " << error << std::endl;
+        return 1;
+    }
+
+    if (list_only) {
+        for (const Scenario& s : scenarios) {
+            std::cout << std::left << std::setw(24) << s.name << std::setw(14) << s.fractal
+                      << std::setw(14) << s.source << "zoom=" << s.zoom << " iter=" << s.max_iter << std::endl;
+        }
+        return 0;
+    }
+
+    const std::vector<Engine> engines = make_engines();
+    std::vector<ScenarioResult> results;
+
+    std::cout << "=== 分形渲染基准场景 ===" << std::endl;
+    std::cout << "场景文件: " << scenario_file << " (" << scenarios.size() << " 个场景), 分辨率: "
+              << width << "x" << height << std::endl;
+    std::cout << std::left << std::setw(24) << "场景" << std::setw(8) << "引擎"
+              << std::right << std::setw(12) << "耗时ms" << std::setw(12) << "M像素/秒"
+              << std::setw(16) << "迭代总数" << std::setw(10) << "ns/迭代" << std::endl;
+
+    for (const Scenario& s : scenarios) {
+        if (!filter.empty() && s.name.find(filter) == std::string::npos && s.source.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        const Grid grid = make_grid(s, width, height);
+        const double ulps = step_in_ulps(s, grid);
+        bool any_engine = false;
+
+        for (const Engine& engine : engines) {
+            if (!engine_filter.empty() && engine.name != engine_filter) continue;
+            if (!engine.supports(s.fractal)) continue;
+            any_engine = true;
+
+            ScenarioResult result;
+            result.scenario = s.name;
+            result.source = s.source;
+            result.engine = engine.name;
+            result.step_ulps = ulps;
+            result.pixels = static_cast<long long>(width) * height;
+            for (int r = 0; r < repeat; ++r) {
+                auto start = std::chrono::steady_clock::now();
+                const long long iterations = engine.run(s, grid, threads);
+                const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (r == 0 || seconds < result.seconds) result.seconds = seconds;
+                result.iterations = iterations;
+            }
+
+            std::cout << std::left << std::setw(24) << s.name << std::setw(8) << engine.name
+                      << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(12) << result.seconds * 1000.0
+                      << std::setw(12) << result.pixels_per_second() / 1e6
+                      << std::setw(16) << result.iterations
+                      << std::setprecision(3)
+                      << std::setw(10) << result.ns_per_iter() << std::defaultfloat << std::endl;
+            results.push_back(result);
+        }
+
+        if (any_engine && ulps < 16.0) {
+            std::cout << "  注意: 像素间距仅 " << std::setprecision(3) << ulps << std::defaultfloat
+                      << " ulp" << (ulps < 1.0 ? ", 相邻像素坐标已重合" : ", 接近双精度极限")
+                      << "; 需要深度缩放引擎 (当前未实现)" << std::endl;
+        }
+    }
+
+    if (results.empty()) {
+        std::cerr << "错误: 没有匹配的场景或引擎" << std::endl;
+        return 1;
+    }
+
+    if (!json_file.empty()) {
+        if (!write_json(json_file, results, width, height, threads)) {
+            std::cerr << "错误: 无法写入 " << json_file << std::endl;
+            return 1;
+        }
+        std::cout << "结果已写入: " << json_file << std::endl;
+    }
+
+    return 0;
+}
@@ -14,16 +14,18 @@
 
 #ifdef _OPENMP
 #include <omp.h>
+#include "render_pool.hpp"
 #endif
 
 namespace fractal {
 
 int JuliaRendererOMP::thread_count = 8;
 
-double JuliaRenderer::render(const JuliaParams& params) {
+double JuliaRenderer::render(const JuliaParams& params, MandelbrotCPU::RenderCounters* counters) {
     auto start = std::chrono::high_resolution_clock::now();
     
     std::vector<int> image_data(params.width * params.height);
+    MandelbrotCPU::RenderCounters local_counters;
     
     // 计算像素步长
     double dx = (params.x_max - params.x_min) / params.width;
@@ -38,6 +40,7 @@ double JuliaRenderer::render(const JuliaParams& params) {
             
             // 计算Julia集迭代次数
             int iterations = julia_iterations(x, y, params.cx, params.cy, params.max_iterations);
+            local_counters.add_escape_time(iterations, params.max_iterations);
             
             // 存储结果
             image_data[py * params.width + px] = iterations;
@@ -46,6 +49,9 @@ double JuliaRenderer::render(const JuliaParams& params) {
     
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    if (counters) {
+        *counters = local_counters;
+    }
     
     // 保存图像
     save_ppm(image_data, params.width, params.height, params.output_file);
@@ -152,7 +158,7 @@ void JuliaRenderer::iterations_to_color(int iterations, int max_iterations, int&
 }
 
 // OpenMP版本实现
-double JuliaRendererOMP::render(const JuliaParams& params) {
+double JuliaRendererOMP::render(const JuliaParams& params, MandelbrotCPU::RenderCounters* counters) {
     auto start = std::chrono::high_resolution_clock::now();
     
     std::vector<int> image_data(params.width * params.height);
@@ -162,26 +168,38 @@ double JuliaRendererOMP::render(const JuliaParams& params) {
     double dy = (params.y_max - params.y_min) / params.height;
     
 #ifdef _OPENMP
-    omp_set_num_threads(thread_count);
+    // 复用全局线程池: 连续渲染多个预设时不再重复创建线程, 按行动态领取
+    MandelbrotOMP::RenderPool& pool = MandelbrotOMP::RenderPool::global();
+    pool.configure(thread_count);
     
-    // OpenMP并行渲染
-    #pragma omp parallel for collapse(2) schedule(dynamic)
-    for (int py = 0; py < params.height; ++py) {
+    // 每线程计数槽 (RenderCounters按缓存行对齐, 无伪共享)
+    std::vector<MandelbrotCPU::RenderCounters> thread_counters(pool.num_threads());
+    
+    pool.parallel_for(params.height, [&](int py) {
+        MandelbrotCPU::RenderCounters& row_counters = thread_counters[omp_get_thread_num()];
+        double y = params.y_min + py * dy;
         for (int px = 0; px < params.width; ++px) {
             // 将像素坐标转换为复数坐标
             double x = params.x_min + px * dx;
-            double y = params.y_min + py * dy;
             
             // 计算Julia集迭代次数
             int iterations = JuliaRenderer::julia_iterations(x, y, params.cx, params.cy, params.max_iterations);
+            row_counters.add_escape_time(iterations, params.max_iterations);
             
             // 存储结果
-            image_data[py * params.width + px] = iterations;
+            image_data[static_cast<size_t>(py) * params.width + px] = iterations;
+        }
+    });
+    
+    if (counters) {
+        *counters = MandelbrotCPU::RenderCounters();
+        for (const MandelbrotCPU::RenderCounters& slot : thread_counters) {
+            counters->merge(slot);
         }
     }
 #else
     // 回退到单线程版本
-    return JuliaRenderer::render(params);
+    return JuliaRenderer::render(params, counters);
 #endif
     
     auto end = std::chrono::high_resolution_clock::now();
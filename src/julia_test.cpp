@@ -26,6 +26,7 @@ void print_usage(const char* program_name) {
     std::cout << "  -t <threads>   OpenMP线程数 (默认: 8)" << std::endl;
     std::cout << "  --omp          使用OpenMP并行渲染" << std::endl;
     std::cout << "  --demo         演示所有预设参数" << std::endl;
+    std::cout << "  --stats        每次渲染后在stderr输出热路径计数 (JSON: 迭代次数、逃逸/内部像素数)" << std::endl;
     std::cout << "  -h, --help     显示此帮助信息" << std::endl;
     std::cout << std::endl;
     std::cout << "示例:" << std::endl;
@@ -34,24 +35,25 @@ void print_usage(const char* program_name) {
     std::cout << "  " << program_name << " --demo" << std::endl;
 }
 
-void render_preset(const JuliaParams& preset, bool use_omp = false) {
+void render_preset(const JuliaParams& preset, bool use_omp = false, bool print_stats = false) {
     std::cout << "\n=== 渲染 Julia Set ===" << std::endl;
     
-    if (use_omp) {
-        JuliaRendererOMP::render(preset);
-    } else {
-        JuliaRenderer::render(preset);
+    MandelbrotCPU::RenderCounters counters;
+    double elapsed_ms = use_omp ? JuliaRendererOMP::render(preset, &counters)
+                                : JuliaRenderer::render(preset, &counters);
+    if (print_stats) {
+        std::cerr << counters.to_json(use_omp ? "julia_omp" : "julia_cpu", elapsed_ms / 1000.0) << std::endl;
     }
 }
 
-void demo_all_presets(bool use_omp = false) {
+void demo_all_presets(bool use_omp = false, bool print_stats = false) {
     std::cout << "\n🎨 Julia Set 演示 - 所有预设参数" << std::endl;
     std::cout << "================================================" << std::endl;
     
-    render_preset(julia_presets::CLASSIC, use_omp);
-    render_preset(julia_presets::DRAGON, use_omp);
-    render_preset(julia_presets::SPIRAL, use_omp);
-    render_preset(julia_presets::DENDRITE, use_omp);
+    render_preset(julia_presets::CLASSIC, use_omp, print_stats);
+    render_preset(julia_presets::DRAGON, use_omp, print_stats);
+    render_preset(julia_presets::SPIRAL, use_omp, print_stats);
+    render_preset(julia_presets::DENDRITE, use_omp, print_stats);
     
     std::cout << "\n✅ 演示完成！生成的文件:" << std::endl;
     std::cout << "   - julia_classic.ppm" << std::endl;
@@ -66,6 +68,7 @@ int main(int argc, char* argv[]) {
     JuliaParams params = julia_presets::CLASSIC;
     bool use_omp = false;
     bool demo_mode = false;
+    bool print_stats = false;  // 渲染结束后在stderr输出热路径计数 (JSON)
     
     // 解析命令行参数
     for (int i = 1; i < argc; ++i) {
@@ -81,6 +84,9 @@ int main(int argc, char* argv[]) {
         else if (arg == "--omp") {
             use_omp = true;
         }
+        else if (arg == "--stats") {
+            print_stats = true;
+        }
         else if (arg == "-p" && i + 1 < argc) {
             std::string preset = argv[++i];
             if (preset == "classic") params = julia_presets::CLASSIC;
@@ -117,9 +123,9 @@ int main(int argc, char* argv[]) {
     }
     
     if (demo_mode) {
-        demo_all_presets(use_omp);
+        demo_all_presets(use_omp, print_stats);
     } else {
-        render_preset(params, use_omp);
+        render_preset(params, use_omp, print_stats);
     }
     
     return 0;
@@ -19,6 +19,8 @@
  */
 
 #include "../include/render.hpp"
+#define MANDELBROT_COUNT_ALLOCATIONS
+#include "../include/memory_stats.hpp"
 #include <iostream>
 #include <string>
 #include <chrono>
@@ -35,6 +37,7 @@ void print_usage(const char* program_name) {
     std::cout << "  --ymin <y>      复平面Y最小值 (默认: -1.2)" << std::endl;
     std::cout << "  --ymax <y>      复平面Y最大值 (默认: 1.2)" << std::endl;
     std::cout << "  --output <file> 输出文件名 (默认: output/mandelbrot_cpu.ppm)" << std::endl;
+    std::cout << "  --stats         渲染结束后在stderr输出热路径计数与内存统计 (JSON: 迭代次数、逃逸/内部像素数、峰值RSS、分配次数)" << std::endl;
     std::cout << "  --help          显示此帮助信息" << std::endl;
     std::cout << "\n示例:" << std::endl;
     std::cout << "  " << program_name << " --width 1920 --height 1080 --iter 2000" << std::endl;
@@ -54,6 +57,7 @@ int main(int argc, char* argv[]) {
     // 默认渲染参数
     MandelbrotCPU::RenderParams params;
     std::string output_filename = "output/mandelbrot_cpu.ppm";
+    bool print_stats = false;
     
     // 解析命令行参数
     for (int i = 1; i < argc; ++i) {
@@ -87,6 +91,9 @@ int main(int argc, char* argv[]) {
         else if (arg == "--output" && i + 1 < argc) {
             output_filename = argv[++i];
         }
+        else if (arg == "--stats") {
+            print_stats = true;
+        }
         else {
             std::cerr << "未知参数: " << arg << std::endl;
             print_usage(argv[0]);
@@ -118,10 +125,24 @@ int main(int argc, char* argv[]) {
     
     try {
         // CPU版本渲染
+        MandelbrotCPU::MemoryTracker memory;
+        const MandelbrotCPU::BufferPool::Stats pool_before = MandelbrotCPU::BufferPool::global().stats();
         auto start_time = std::chrono::high_resolution_clock::now();
-        auto image_data = MandelbrotCPU::render_mandelbrot_cpu(params);
+        MandelbrotCPU::RenderCounters counters;
+        auto image_data = MandelbrotCPU::render_mandelbrot_cpu(params, &counters);
         auto render_time = std::chrono::high_resolution_clock::now();
         
+        if (print_stats) {
+            // 缓冲区池的大块直接向系统申请, 不经过 operator new 钩子
+            MandelbrotCPU::MemoryUsage usage = memory.finish();
+            const MandelbrotCPU::BufferPool::Stats pool_after = MandelbrotCPU::BufferPool::global().stats();
+            usage.add_allocations(pool_after.misses - pool_before.misses,
+                                  static_cast<long long>(pool_after.allocated_bytes - pool_before.allocated_bytes));
+            std::cerr << counters.to_json("cpu", std::chrono::duration<double>(render_time - start_time).count(),
+                                          usage.json_fields())
+                      << std::endl;
+        }
+        
         // 保存图像
         MandelbrotCPU::save_ppm(output_filename, image_data, params.width, params.height);
         auto save_time = std::chrono::high_resolution_clock::now();
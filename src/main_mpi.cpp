@@ -0,0 +1,196 @@
+/**
+ * Mandelbrot 分形渲染器 - MPI集群主程序
+ *
+ * 多节点分布式渲染: rank 0 动态调度行带分块, 各节点用OpenMP渲染,
+ * 最终通过MPI-IO集合写入同一个PPM文件
+ *
+ * 编译命令:
+ * mpicxx -std=c++17 -O3 -fopenmp src/main_mpi.cpp src/render_mpi.cpp src/render.cpp src/render_omp.cpp -I include -o mandelbrot_mpi
+ *
+ * 使用示例:
+ * mpirun -np 4 ./mandelbrot_mpi --width 8192 --height 8192 --iter 2000 --output output/mandelbrot_mpi.ppm
+ * mpirun -np 16 --hostfile hosts ./mandelbrot_mpi --threads 32 --band 32 --width 50000 --height 50000
+ *
+ * 作者: Geoffrey Wang (with Claude AI assistance)
+ * 日期: 2025-08-12
+ */
+
+#include "../include/render_mpi.hpp"
+#include <iostream>
+#include <string>
+
+void print_usage(const char* program_name) {
+    std::cout << "\n=== Mandelbrot 分形渲染器 (MPI集群版本) ===" << std::endl;
+    std::cout << "用法: mpirun -np <n> " << program_name << " [选项]" << std::endl;
+    std::cout << "\n基础选项:" << std::endl;
+    std::cout << "  --width <w>     图像宽度 (默认: 800)" << std::endl;
+    std::cout << "  --height <h>    图像高度 (默认: 600)" << std::endl;
+    std::cout << "  --iter <n>      最大迭代次数 (默认: 1000)" << std::endl;
+    std::cout << "  --xmin <x>      复平面X最小值 (默认: -2.0)" << std::endl;
+    std::cout << "  --xmax <x>      复平面X最大值 (默认: 1.0)" << std::endl;
+    std::cout << "  --ymin <y>      复平面Y最小值 (默认: -1.2)" << std::endl;
+    std::cout << "  --ymax <y>      复平面Y最大值 (默认: 1.2)" << std::endl;
+    std::cout << "  --output <file> 输出文件名 (默认: output/mandelbrot_mpi.ppm)" << std::endl;
+    std::cout << "  --stats         渲染结束后rank 0在stderr输出全部进程合并的热路径计数 (JSON)" << std::endl;
+    std::cout << "  --help          显示此帮助信息" << std::endl;
+    std::cout << "\nMPI专用选项:" << std::endl;
+    std::cout << "  --threads <n>   每个进程的OpenMP线程数 (默认: 自动检测)" << std::endl;
+    std::cout << "  --band <rows>   每个分块的行数 (默认: 64)" << std::endl;
+    std::cout << "  --cost-partition 按1/16分辨率探测的代价静态划分行带, 仅余量动态调度" << std::endl;
+    std::cout << "  --steal <f>     代价划分时留给动态调度的代价比例 (默认: 0.1)" << std::endl;
+    std::cout << "  --info          显示MPI配置信息" << std::endl;
+    std::cout << "\n示例:" << std::endl;
+    std::cout << "  mpirun -np 4 " << program_name << " --width 4096 --height 4096 --iter 2000" << std::endl;
+    std::cout << "  mpirun -np 4 " << program_name << " --threads 2 --band 32 --width 1920 --height 1080" << std::endl;
+    std::cout << "\n说明:" << std::endl;
+    std::cout << "  - rank 0 负责调度, 其余进程负责渲染 (单进程时rank 0独立渲染)" << std::endl;
+    std::cout << "  - 输出文件需位于所有节点可见的共享文件系统上" << std::endl;
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    MPI_Init(&argc, &argv);
+
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    // 默认渲染参数
+    MandelbrotCPU::RenderParams params;
+    MandelbrotMPI::MPIRenderConfig config;
+    std::string output_filename = "output/mandelbrot_mpi.ppm";
+    bool show_info = false;
+    bool print_stats = false;
+
+    // 解析命令行参数 (所有rank解析相同的参数)
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            if (rank == 0) print_usage(argv[0]);
+            MPI_Finalize();
+            return 0;
+        }
+        else if (arg == "--width" && i + 1 < argc) {
+            params.width = std::stoi(argv[++i]);
+        }
+        else if (arg == "--height" && i + 1 < argc) {
+            params.height = std::stoi(argv[++i]);
+        }
+        else if (arg == "--iter" && i + 1 < argc) {
+            params.max_iter = std::stoi(argv[++i]);
+        }
+        else if (arg == "--xmin" && i + 1 < argc) {
+            params.x_min = std::stod(argv[++i]);
+        }
+        else if (arg == "--xmax" && i + 1 < argc) {
+            params.x_max = std::stod(argv[++i]);
+        }
+        else if (arg == "--ymin" && i + 1 < argc) {
+            params.y_min = std::stod(argv[++i]);
+        }
+        else if (arg == "--ymax" && i + 1 < argc) {
+            params.y_max = std::stod(argv[++i]);
+        }
+        else if (arg == "--output" && i + 1 < argc) {
+            output_filename = argv[++i];
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            config.num_threads = std::stoi(argv[++i]);
+        }
+        else if (arg == "--band" && i + 1 < argc) {
+            config.band_height = std::stoi(argv[++i]);
+        }
+        else if (arg == "--cost-partition") {
+            config.cost_partition = true;
+        }
+        else if (arg == "--steal" && i + 1 < argc) {
+            config.steal_fraction = std::stod(argv[++i]);
+        }
+        else if (arg == "--info") {
+            show_info = true;
+        }
+        else if (arg == "--stats") {
+            print_stats = true;
+        }
+        else {
+            if (rank == 0) {
+                std::cerr << "未知参数: " << arg << std::endl;
+                print_usage(argv[0]);
+            }
+            MPI_Finalize();
+            return 1;
+        }
+    }
+
+    if (show_info) {
+        std::string info = MandelbrotMPI::get_mpi_info();
+        if (rank == 0) {
+            std::cout << "\n=== MPI配置信息 ===" << std::endl;
+            std::cout << info << std::endl;
+        }
+        MPI_Finalize();
+        return 0;
+    }
+
+    // 参数验证 (所有rank结论一致, 无需通信)
+    std::string error;
+    if (params.width <= 0 || params.height <= 0) {
+        error = "图像尺寸必须为正数!";
+    } else if (params.max_iter <= 0) {
+        error = "迭代次数必须为正数!";
+    } else if (params.x_min >= params.x_max || params.y_min >= params.y_max) {
+        error = "坐标范围无效!";
+    } else if (config.band_height <= 0) {
+        error = "分块行数必须为正数!";
+    }
+    if (!error.empty()) {
+        if (rank == 0) std::cerr << "[ERROR] " << error << std::endl;
+        MPI_Finalize();
+        return 1;
+    }
+
+    if (rank == 0) {
+        std::cout << "\n🌀 Mandelbrot 分形渲染器启动..." << std::endl;
+        std::cout << "📦 当前版本: MPI集群实现" << std::endl;
+        std::cout << "\n=== 渲染配置 ===" << std::endl;
+        std::cout << "🖼️  图像尺寸: " << params.width << " x " << params.height
+                  << " (" << (params.width * static_cast<double>(params.height) / 1000000.0) << " MP)" << std::endl;
+        std::cout << "🔢 最大迭代: " << params.max_iter << std::endl;
+        std::cout << "📍 复平面区域: [" << params.x_min << ", " << params.x_max
+                  << "] × [" << params.y_min << ", " << params.y_max << "]" << std::endl;
+        std::cout << "📁 输出文件: " << output_filename << std::endl;
+    }
+
+    try {
+        MandelbrotMPI::MPIRenderStats stats =
+            MandelbrotMPI::render_mandelbrot_mpi(params, output_filename, config);
+
+        if (rank == 0) {
+            double total_ms = (stats.render_seconds + stats.write_seconds) * 1000.0;
+
+            std::cout << "\n=== 性能报告 ===" << std::endl;
+            std::cout << "⏱️  渲染耗时: " << static_cast<long>(stats.render_seconds * 1000) << " ms" << std::endl;
+            std::cout << "💾 写入耗时: " << static_cast<long>(stats.write_seconds * 1000) << " ms" << std::endl;
+            std::cout << "🚀 总耗时: " << static_cast<long>(total_ms) << " ms" << std::endl;
+            std::cout << "📊 渲染速度: " << (params.width * static_cast<double>(params.height) / stats.render_seconds)
+                      << " 像素/秒" << std::endl;
+            std::cout << "🖥️  进程分块分布:";
+            for (int r = 0; r < stats.num_ranks; ++r) {
+                std::cout << " [" << r << "]=" << stats.tiles_per_rank[r];
+            }
+            std::cout << std::endl;
+            if (print_stats) {
+                std::cerr << stats.counters.to_json("mpi", stats.render_seconds) << std::endl;
+            }
+            std::cout << "\n✅ 渲染完成!" << std::endl;
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] 渲染失败 (rank " << rank << "): " << e.what() << std::endl;
+        MPI_Abort(MPI_COMM_WORLD, 1);
+        return 1;
+    }
+
+    MPI_Finalize();
+    return 0;
+}
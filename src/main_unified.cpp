@@ -23,8 +23,11 @@
  */
 
 #include "../include/render.hpp"
+#define MANDELBROT_COUNT_ALLOCATIONS
+#include "../include/memory_stats.hpp"
 #ifdef OPENMP_VERSION
 #include "../include/render_omp.hpp"
+#include "../include/cost_heatmap.hpp"
 #endif
 #ifdef CUDA_VERSION
 #include "../include/render_cuda.hpp"
@@ -32,6 +35,7 @@
 #include <iostream>
 #include <string>
 #include <chrono>
+#include <memory>
 
 enum class RenderMode {
     CPU,
@@ -76,11 +80,31 @@ void print_usage(const char* program_name, RenderMode mode) {
     std::cout << "  --output <file> 输出文件名 (默认: output/mandelbrot_" 
               << (mode == RenderMode::CPU ? "cpu" : mode == RenderMode::OPENMP ? "omp" : "gpu") 
               << ".ppm)" << std::endl;
+    if (mode != RenderMode::CUDA) {
+        std::cout << "  --stats         渲染结束后在stderr输出热路径计数与内存统计 (JSON: 迭代次数、逃逸/内部像素数、峰值RSS、分配次数)" << std::endl;
+    }
     std::cout << "  --help          显示此帮助信息" << std::endl;
     
     if (mode == RenderMode::OPENMP) {
         std::cout << "\nOpenMP专用选项:" << std::endl;
         std::cout << "  --threads <n>   线程数 (默认: 自动检测)" << std::endl;
+        std::cout << "  --tile <n>      分块边长 (默认: 64)" << std::endl;
+        std::cout << "  --checkpoint <file> 启用检查点日志, 定期保存已完成分块" << std::endl;
+        std::cout << "  --checkpoint-interval <s> 检查点落盘间隔秒数 (默认: 5)" << std::endl;
+        std::cout << "  --resume        从检查点恢复, 跳过已完成分块 (默认日志: <output>.ckpt)" << std::endl;
+        std::cout << "  --no-pin        多NUMA节点时不绑定线程到节点" << std::endl;
+        std::cout << "  --order <name>  分块遍历顺序: row, morton, hilbert (默认: row)" << std::endl;
+        std::cout << "  --cost-partition 按1/16分辨率探测的代价为每线程划分连续分块段" << std::endl;
+        std::cout << "  --steal <f>     代价划分时留作可窃取余量的代价比例 (默认: 0.1)" << std::endl;
+        std::cout << "  --prefault      渲染前并行预缺页图像缓冲区" << std::endl;
+        std::cout << "  --trace <file>  输出Chrome trace-event时间线 (各阶段与每线程分块, chrome://tracing 查看)" << std::endl;
+        std::cout << "  --cost-map <file> 另存每像素迭代次数热力图 (PPM, 对数刻度) 并输出代价分布百分位数" << std::endl;
+        std::cout << "  --color <mode>  着色方式: linear (迭代次数线性映射), equalize (直方图均衡) (默认: linear)" << std::endl;
+        std::cout << "  --aa <n>        边缘自适应超采样: 只对边缘像素做n个抖动子采样 (如 4, 9, 16)" << std::endl;
+        std::cout << "  --aa-threshold <t> 边缘判定的邻域颜色差阈值 (各通道差之和, 默认: 48)" << std::endl;
+        std::cout << "  --supersample <n> 整图按n倍分辨率渲染后在进程内缩小 (线性光滤波)" << std::endl;
+        std::cout << "  --filter <name> 缩小滤波器: box, tent, lanczos3 (默认: lanczos3)" << std::endl;
+        std::cout << "  --no-huge-pages 大缓冲区不使用透明大页" << std::endl;
         std::cout << "  --info          显示OpenMP配置信息" << std::endl;
     }
     
@@ -97,6 +121,7 @@ void print_usage(const char* program_name, RenderMode mode) {
     
     if (mode == RenderMode::OPENMP) {
         std::cout << "  " << program_name << " --threads 8 --width 2048 --height 1536 --iter 5000" << std::endl;
+        std::cout << "  " << program_name << " --width 50000 --height 50000 --checkpoint big.ckpt --resume" << std::endl;
     }
     
     if (mode == RenderMode::CUDA) {
@@ -112,6 +137,7 @@ void print_usage(const char* program_name, RenderMode mode) {
         std::cout << "  - 建议使用OpenMP版本获得更高性能: mandelbrot_omp" << std::endl;
     } else if (mode == RenderMode::OPENMP) {
         std::cout << "  - 支持自动线程数检测和负载均衡优化" << std::endl;
+        std::cout << "  - 多路服务器上按NUMA节点绑定线程并就近分配分块内存" << std::endl;
         std::cout << "  - 预期性能: 4-8核CPU可达到3-6倍加速" << std::endl;
     }
     
@@ -141,6 +167,22 @@ int main(int argc, char* argv[]) {
     int device_id = -1;   // -1 = 自动选择
     int block_size = 16;  // CUDA线程块大小
     bool show_info = false;
+    bool print_stats = false;  // 渲染结束后在stderr输出热路径计数 (JSON)
+    MandelbrotCPU::RenderCounters counters;
+    #ifdef OPENMP_VERSION
+    MandelbrotOMP::RenderOptions omp_options;
+    MandelbrotOMP::RenderStats omp_stats;
+    std::string trace_filename;  // 非空时输出渲染时间线
+    std::string cost_map_filename;  // 非空时输出代价热力图
+    std::vector<int> pixel_costs;
+    int cost_map_width = 0;   // 代价热力图按实际渲染分辨率保存 (整图超采样时大于输出)
+    int cost_map_height = 0;
+    bool equalize_colors = false;  // 直方图均衡着色
+    MandelbrotOMP::SupersampleOptions supersample_options;
+    supersample_options.samples = 0;  // 0 = 不做边缘超采样
+    int supersample_factor = 1;       // 整图超采样倍数
+    MandelbrotCPU::ResampleFilter resample_filter = MandelbrotCPU::ResampleFilter::Lanczos3;
+    #endif
     
     // 解析命令行参数
     for (int i = 1; i < argc; ++i) {
@@ -174,9 +216,79 @@ int main(int argc, char* argv[]) {
         else if (arg == "--output" && i + 1 < argc) {
             output_filename = argv[++i];
         }
+        else if (arg == "--stats" && mode != RenderMode::CUDA) {
+            print_stats = true;
+        }
         else if (arg == "--threads" && i + 1 < argc && mode == RenderMode::OPENMP) {
             num_threads = std::stoi(argv[++i]);
         }
+        #ifdef OPENMP_VERSION
+        else if (arg == "--tile" && i + 1 < argc) {
+            omp_options.tile_size = std::stoi(argv[++i]);
+        }
+        else if (arg == "--checkpoint" && i + 1 < argc) {
+            omp_options.checkpoint_file = argv[++i];
+        }
+        else if (arg == "--checkpoint-interval" && i + 1 < argc) {
+            omp_options.checkpoint_interval_ms = static_cast<int>(std::stod(argv[++i]) * 1000);
+        }
+        else if (arg == "--resume") {
+            omp_options.resume = true;
+        }
+        else if (arg == "--no-pin") {
+            omp_options.pin_threads = false;
+        }
+        else if (arg == "--prefault") {
+            omp_options.prefault = true;
+        }
+        else if (arg == "--no-huge-pages") {
+            MandelbrotCPU::BufferPool::global().set_huge_pages(false);
+        }
+        else if (arg == "--trace" && i + 1 < argc) {
+            trace_filename = argv[++i];
+        }
+        else if (arg == "--cost-map" && i + 1 < argc) {
+            cost_map_filename = argv[++i];
+        }
+        else if (arg == "--color" && i + 1 < argc) {
+            std::string color_mode = argv[++i];
+            if (color_mode == "equalize") {
+                equalize_colors = true;
+            } else if (color_mode != "linear") {
+                std::cerr << "[ERROR] 未知的着色方式: " << color_mode << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--aa" && i + 1 < argc) {
+            supersample_options.samples = std::stoi(argv[++i]);
+        }
+        else if (arg == "--supersample" && i + 1 < argc) {
+            supersample_factor = std::stoi(argv[++i]);
+        }
+        else if (arg == "--filter" && i + 1 < argc) {
+            std::string filter_name = argv[++i];
+            if (!MandelbrotCPU::parse_resample_filter(filter_name, resample_filter)) {
+                std::cerr << "[ERROR] 未知的缩小滤波器: " << filter_name << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--aa-threshold" && i + 1 < argc) {
+            supersample_options.color_threshold = std::stoi(argv[++i]);
+        }
+        else if (arg == "--cost-partition") {
+            omp_options.cost_partition = true;
+        }
+        else if (arg == "--steal" && i + 1 < argc) {
+            omp_options.steal_fraction = std::stod(argv[++i]);
+        }
+        else if (arg == "--order" && i + 1 < argc) {
+            std::string order_name = argv[++i];
+            if (!MandelbrotOMP::parse_tile_order(order_name, omp_options.tile_order)) {
+                std::cerr << "[ERROR] 未知的分块遍历顺序: " << order_name << std::endl;
+                return 1;
+            }
+        }
+        #endif
         else if (arg == "--device" && i + 1 < argc && mode == RenderMode::CUDA) {
             device_id = std::stoi(argv[++i]);
         }
@@ -224,32 +336,125 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    #ifdef OPENMP_VERSION
+    if (omp_options.tile_size <= 0) {
+        std::cerr << "[ERROR] 分块边长必须为正数!" << std::endl;
+        return 1;
+    }
+    if (omp_options.resume && omp_options.checkpoint_file.empty()) {
+        omp_options.checkpoint_file = output_filename + ".ckpt";
+    }
+    if ((equalize_colors || supersample_options.samples > 0) && !omp_options.checkpoint_file.empty()) {
+        // 检查点日志保存的是已着色的像素, 均衡着色与边缘超采样需要完整迭代场
+        std::cerr << "[ERROR] --color equalize / --aa 不能与检查点同时使用!" << std::endl;
+        return 1;
+    }
+    if (supersample_factor < 1 || supersample_factor > 8) {
+        std::cerr << "[ERROR] 超采样倍数须在 1-8 之间!" << std::endl;
+        return 1;
+    }
+    #endif
+    
     std::cout << "\n=== 渲染配置 ===" << std::endl;
     std::cout << "🖼️  图像尺寸: " << params.width << " x " << params.height 
-              << " (" << (params.width * params.height / 1000000.0) << " MP)" << std::endl;
+              << " (" << (static_cast<double>(params.width) * params.height / 1000000.0) << " MP)" << std::endl;
     std::cout << "🔢 最大迭代: " << params.max_iter << std::endl;
     std::cout << "📍 复平面区域: [" << params.x_min << ", " << params.x_max 
               << "] × [" << params.y_min << ", " << params.y_max << "]" << std::endl;
     std::cout << "📁 输出文件: " << output_filename << std::endl;
+    #ifdef OPENMP_VERSION
+    if (supersample_factor > 1) {
+        std::cout << "🔍 整图超采样: " << supersample_factor << "x" << supersample_factor << " (渲染 "
+                  << params.width * supersample_factor << " x " << params.height * supersample_factor << ")" << std::endl;
+    }
+    #endif
     
     if (mode == RenderMode::OPENMP && num_threads > 0) {
         std::cout << "🧵 线程数: " << num_threads << std::endl;
     }
     
+    #ifdef OPENMP_VERSION
+    std::unique_ptr<MandelbrotCPU::TraceRecorder> trace;
+    if (!trace_filename.empty()) {
+        trace = std::make_unique<MandelbrotCPU::TraceRecorder>("mandelbrot_omp");
+        omp_options.trace = trace.get();
+    }
+    if (!cost_map_filename.empty()) {
+        omp_options.pixel_costs = &pixel_costs;
+    }
+    #endif
+    
     try {
+        MandelbrotCPU::MemoryTracker memory;
+        const MandelbrotCPU::BufferPool::Stats pool_before = MandelbrotCPU::BufferPool::global().stats();
+        
         // 选择渲染模式
-        auto start_time = std::chrono::high_resolution_clock::now();
-        std::vector<unsigned char> image_data;
+        auto start_time = std::chrono::steady_clock::now();  // 单调时钟, 与时间线追踪共用时间基准
+        MandelbrotCPU::ImageBuffer image_data;
         
         switch (mode) {
             case RenderMode::CPU:
-                image_data = MandelbrotCPU::render_mandelbrot_cpu(params);
+                image_data = MandelbrotCPU::render_mandelbrot_cpu(params, &counters);
                 break;
                 
             #ifdef OPENMP_VERSION
-            case RenderMode::OPENMP:
-                image_data = MandelbrotOMP::render_mandelbrot_omp(params, num_threads);
+            case RenderMode::OPENMP: {
+                omp_options.num_threads = num_threads;
+                omp_options.stats = &omp_stats;
+                // 整图超采样: 同一复平面区域按n倍分辨率渲染, 再在进程内缩小到输出尺寸
+                MandelbrotOMP::RenderParams render_params = params;
+                render_params.width *= supersample_factor;
+                render_params.height *= supersample_factor;
+                if (equalize_colors || supersample_options.samples > 0) {
+                    // 先算完整迭代场, 再按全图迭代次数分布着色 / 按邻域找出边缘像素补采样
+                    const MandelbrotOMP::IterationField field = MandelbrotOMP::render_iterations_omp(render_params, omp_options);
+                    const auto colorize_start = std::chrono::steady_clock::now();
+                    const double compute_seconds = std::chrono::duration<double>(colorize_start - start_time).count();
+                    auto percent_of_compute = [compute_seconds](double seconds) {
+                        return compute_seconds > 0 ? seconds / compute_seconds * 100 : 0.0;
+                    };
+                    
+                    std::vector<MandelbrotOMP::RGB> palette;  // 空 = 线性着色
+                    if (equalize_colors) {
+                        palette = MandelbrotOMP::equalized_palette_omp(field, render_params.max_iter, omp_options.trace);
+                        image_data = MandelbrotOMP::colorize_omp(field, palette, omp_options.trace);
+                        const double colorize_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - colorize_start).count();
+                        std::cout << "🎨 直方图均衡着色: " << colorize_seconds * 1000 << " ms (迭代计算的 "
+                                  << percent_of_compute(colorize_seconds) << "%)" << std::endl;
+                    } else {
+                        image_data = MandelbrotOMP::colorize_omp(field, render_params.max_iter, omp_options.trace);
+                    }
+                    
+                    if (supersample_options.samples > 0) {
+                        supersample_options.trace = omp_options.trace;
+                        const auto aa_start = std::chrono::steady_clock::now();
+                        const MandelbrotOMP::SupersampleStats aa = MandelbrotOMP::supersample_edges_omp(
+                            render_params, field, palette, image_data, supersample_options);
+                        const double aa_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - aa_start).count();
+                        omp_stats.counters.merge(aa.counters);
+                        const double total_pixels = static_cast<double>(render_params.width) * render_params.height;
+                        std::cout << "✨ 边缘超采样: " << aa.edge_pixels << " 像素 (" << aa.edge_pixels / total_pixels * 100
+                                  << "%) x " << aa.samples_per_pixel << " 子采样, " << aa_seconds * 1000 << " ms (迭代计算的 "
+                                  << percent_of_compute(aa_seconds) << "%, 整图" << aa.samples_per_pixel << "倍超采样约需 "
+                                  << compute_seconds * aa.samples_per_pixel << " s)" << std::endl;
+                    }
+                    if (!cost_map_filename.empty()) pixel_costs = field.to_row_major();
+                } else {
+                    image_data = MandelbrotOMP::render_mandelbrot_omp(render_params, omp_options);
+                }
+                if (supersample_factor > 1) {
+                    const auto downsample_start = std::chrono::steady_clock::now();
+                    image_data = MandelbrotOMP::downsample_omp(image_data, render_params.width, render_params.height,
+                                                               params.width, params.height, resample_filter, omp_options.trace);
+                    std::cout << "🔍 缩小 " << render_params.width << "x" << render_params.height << " -> " << params.width
+                              << "x" << params.height << ": " << std::chrono::duration<double, std::milli>(
+                                     std::chrono::steady_clock::now() - downsample_start).count() << " ms" << std::endl;
+                }
+                cost_map_width = render_params.width;
+                cost_map_height = render_params.height;
+                counters = omp_stats.counters;
                 break;
+            }
             #endif
             
             #ifdef CUDA_VERSION
@@ -257,7 +462,10 @@ int main(int argc, char* argv[]) {
                 if (device_id == -1) {
                     device_id = MandelbrotCUDA::get_best_gpu_device();
                 }
-                image_data = MandelbrotCUDA::render_mandelbrot_cuda(params, device_id, block_size);
+                {
+                    std::vector<unsigned char> gpu_data = MandelbrotCUDA::render_mandelbrot_cuda(params, device_id, block_size);
+                    image_data.assign(gpu_data.begin(), gpu_data.end());
+                }
                 break;
             #endif
                 
@@ -266,11 +474,49 @@ int main(int argc, char* argv[]) {
                 return 1;
         }
         
-        auto render_time = std::chrono::high_resolution_clock::now();
+        auto render_time = std::chrono::steady_clock::now();
+        
+        if (print_stats) {
+            // 缓冲区池的大块直接向系统申请, 不经过 operator new 钩子
+            MandelbrotCPU::MemoryUsage usage = memory.finish();
+            const MandelbrotCPU::BufferPool::Stats pool_after = MandelbrotCPU::BufferPool::global().stats();
+            usage.add_allocations(pool_after.misses - pool_before.misses,
+                                  static_cast<long long>(pool_after.allocated_bytes - pool_before.allocated_bytes));
+            std::cerr << counters.to_json(mode_suffix, std::chrono::duration<double>(render_time - start_time).count(),
+                                          usage.json_fields())
+                      << std::endl;
+        }
         
         // 保存图像
         MandelbrotCPU::save_ppm(output_filename, image_data, params.width, params.height);
-        auto save_time = std::chrono::high_resolution_clock::now();
+        #ifdef OPENMP_VERSION
+        MandelbrotOMP::remove_checkpoint(omp_options.checkpoint_file);
+        #endif
+        auto save_time = std::chrono::steady_clock::now();
+        
+        #ifdef OPENMP_VERSION
+        if (!cost_map_filename.empty()) {
+            MandelbrotCPU::save_ppm(cost_map_filename, MandelbrotCPU::cost_heatmap_rgb(pixel_costs, params.max_iter),
+                                    cost_map_width, cost_map_height);
+            const MandelbrotCPU::CostSummary cost = MandelbrotCPU::summarize_costs(pixel_costs);
+            std::cout << "🔥 代价分布 (迭代/像素): 均值 " << cost.mean << ", p50 " << cost.p50
+                      << ", p90 " << cost.p90 << ", p99 " << cost.p99 << ", 最大 " << cost.max << std::endl;
+            std::cout << "🔥 代价集中度: 前1%像素占 " << static_cast<int>(cost.top1_share * 100)
+                      << "%, 前10%像素占 " << static_cast<int>(cost.top10_share * 100) << "% 的迭代" << std::endl;
+            if (print_stats) {
+                std::cerr << cost.to_json() << std::endl;
+            }
+        }
+        if (trace) {
+            trace->add(MandelbrotCPU::TraceRecorder::kMainThread, "render", "compute", start_time, render_time);
+            trace->add(MandelbrotCPU::TraceRecorder::kMainThread, "write_ppm", "io", render_time, save_time);
+            if (trace->write(trace_filename)) {
+                std::cout << "🧭 时间线已保存: " << trace_filename << " (" << trace->event_count() << " 个区间)" << std::endl;
+            } else {
+                std::cerr << "[ERROR] 无法写入时间线文件: " << trace_filename << std::endl;
+            }
+        }
+        #endif
         
         // 性能统计
         auto total_render_ms = std::chrono::duration_cast<std::chrono::milliseconds>(render_time - start_time).count();
@@ -280,7 +526,7 @@ int main(int argc, char* argv[]) {
         std::cout << "⏱️  渲染耗时: " << total_render_ms << " ms" << std::endl;
         std::cout << "💾 保存耗时: " << total_save_ms << " ms" << std::endl;
         std::cout << "🚀 总耗时: " << (total_render_ms + total_save_ms) << " ms" << std::endl;
-        std::cout << "📊 渲染速度: " << (params.width * params.height * 1000.0 / total_render_ms) << " 像素/秒" << std::endl;
+        std::cout << "📊 渲染速度: " << (static_cast<double>(params.width) * params.height * 1000.0 / total_render_ms) << " 像素/秒" << std::endl;
         
         if (mode == RenderMode::OPENMP) {
             #ifdef OPENMP_VERSION
@@ -0,0 +1,166 @@
+/**
+ * Mandelbulb 光线步进渲染测试
+ *
+ * 使用 include/mandelbulb.hpp 的光线包步进器 (与 fractal_api --fractal mandelbulb 相同),
+ * 把画面切成 16x16 的分块交给 RenderPool 动态调度, 报告:
+ * - 渲染耗时与每秒像素数
+ * - 每像素平均/最大步进次数 (主光线)
+ * - 每个光线包的宽度 (AVX: 4, SSE2/NEON: 2)
+ *
+ * 使用示例:
+ * ./mandelbulb_test --width 1920 --height 1080 --power 8
+ * ./mandelbulb_test --power 3 --yaw 60 --pitch 45 --zoom 1.5 --output output/mandelbulb3.ppm
+ *
+ * 作者: Geoffrey Wang (with Claude AI assistance)
+ */
+
+#include "../include/mandelbulb.hpp"
+#include "../include/render.hpp"
+#include "../include/render_pool.hpp"
+#include "../include/render_trace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <omp.h>
+#include <string>
+#include <vector>
+
+using namespace MandelbrotOMP;
+
+namespace {
+
+    void print_usage(const char* program_name) {
+        std::cout << "\n=== Mandelbulb 光线步进渲染 ===" << std::endl;
+        std::cout << "用法: " << program_name << " [选项]" << std::endl;
+        std::cout << "\n选项:" << std::endl;
+        std::cout << "  --width <w>      图像宽度 (默认: 800)" << std::endl;
+        std::cout << "  --height <h>     图像高度 (默认: 600)" << std::endl;
+        std::cout << "  --power <n>      Mandelbulb幂次, 2-16 (默认: 8)" << std::endl;
+        std::cout << "  --iter <n>       距离估计迭代次数 (默认: 10)" << std::endl;
+        std::cout << "  --steps <n>      每条主光线的最大步进次数 (默认: 256)" << std::endl;
+        std::cout << "  --yaw <deg>      相机绕极轴的角度 (默认: 30)" << std::endl;
+        std::cout << "  --pitch <deg>    相机仰角 (默认: 20)" << std::endl;
+        std::cout << "  --zoom <z>       焦距倍数 (默认: 1.0)" << std::endl;
+        std::cout << "  --no-ao          关闭环境光遮蔽" << std::endl;
+        std::cout << "  --no-shadows     关闭阴影光线" << std::endl;
+        std::cout << "  --threads <n>    线程数 (默认: 自动检测)" << std::endl;
+        std::cout << "  --output <file>  输出文件 (默认: output/mandelbulb.ppm)" << std::endl;
+        std::cout << "  --trace <file>   输出Chrome trace-event时间线 (每线程分块)" << std::endl;
+        std::cout << "  --help           显示此帮助信息" << std::endl;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    MandelbulbParams params;
+    int num_threads = 0;
+    std::string output_file = "output/mandelbulb.ppm";
+    std::string trace_file;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "--width" && i + 1 < argc) {
+            params.width = std::atoi(argv[++i]);
+        } else if (arg == "--height" && i + 1 < argc) {
+            params.height = std::atoi(argv[++i]);
+        } else if (arg == "--power" && i + 1 < argc) {
+            params.power = std::atoi(argv[++i]);
+        } else if (arg == "--iter" && i + 1 < argc) {
+            params.iterations = std::atoi(argv[++i]);
+        } else if (arg == "--steps" && i + 1 < argc) {
+            params.maxSteps = std::atoi(argv[++i]);
+        } else if (arg == "--yaw" && i + 1 < argc) {
+            params.yaw = std::atof(argv[++i]);
+        } else if (arg == "--pitch" && i + 1 < argc) {
+            params.pitch = std::atof(argv[++i]);
+        } else if (arg == "--zoom" && i + 1 < argc) {
+            params.zoom = std::atof(argv[++i]);
+        } else if (arg == "--no-ao") {
+            params.ambientOcclusion = false;
+        } else if (arg == "--no-shadows") {
+            params.shadows = false;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            num_threads = std::atoi(argv[++i]);
+        } else if (arg == "--output" && i + 1 < argc) {
+            output_file = argv[++i];
+        } else if (arg == "--trace" && i + 1 < argc) {
+            trace_file = argv[++i];
+        } else {
+            std::cerr << "错误: 未知参数 " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (params.width < 2 || params.height < 2 || params.iterations <= 0 || params.maxSteps <= 0) {
+        std::cerr << "错误: 图像尺寸至少为2x2, 迭代次数与步进次数必须为正数" << std::endl;
+        return 1;
+    }
+    if (params.power < 2 || params.power > 16 || params.zoom <= 0.0) {
+        std::cerr << "错误: 幂次必须在 2-16 范围内, 焦距倍数必须为正数" << std::endl;
+        return 1;
+    }
+
+    RenderPool& pool = RenderPool::global();
+    pool.configure(num_threads);
+
+    std::unique_ptr<MandelbrotCPU::TraceRecorder> trace;
+    if (!trace_file.empty()) {
+        trace = std::make_unique<MandelbrotCPU::TraceRecorder>("mandelbulb_test");
+        trace->ensure_threads(pool.num_threads());
+    }
+
+    MandelbulbRenderer renderer(params);
+    const int tiles = renderer.tilesX() * renderer.tilesY(params.height);
+    std::cout << "\n=== Mandelbulb 光线步进渲染 ===" << std::endl;
+    std::cout << "图像: " << params.width << "x" << params.height
+              << ", 幂次: " << params.power
+              << ", 分块: " << tiles << " (" << MandelbulbRenderer::kTileSize << "x" << MandelbulbRenderer::kTileSize << ")"
+              << ", 线程: " << pool.num_threads()
+              << ", 光线包: " << kBulbLanes << " 条" << std::endl;
+
+    MandelbrotCPU::ImageBuffer image(static_cast<size_t>(params.width) * params.height * 3);
+    std::vector<int> steps(static_cast<size_t>(params.width) * params.height);
+
+    // 整幅画面作为一个行带, 分块之间互不相干, 由线程池按块动态领取
+    auto start_time = std::chrono::steady_clock::now();  // 单调时钟, 与时间线追踪共用时间基准
+    pool.parallel_for(tiles, [&](int tile) {
+        MandelbrotCPU::TraceSpan span(trace.get(), omp_get_thread_num(), "tile", "compute", tile);
+        renderer.renderTile(tile, 0, params.height, image.data(), steps.data());
+    });
+    auto render_time = std::chrono::steady_clock::now();
+
+    MandelbrotCPU::save_ppm(output_file, image, params.width, params.height);
+    auto save_time = std::chrono::steady_clock::now();
+
+    long long total_steps = 0;
+    int max_steps = 0;
+    for (int s : steps) {
+        total_steps += s;
+        max_steps = std::max(max_steps, s);
+    }
+    const double seconds = std::chrono::duration<double>(render_time - start_time).count();
+    const double pixels = static_cast<double>(params.width) * params.height;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "⏱️  渲染耗时: " << seconds << "s" << std::endl;
+    std::cout << std::setprecision(2);
+    std::cout << "🔦 吞吐: " << (seconds > 0.0 ? pixels / seconds / 1e6 : 0.0) << " M像素/s"
+              << ", 每像素步进: 平均 " << total_steps / pixels << ", 最大 " << max_steps << std::endl;
+
+    if (trace) {
+        trace->add(MandelbrotCPU::TraceRecorder::kMainThread, "render", "compute", start_time, render_time);
+        trace->add(MandelbrotCPU::TraceRecorder::kMainThread, "write_ppm", "io", render_time, save_time);
+        if (trace->write(trace_file)) {
+            std::cout << "🧭 时间线已保存: " << trace_file << " (" << trace->event_count() << " 个区间)" << std::endl;
+        } else {
+            std::cerr << "[ERROR] 无法写入时间线文件: " << trace_file << std::endl;
+        }
+    }
+    return 0;
+}
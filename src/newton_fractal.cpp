@@ -10,7 +10,7 @@ NewtonFractalCPU::NewtonFractalCPU(int width, int height, int max_iterations)
     fractal_data_.resize(height_, std::vector<std::pair<int, int>>(width_, {-1, 0}));
 }
 
-void NewtonFractalCPU::render(double center_x, double center_y, double zoom) {
+double NewtonFractalCPU::render(double center_x, double center_y, double zoom) {
     auto start_time = std::chrono::high_resolution_clock::now();
     
     // Calculate the complex plane bounds
@@ -19,6 +19,7 @@ void NewtonFractalCPU::render(double center_x, double center_y, double zoom) {
     double max_x = center_x + scale / 2.0;
     double min_y = center_y - scale / 2.0;
     double max_y = center_y + scale / 2.0;
+    counters_ = MandelbrotCPU::RenderCounters();
     
     // Render each pixel
     for (int y = 0; y < height_; ++y) {
@@ -30,6 +31,7 @@ void NewtonFractalCPU::render(double center_x, double center_y, double zoom) {
             // Compute Newton iterations for this point
             std::complex<double> z(cx, cy);
             int iterations = 0;
+            bool converged = false;
             
             // Newton's method iteration
             while (iterations < max_iterations_) {
@@ -38,6 +40,7 @@ void NewtonFractalCPU::render(double center_x, double center_y, double zoom) {
                 
                 // Check for convergence
                 if (std::abs(z - z_old) < CONVERGENCE_THRESHOLD) {
+                    converged = true;
                     break;
                 }
                 iterations++;
@@ -46,6 +49,7 @@ void NewtonFractalCPU::render(double center_x, double center_y, double zoom) {
             // Identify which root we converged to
             int root = identifyRoot(z);
             fractal_data_[y][x] = {root, iterations};
+            counters_.add_pixel(converged ? iterations + 1 : iterations, root != 0);
         }
     }
     
@@ -57,13 +61,34 @@ void NewtonFractalCPU::render(double center_x, double center_y, double zoom) {
     std::cout << "分辨率: " << width_ << "x" << height_ << std::endl;
     std::cout << "渲染时间: " << duration.count() << " ms" << std::endl;
     std::cout << "性能: " << (width_ * height_) / (duration.count() / 1000.0) << " 像素/秒" << std::endl;
+    
+    return duration.count();
 }
 
-void NewtonFractalCPU::renderToFile(const std::string& filename, double center_x, 
+double NewtonFractalCPU::renderToFile(const std::string& filename, double center_x, 
                                    double center_y, double zoom) {
-    render(center_x, center_y, zoom);
+    double elapsed_ms = render(center_x, center_y, zoom);
     saveAsPPM(filename);
     std::cout << "输出文件: " << filename << std::endl;
+    return elapsed_ms;
+}
+
+int NewtonFractalCPU::computeNewton(double cx, double cy) const {
+    // Same iteration as render(), returning only the iteration count
+    std::complex<double> z(cx, cy);
+    int iterations = 0;
+    
+    while (iterations < max_iterations_) {
+        std::complex<double> z_old = z;
+        z = newtonIteration(z);
+        
+        if (std::abs(z - z_old) < CONVERGENCE_THRESHOLD) {
+            break;
+        }
+        iterations++;
+    }
+    
+    return iterations;
 }
 
 std::complex<double> NewtonFractalCPU::newtonIteration(const std::complex<double>& z) const {
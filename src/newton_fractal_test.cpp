@@ -1,33 +1,55 @@
 #include "newton_fractal.hpp"
 #include <iostream>
+#include <string>
 
-int main() {
+int main(int argc, char* argv[]) {
+    // --stats: 每次渲染后在stderr输出热路径计数 (JSON, escaped为收敛到根的像素数)
+    bool print_stats = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--stats") {
+            print_stats = true;
+        } else {
+            std::cerr << "用法: " << argv[0] << " [--stats]" << std::endl;
+            return 1;
+        }
+    }
+    
     std::cout << "\n=== 渲染 Newton Fractal ===" << std::endl;
     
     // Create Newton fractal renderer
     NewtonFractalCPU renderer(800, 600, 100);
     
     // Render classic view showing all three basins
-    renderer.renderToFile("newton_classic.ppm", 
-                         NewtonPresets::CLASSIC_X, 
-                         NewtonPresets::CLASSIC_Y, 
-                         NewtonPresets::CLASSIC_ZOOM);
+    double elapsed_ms = renderer.renderToFile("newton_classic.ppm", 
+                                              NewtonPresets::CLASSIC_X, 
+                                              NewtonPresets::CLASSIC_Y, 
+                                              NewtonPresets::CLASSIC_ZOOM);
+    if (print_stats) {
+        std::cerr << renderer.getCounters().to_json("newton", elapsed_ms / 1000.0) << std::endl;
+    }
     
     std::cout << "\n=== 渲染 Boundary Detail View ===" << std::endl;
     
     // Render detailed boundary view
-    renderer.renderToFile("newton_boundary.ppm", 
-                         NewtonPresets::BOUNDARY_X, 
-                         NewtonPresets::BOUNDARY_Y, 
-                         NewtonPresets::BOUNDARY_ZOOM);
+    elapsed_ms = renderer.renderToFile("newton_boundary.ppm", 
+                                       NewtonPresets::BOUNDARY_X, 
+                                       NewtonPresets::BOUNDARY_Y, 
+                                       NewtonPresets::BOUNDARY_ZOOM);
+    if (print_stats) {
+        std::cerr << renderer.getCounters().to_json("newton", elapsed_ms / 1000.0) << std::endl;
+    }
     
     std::cout << "\n=== 渲染 Fractal Edge Detail ===" << std::endl;
     
     // Render fractal edge detail
-    renderer.renderToFile("newton_edge.ppm", 
-                         NewtonPresets::FRACTAL_EDGE_X, 
-                         NewtonPresets::FRACTAL_EDGE_Y, 
-                         NewtonPresets::FRACTAL_EDGE_ZOOM);
+    elapsed_ms = renderer.renderToFile("newton_edge.ppm", 
+                                       NewtonPresets::FRACTAL_EDGE_X, 
+                                       NewtonPresets::FRACTAL_EDGE_Y, 
+                                       NewtonPresets::FRACTAL_EDGE_ZOOM);
+    if (print_stats) {
+        std::cerr << renderer.getCounters().to_json("newton", elapsed_ms / 1000.0) << std::endl;
+    }
     
     std::cout << "\n🎯 Newton Fractal 演示完成！" << std::endl;
     std::cout << "📁 生成的文件:" << std::endl;
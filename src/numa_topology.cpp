@@ -0,0 +1,168 @@
+/**
+ * NUMA拓扑检测与线程绑定实现
+ *
+ * 作者: Geoffrey Wang (with Claude AI assistance)
+ * 日期: 2025-08-12
+ */
+
+#include "../include/numa_topology.hpp"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace MandelbrotOMP {
+
+    namespace {
+
+        // 解析形如 "0-3,8-11" 的CPU列表
+        std::vector<int> parse_cpu_list(const std::string& text) {
+            std::vector<int> cpus;
+            std::stringstream stream(text);
+            std::string range;
+
+            while (std::getline(stream, range, ',')) {
+                if (range.empty() || range == "\n") continue;
+                size_t dash = range.find('-');
+                try {
+                    if (dash == std::string::npos) {
+                        cpus.push_back(std::stoi(range));
+                    } else {
+                        int first = std::stoi(range.substr(0, dash));
+                        int last = std::stoi(range.substr(dash + 1));
+                        for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+                    }
+                } catch (const std::exception&) {
+                    // 忽略无法解析的片段
+                }
+            }
+
+            return cpus;
+        }
+
+        std::vector<int> allowed_cpus() {
+            std::vector<int> cpus;
+#ifdef __linux__
+            cpu_set_t mask;
+            CPU_ZERO(&mask);
+            if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+                for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                    if (CPU_ISSET(cpu, &mask)) cpus.push_back(cpu);
+                }
+            }
+#endif
+            return cpus;
+        }
+
+        NumaTopology detect_topology() {
+            NumaTopology topology;
+            std::vector<int> allowed = allowed_cpus();
+
+#ifdef __linux__
+            DIR* dir = opendir("/sys/devices/system/node");
+            if (dir) {
+                while (dirent* entry = readdir(dir)) {
+                    std::string name = entry->d_name;
+                    if (name.compare(0, 4, "node") != 0 || name.size() <= 4 ||
+                        !std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+                        continue;
+                    }
+
+                    std::ifstream cpulist("/sys/devices/system/node/" + name + "/cpulist");
+                    std::string text;
+                    std::getline(cpulist, text);
+
+                    NumaNode node{std::stoi(name.substr(4)), {}};
+                    for (int cpu : parse_cpu_list(text)) {
+                        if (allowed.empty() || std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) {
+                            node.cpus.push_back(cpu);
+                        }
+                    }
+                    if (!node.cpus.empty()) {
+                        topology.nodes.push_back(node);
+                    }
+                }
+                closedir(dir);
+            }
+#endif
+
+            if (topology.nodes.empty()) {
+                topology.nodes.push_back({0, allowed});
+            }
+            std::sort(topology.nodes.begin(), topology.nodes.end(),
+                      [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+
+            return topology;
+        }
+
+    } // namespace
+
+    int NumaTopology::total_cpus() const {
+        int total = 0;
+        for (const NumaNode& node : nodes) total += static_cast<int>(node.cpus.size());
+        return total;
+    }
+
+    const NumaTopology& get_numa_topology() {
+        static const NumaTopology topology = detect_topology();
+        return topology;
+    }
+
+    std::vector<int> assign_threads_to_nodes(const NumaTopology& topology, int num_threads) {
+        std::vector<int> thread_nodes(std::max(0, num_threads), 0);
+        const int total_cpus = std::max(1, topology.total_cpus());
+        const int num_nodes = static_cast<int>(topology.nodes.size());
+
+        // 线程t的"中点"落在哪个节点的CPU累计区间内, 就属于哪个节点
+        for (int t = 0; t < num_threads; ++t) {
+            double position = (t + 0.5) * total_cpus / num_threads;
+            int cumulative = 0;
+            int node = num_nodes - 1;
+            for (int n = 0; n < num_nodes; ++n) {
+                cumulative += static_cast<int>(topology.nodes[n].cpus.size());
+                if (position < cumulative) {
+                    node = n;
+                    break;
+                }
+            }
+            thread_nodes[t] = node;
+        }
+
+        return thread_nodes;
+    }
+
+    bool pin_current_thread(const std::vector<int>& cpus) {
+#ifdef __linux__
+        if (cpus.empty()) return false;
+
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        for (int cpu : cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &mask);
+        }
+        return pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) == 0;
+#else
+        (void)cpus;
+        return false;
+#endif
+    }
+
+    std::string get_numa_info() {
+        const NumaTopology& topology = get_numa_topology();
+        std::ostringstream info;
+
+        info << "NUMA节点数: " << topology.nodes.size() << std::endl;
+        for (const NumaNode& node : topology.nodes) {
+            info << "  节点 " << node.id << ": " << node.cpus.size() << " 个CPU" << std::endl;
+        }
+
+        return info.str();
+    }
+
+} // namespace MandelbrotOMP
@@ -0,0 +1,134 @@
+/**
+ * 硬件性能计数器实现 (perf_event_open)
+ *
+ * 作者: Geoffrey Wang (with Claude AI assistance)
+ * 日期: 2025-08-12
+ */
+
+#include "../include/perf_counters.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace MandelbrotCPU {
+
+    void PerfSample::add(const PerfSample& other) {
+        for (int i = 0; i < NumEvents; ++i) {
+            values[i] += other.values[i];
+            valid[i] = valid[i] || other.valid[i];
+        }
+    }
+
+#ifdef __linux__
+
+    namespace {
+
+        const char* const EVENT_NAMES[PerfSample::NumEvents] = {"cycles", "instructions", "branch-misses", "cache-misses"};
+        const uint64_t EVENT_CONFIGS[PerfSample::NumEvents] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES
+        };
+
+        int open_event(uint64_t config) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            // 本线程, 任意CPU
+            return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+
+        std::string paranoid_level() {
+            std::ifstream file("/proc/sys/kernel/perf_event_paranoid");
+            std::string level;
+            if (file >> level) return level;
+            return "?";
+        }
+
+    } // namespace
+
+    PerfCounters::PerfCounters() {
+        std::string missing;
+        int first_errno = 0;
+        for (int i = 0; i < PerfSample::NumEvents; ++i) {
+            fds_[i] = open_event(EVENT_CONFIGS[i]);
+            if (fds_[i] >= 0) {
+                ++num_open_;
+            } else {
+                if (!first_errno) first_errno = errno;
+                missing += missing.empty() ? EVENT_NAMES[i] : std::string(", ") + EVENT_NAMES[i];
+            }
+        }
+
+        if (num_open_ < PerfSample::NumEvents) {
+            reason_ = missing + ": " + std::strerror(first_errno);
+            if (first_errno == EACCES || first_errno == EPERM) {
+                reason_ += " (perf_event_paranoid=" + paranoid_level() + ")";
+            } else if (first_errno == ENOENT || first_errno == EOPNOTSUPP) {
+                reason_ += " (硬件事件不受支持, 常见于虚拟机/容器)";
+            }
+        }
+    }
+
+    PerfCounters::~PerfCounters() {
+        for (int fd : fds_) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    void PerfCounters::start() {
+        for (int fd : fds_) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    PerfSample PerfCounters::stop() {
+        for (int fd : fds_) {
+            if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+
+        PerfSample sample;
+        for (int i = 0; i < PerfSample::NumEvents; ++i) {
+            if (fds_[i] < 0) continue;
+
+            uint64_t data[3];  // value, time_enabled, time_running
+            if (read(fds_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) continue;
+
+            // 计数器被复用时按实际计数时间比例外推
+            double value = static_cast<double>(data[0]);
+            if (data[2] < data[1]) value *= static_cast<double>(data[1]) / data[2];
+            sample.values[i] = static_cast<uint64_t>(value);
+            sample.valid[i] = true;
+        }
+        return sample;
+    }
+
+#else
+
+    PerfCounters::PerfCounters() : reason_("perf_event_open 仅在Linux上可用") {
+        for (int& fd : fds_) fd = -1;
+    }
+
+    PerfCounters::~PerfCounters() {}
+
+    void PerfCounters::start() {}
+
+    PerfSample PerfCounters::stop() { return PerfSample(); }
+
+#endif
+
+} // namespace MandelbrotCPU
@@ -39,8 +39,10 @@ namespace MandelbrotCPU {
         }
         
         // 使用HSV到RGB的彩色映射
-        double t = static_cast<double>(iterations) / max_iter;
-        
+        return palette_color(static_cast<double>(iterations) / max_iter);
+    }
+
+    RGB palette_color(double t) {
         // 创建彩虹色谱
         int r, g, b;
         if (t < 0.16) {
@@ -74,7 +76,7 @@ namespace MandelbrotCPU {
                   static_cast<unsigned char>(b));
     }
 
-    std::vector<unsigned char> render_mandelbrot_cpu(const RenderParams& params) {
+    ImageBuffer render_mandelbrot_cpu(const RenderParams& params, RenderCounters* counters) {
         std::cout << "[CPU] 开始渲染 Mandelbrot 集合..." << std::endl;
         std::cout << "[CPU] 分辨率: " << params.width << "x" << params.height << std::endl;
         std::cout << "[CPU] 最大迭代: " << params.max_iter << std::endl;
@@ -83,8 +85,9 @@ namespace MandelbrotCPU {
         
         auto start_time = std::chrono::high_resolution_clock::now();
         
-        int total_pixels = params.width * params.height;
-        std::vector<unsigned char> image_data(total_pixels * 3);
+        const size_t total_pixels = static_cast<size_t>(params.width) * params.height;
+        ImageBuffer image_data(total_pixels * 3);
+        RenderCounters local_counters;
         
         // CPU单线程渲染
         for (int py = 0; py < params.height; ++py) {
@@ -95,12 +98,13 @@ namespace MandelbrotCPU {
                 
                 // 计算该点的迭代次数
                 int iterations = mandelbrot_iterations(real, imag, params.max_iter);
+                local_counters.add_escape_time(iterations, params.max_iter);
                 
                 // 转换为颜色
                 RGB color = iterations_to_color(iterations, params.max_iter);
                 
                 // 存储RGB数据
-                int pixel_index = (py * params.width + px) * 3;
+                size_t pixel_index = (static_cast<size_t>(py) * params.width + px) * 3;
                 image_data[pixel_index] = color.r;     // Red
                 image_data[pixel_index + 1] = color.g; // Green  
                 image_data[pixel_index + 2] = color.b; // Blue
@@ -117,30 +121,49 @@ namespace MandelbrotCPU {
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
         
         std::cout << "[CPU] 渲染完成! 耗时: " << duration.count() << " ms" << std::endl;
-        std::cout << "[CPU] 性能: " << (total_pixels * 1000.0 / duration.count()) << " 像素/秒" << std::endl;
+        std::cout << "[CPU] 性能: " << (static_cast<double>(total_pixels) * 1000.0 / duration.count()) << " 像素/秒" << std::endl;
+        
+        if (counters) {
+            *counters = local_counters;
+        }
         
         return image_data;
     }
 
+    namespace {
+
+        void write_ppm(const std::string& filename, const unsigned char* data, size_t size,
+                       int width, int height) {
+            std::ofstream file(filename, std::ios::binary);
+            if (!file) {
+                std::cerr << "[ERROR] 无法创建文件: " << filename << std::endl;
+                return;
+            }
+            
+            // PPM文件头
+            file << "P6\n";
+            file << width << " " << height << "\n";
+            file << "255\n";
+            
+            // 写入像素数据
+            file.write(reinterpret_cast<const char*>(data), size);
+            file.close();
+            
+            std::cout << "[CPU] 图像已保存: " << filename << std::endl;
+        }
+
+    } // namespace
+
     void save_ppm(const std::string& filename, 
                   const std::vector<unsigned char>& image_data,
                   int width, int height) {
-        std::ofstream file(filename, std::ios::binary);
-        if (!file) {
-            std::cerr << "[ERROR] 无法创建文件: " << filename << std::endl;
-            return;
-        }
-        
-        // PPM文件头
-        file << "P6\n";
-        file << width << " " << height << "\n";
-        file << "255\n";
-        
-        // 写入像素数据
-        file.write(reinterpret_cast<const char*>(image_data.data()), image_data.size());
-        file.close();
-        
-        std::cout << "[CPU] 图像已保存: " << filename << std::endl;
+        write_ppm(filename, image_data.data(), image_data.size(), width, height);
+    }
+
+    void save_ppm(const std::string& filename,
+                  const ImageBuffer& image_data,
+                  int width, int height) {
+        write_ppm(filename, image_data.data(), image_data.size(), width, height);
     }
 
 } // namespace MandelbrotCPU
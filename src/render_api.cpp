@@ -8,15 +8,33 @@
  *   ./fractal_api --fractal mandelbrot --width 1920 --height 1080 \
  *                 --cx -0.5 --cy 0.0 --zoom 1.0 --iter 1000
  *
- * Supported fractals: mandelbrot, julia, burning_ship, newton
+ * Supported fractals: mandelbrot, julia, burning_ship, newton, tricorn, phoenix,
+ * mandelbulb (3D, ray-marched; see include/mandelbulb.hpp),
+ * custom (user formula, --formula "z^2 + c"; see include/formula_vm.hpp)
  */
 
 #include <iostream>
 #include <string>
+#include <algorithm>
 #include <cmath>
 #include <complex>
 #include <vector>
 #include <cstdint>
+#include <chrono>
+#include <fstream>
+#include <memory>
+
+#include "../include/fractal_kernels.hpp"
+#include "../include/render_counters.hpp"
+#include "../include/render_trace.hpp"
+#include "../include/cost_heatmap.hpp"
+#include "../include/image_resample.hpp"
+#include "../include/mandelbulb.hpp"
+#include "../include/formula_vm.hpp"
+
+// Count every operator new in this process for the --stats memory fields
+#define MANDELBROT_COUNT_ALLOCATIONS
+#include "../include/memory_stats.hpp"
 
 using Complex = std::complex<double>;
 
@@ -37,115 +55,19 @@ struct RenderParams {
     double juliaImag = 0.1889;
     double phoenixPx = 0.5667;
     double phoenixPy = 0.0;
+    int power = 8;          // Mandelbulb power
+    double yaw = 30.0;      // Mandelbulb camera orbit angles (degrees)
+    double pitch = 20.0;
+    std::string formula;    // Next-z expression for --fractal custom
+    bool progress = false;
+    bool stats = false;
+    std::string trace;      // Chrome trace-event output file (empty = off)
+    std::string costMap;    // Per-pixel iteration heatmap PPM file (empty = off)
+    std::string aa;         // Anti-aliasing mode: "de" = distance-estimator coverage (empty = off)
+    int supersample = 1;    // Render at n x n resolution and downsample in-process
+    MandelbrotCPU::ResampleFilter filter = MandelbrotCPU::ResampleFilter::Lanczos3;
 };
 
-// --- Fractal computation functions ---
-
-int mandelbrotIterations(double real, double imag, int maxIter) {
-    // Cardioid check
-    double cy2 = imag * imag;
-    double q = (real - 0.25) * (real - 0.25) + cy2;
-    if (q * (q + (real - 0.25)) <= 0.25 * cy2) return maxIter;
-    // Period-2 bulb
-    if ((real + 1.0) * (real + 1.0) + cy2 <= 0.0625) return maxIter;
-
-    double zx = 0.0, zy = 0.0, zx2 = 0.0, zy2 = 0.0;
-    for (int i = 0; i < maxIter; i++) {
-        if (zx2 + zy2 > 4.0) return i;
-        zy = 2.0 * zx * zy + imag;
-        zx = zx2 - zy2 + real;
-        zx2 = zx * zx;
-        zy2 = zy * zy;
-    }
-    return maxIter;
-}
-
-int juliaIterations(double real, double imag, double cReal, double cImag, int maxIter) {
-    double zx = real, zy = imag;
-    for (int i = 0; i < maxIter; i++) {
-        if (zx * zx + zy * zy > 4.0) return i;
-        double tmp = zx * zx - zy * zy + cReal;
-        zy = 2.0 * zx * zy + cImag;
-        zx = tmp;
-    }
-    return maxIter;
-}
-
-int burningShipIterations(double real, double imag, int maxIter) {
-    double zx = 0.0, zy = 0.0;
-    for (int i = 0; i < maxIter; i++) {
-        if (zx * zx + zy * zy > 4.0) return i;
-        double ax = std::abs(zx), ay = std::abs(zy);
-        double tmp = ax * ax - ay * ay + real;
-        zy = 2.0 * ax * ay + imag;
-        zx = tmp;
-    }
-    return maxIter;
-}
-
-int newtonIterations(double real, double imag, int maxIter) {
-    double zx = real, zy = imag;
-    const double tol = 1e-6;
-    const double roots[][2] = {{1.0, 0.0}, {-0.5, 0.866025403784}, {-0.5, -0.866025403784}};
-
-    for (int i = 0; i < maxIter; i++) {
-        double z2x = zx * zx - zy * zy;
-        double z2y = 2.0 * zx * zy;
-        double z3x = z2x * zx - z2y * zy;
-        double z3y = z2x * zy + z2y * zx;
-
-        double fx = z3x - 1.0;
-        double fy = z3y;
-        double fpx = 3.0 * z2x;
-        double fpy = 3.0 * z2y;
-
-        double denom = fpx * fpx + fpy * fpy;
-        if (denom < tol) break;
-
-        double qx = (fx * fpx + fy * fpy) / denom;
-        double qy = (fy * fpx - fx * fpy) / denom;
-        zx -= qx;
-        zy -= qy;
-
-        for (int j = 0; j < 3; j++) {
-            double dx = zx - roots[j][0];
-            double dy = zy - roots[j][1];
-            if (dx * dx + dy * dy < tol)
-                return (j + 1) * 1000 + i;
-        }
-    }
-    return 0;
-}
-
-// Tricorn (Mandelbar): z_{n+1} = conj(z)^2 + c
-int tricornIterations(double real, double imag, int maxIter) {
-    double zx = 0.0, zy = 0.0, zx2 = 0.0, zy2 = 0.0;
-    for (int i = 0; i < maxIter; i++) {
-        if (zx2 + zy2 > 4.0) return i;
-        zy = -2.0 * zx * zy + imag;
-        zx = zx2 - zy2 + real;
-        zx2 = zx * zx;
-        zy2 = zy * zy;
-    }
-    return maxIter;
-}
-
-// Phoenix: z_{n+1} = z_n^2 + p_re + p_im * z_{n-1}
-int phoenixIterations(double real, double imag, double pReal, double pImag, int maxIter) {
-    double zx = real, zy = imag;
-    double prevX = 0.0, prevY = 0.0;
-    double zx2 = zx * zx, zy2 = zy * zy;
-    for (int i = 0; i < maxIter; i++) {
-        if (zx2 + zy2 > 4.0) return i;
-        double nx = zx2 - zy2 + pReal + pImag * prevX;
-        double ny = 2.0 * zx * zy + pImag * prevY;
-        prevX = zx; prevY = zy;
-        zx = nx; zy = ny;
-        zx2 = zx * zx; zy2 = zy * zy;
-    }
-    return maxIter;
-}
-
 // --- Color mapping ---
 
 RGB hsvToRgb(double h, double s, double v) {
@@ -191,7 +113,10 @@ RGB getColor(int iterations, const std::string& fractal, int maxIter) {
 
 void printUsage(const char* prog) {
     std::cerr << "Usage: " << prog << " [options]\n"
-              << "  --fractal <type>   mandelbrot|julia|burning_ship|newton|tricorn|phoenix (default: mandelbrot)\n"
+              << "  --fractal <type>   mandelbrot|julia|burning_ship|newton|tricorn|phoenix|mandelbulb|custom\n"
+              << "                     (default: mandelbrot)\n"
+              << "  --formula <expr>   Next z for --fractal custom, e.g. \"abs(z)^2 + c\": z, c, prev (previous z),\n"
+              << "                     numbers and 0.5i, + - * / ^, abs conj re im sqr exp log sin cos pow\n"
               << "  --width <w>        Image width (default: 800)\n"
               << "  --height <h>       Image height (default: 600)\n"
               << "  --cx <x>           Center X coordinate (default: -0.5)\n"
@@ -200,7 +125,23 @@ void printUsage(const char* prog) {
               << "  --iter <n>         Max iterations (default: 1000)\n"
               << "  --julia-real <r>   Julia C real part (default: -0.7269)\n"
               << "  --julia-imag <i>   Julia C imaginary part (default: 0.1889)\n"
+              << "  --power <n>        Mandelbulb power, 2-16 (default: 8)\n"
+              << "  --yaw <deg>        Mandelbulb camera angle around the pole axis (default: 30)\n"
+              << "  --pitch <deg>      Mandelbulb camera elevation (default: 20)\n"
+              << "                     For mandelbulb, --zoom scales the focal length, --iter caps the\n"
+              << "                     ray-march steps per pixel and --cx/--cy are ignored\n"
               << "  --format <fmt>     Output format: ppm (default: ppm)\n"
+              << "  --progress         Report progress on stderr (\"progress <0..1>\" lines, at most 10/s)\n"
+              << "  --stats            Print hot-path counters, peak RSS delta and allocation counts\n"
+              << "                     as one JSON line on stderr when done\n"
+              << "  --trace <file>     Write a Chrome trace-event timeline (per-row compute/colorize/write spans)\n"
+              << "  --cost-map <file>  Write a per-pixel iteration heatmap (PPM, log scale) and print\n"
+              << "                     cost percentiles as one JSON line on stderr\n"
+              << "  --aa de            Anti-alias boundary pixels by distance-estimated coverage\n"
+              << "                     (mandelbrot, julia, burning_ship, tricorn; no extra samples)\n"
+              << "  --supersample <n>  Render at n x n resolution (1-4) and stream rows through an\n"
+              << "                     in-process linear-light downsampler\n"
+              << "  --filter <name>    Downsampling filter: box|tent|lanczos3 (default: lanczos3)\n"
               << "\nOutputs PPM image data to stdout.\n";
 }
 
@@ -210,6 +151,8 @@ int main(int argc, char* argv[]) {
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
         if (arg == "--help" || arg == "-h") { printUsage(argv[0]); return 0; }
+        if (arg == "--progress") { p.progress = true; continue; }
+        if (arg == "--stats") { p.stats = true; continue; }
         if (i + 1 >= argc) { std::cerr << "Missing value for " << arg << "\n"; return 1; }
 
         std::string val = argv[++i];
@@ -224,6 +167,17 @@ int main(int argc, char* argv[]) {
         else if (arg == "--julia-imag") p.juliaImag = std::stod(val);
         else if (arg == "--phoenix-px") p.phoenixPx = std::stod(val);
         else if (arg == "--phoenix-py") p.phoenixPy = std::stod(val);
+        else if (arg == "--power") p.power = std::stoi(val);
+        else if (arg == "--yaw") p.yaw = std::stod(val);
+        else if (arg == "--pitch") p.pitch = std::stod(val);
+        else if (arg == "--formula") p.formula = val;
+        else if (arg == "--trace") p.trace = val;
+        else if (arg == "--cost-map") p.costMap = val;
+        else if (arg == "--aa") p.aa = val;
+        else if (arg == "--supersample") p.supersample = std::stoi(val);
+        else if (arg == "--filter") {
+            if (!MandelbrotCPU::parse_resample_filter(val, p.filter)) { std::cerr << "Invalid filter\n"; return 1; }
+        }
         else if (arg == "--format") { /* only ppm for now */ }
         else { std::cerr << "Unknown option: " << arg << "\n"; return 1; }
     }
@@ -233,46 +187,226 @@ int main(int argc, char* argv[]) {
     if (p.height <= 0 || p.height > 2160) { std::cerr << "Invalid height\n"; return 1; }
     if (p.maxIter <= 0 || p.maxIter > 10000) { std::cerr << "Invalid iterations\n"; return 1; }
     if (p.zoom <= 0) { std::cerr << "Invalid zoom\n"; return 1; }
+    if (p.supersample < 1 || p.supersample > 4) { std::cerr << "Invalid supersample factor\n"; return 1; }
+    if (p.power < 2 || p.power > 16) { std::cerr << "Invalid power\n"; return 1; }
+    if ((p.fractal == "custom") != !p.formula.empty()) {
+        std::cerr << "--formula is required by, and only valid with, --fractal custom\n";
+        return 1;
+    }
+    const bool distanceAA = p.aa == "de";
+    if (!p.aa.empty() && !distanceAA) { std::cerr << "Invalid anti-aliasing mode\n"; return 1; }
+    if (distanceAA && p.fractal != "mandelbrot" && p.fractal != "julia" &&
+        p.fractal != "burning_ship" && p.fractal != "tricorn") {
+        std::cerr << "Distance-estimator anti-aliasing is not available for " << p.fractal << "\n";
+        return 1;
+    }
+
+    // Supersampled renders iterate at n x n resolution; output rows come from the downsampler
+    const int renderWidth = p.width * p.supersample;
+    const int renderHeight = p.height * p.supersample;
 
     // Compute scale
     double scale = 4.0 / p.zoom;
     double startX = p.cx - scale / 2.0;
     double startY = p.cy - scale / 2.0;
-    double stepX = scale / p.width;
-    double stepY = scale / p.height;
+    double stepX = scale / renderWidth;
+    double stepY = scale / renderHeight;
+    double pixelSize = std::max(stepX, stepY);  // distance-estimator AA footprint
+
+    // The Mandelbulb is ray-marched in bands of tile rows; each band is shaded when its first
+    // row is reached and then streamed row by row like the 2D fractals
+    std::unique_ptr<MandelbulbRenderer> bulb;
+    if (p.fractal == "mandelbulb") {
+        MandelbulbParams bulbParams;
+        bulbParams.width = renderWidth;
+        bulbParams.height = renderHeight;
+        bulbParams.power = p.power;
+        bulbParams.maxSteps = p.maxIter;
+        bulbParams.yaw = p.yaw;
+        bulbParams.pitch = p.pitch;
+        bulbParams.zoom = p.zoom;
+        bulb = std::make_unique<MandelbulbRenderer>(bulbParams);
+    }
+    // Custom formulas are compiled once and interpreted a row at a time, kFormulaLanes pixels per step
+    std::unique_ptr<FormulaProgram> formula;
+    if (p.fractal == "custom") {
+        try {
+            formula = std::make_unique<FormulaProgram>(FormulaProgram::compile(p.formula));
+        } catch (const std::invalid_argument& e) {
+            std::cerr << "Invalid formula: " << e.what() << "\n";
+            return 1;
+        }
+    }
+    std::vector<int> formulaIters(formula ? renderWidth : 0);
+
+    const int bandRows = MandelbulbRenderer::kTileSize;
+    std::vector<uint8_t> band(bulb ? size_t(bandRows) * renderWidth * 3 : 0);
+    std::vector<int> bandSteps(bulb ? size_t(bandRows) * renderWidth : 0);
+
+    // Peak RSS and allocations from here to the end of the render
+    MandelbrotCPU::MemoryTracker memory;
+
+    // Timeline spans go to per-thread buffers and are written once at the end
+    std::unique_ptr<MandelbrotCPU::TraceRecorder> trace;
+    if (!p.trace.empty()) trace = std::make_unique<MandelbrotCPU::TraceRecorder>("fractal_api", 3 * renderHeight + 1);
+    const int mainThread = MandelbrotCPU::TraceRecorder::kMainThread;
 
     // Output PPM header
     std::cout << "P6\n" << p.width << " " << p.height << "\n255\n";
 
-    // Render
-    std::vector<uint8_t> row(p.width * 3);
-
-    for (int y = 0; y < p.height; y++) {
-        double imag = startY + y * stepY;
-        for (int x = 0; x < p.width; x++) {
-            double real = startX + x * stepX;
-
-            int iter = 0;
-            if (p.fractal == "mandelbrot")
-                iter = mandelbrotIterations(real, imag, p.maxIter);
-            else if (p.fractal == "julia")
-                iter = juliaIterations(real, imag, p.juliaReal, p.juliaImag, p.maxIter);
-            else if (p.fractal == "burning_ship")
-                iter = burningShipIterations(real, imag, p.maxIter);
-            else if (p.fractal == "newton")
-                iter = newtonIterations(real, imag, p.maxIter);
-            else if (p.fractal == "tricorn")
-                iter = tricornIterations(real, imag, p.maxIter);
-            else if (p.fractal == "phoenix")
-                iter = phoenixIterations(real, imag, p.phoenixPx, p.phoenixPy, p.maxIter);
-
-            RGB c = getColor(iter, p.fractal, p.maxIter);
-            int idx = x * 3;
-            row[idx] = c.r;
-            row[idx + 1] = c.g;
-            row[idx + 2] = c.b;
+    // Render: each row is iterated, then colorized, then written
+    std::vector<int> iters(renderWidth);
+    std::vector<double> distances(distanceAA ? renderWidth : 0);  // < 0 = did not escape
+    std::vector<uint8_t> row(renderWidth * 3);
+
+    // Supersampled rows are pushed into the downsampler as they are produced;
+    // it only keeps the filter window, never the full-resolution frame
+    std::unique_ptr<MandelbrotCPU::Downsampler> downsampler;
+    if (p.supersample > 1)
+        downsampler = std::make_unique<MandelbrotCPU::Downsampler>(renderWidth, renderHeight, p.width, p.height, p.filter);
+    const size_t outputRowBytes = size_t(p.width) * 3;
+
+    // Progress is reported between rows at a bounded rate, never per pixel
+    const auto progressInterval = std::chrono::milliseconds(100);
+    const auto renderStart = std::chrono::steady_clock::now();
+    auto nextProgress = renderStart + progressInterval;
+
+    // Per-pixel counters (a few integer adds per pixel, nothing inside the iteration loops)
+    MandelbrotCPU::RenderCounters counters;
+
+    // Iterations actually executed per pixel (interior shortcuts cost 0)
+    std::vector<int> costs;
+    if (!p.costMap.empty()) costs.resize(size_t(renderWidth) * renderHeight);
+
+    for (int y = 0; y < renderHeight; y++) {
+        if (bulb) {
+            if (y % bandRows == 0) {
+                MandelbrotCPU::TraceSpan span(trace.get(), mainThread, "band", "compute", y);
+                const int rows = std::min(bandRows, renderHeight - y);
+                const int tiles = bulb->tilesX() * bulb->tilesY(rows);
+                for (int tile = 0; tile < tiles; tile++) bulb->renderTile(tile, y, rows, band.data(), bandSteps.data());
+            }
+            // Cost per pixel is the number of primary-ray march steps
+            const size_t offset = size_t(y % bandRows) * renderWidth;
+            std::copy(band.begin() + offset * 3, band.begin() + (offset + renderWidth) * 3, row.begin());
+            for (int x = 0; x < renderWidth; x++) {
+                int executed = bandSteps[offset + x];
+                counters.add_pixel(executed, executed < p.maxIter);
+                if (!costs.empty()) costs[size_t(y) * renderWidth + x] = executed;
+            }
+        } else {
+            double imag = startY + y * stepY;
+            {
+                MandelbrotCPU::TraceSpan span(trace.get(), mainThread, "row", "compute", y);
+                if (formula) formula->iterateRow(startX, stepX, imag, renderWidth, p.maxIter, formulaIters.data());
+                for (int x = 0; x < renderWidth; x++) {
+                    double real = startX + x * stepX;
+
+                    int iter = 0;
+                    int executed = 0;
+                    if (p.fractal == "mandelbrot") {
+                        MandelbrotShortcut shortcut = mandelbrotShortcut(real, imag);
+                        if (shortcut == CardioidShortcut) {
+                            iter = p.maxIter;
+                            counters.add_cardioid_skip();
+                        } else if (shortcut == BulbShortcut) {
+                            iter = p.maxIter;
+                            counters.add_bulb_skip();
+                        } else if (distanceAA) {
+                            EscapeDistance de = mandelbrotDistance(real, imag, p.maxIter);
+                            iter = executed = de.iterations;
+                            distances[x] = de.distance;
+                            counters.add_escape_time(iter, p.maxIter);
+                        } else {
+                            iter = executed = mandelbrotEscapeIterations(real, imag, p.maxIter);
+                            counters.add_escape_time(iter, p.maxIter);
+                        }
+                        if (distanceAA && shortcut != NoShortcut) distances[x] = -1.0;
+                    } else if (p.fractal == "newton") {
+                        // Encoded as root * 1000 + iteration index, 0 when not converged
+                        iter = newtonIterations(real, imag, p.maxIter);
+                        executed = iter ? iter % 1000 + 1 : p.maxIter;
+                        counters.add_pixel(executed, iter != 0);
+                    } else if (formula) {
+                        iter = executed = formulaIters[x];
+                        counters.add_escape_time(iter, p.maxIter);
+                    } else if (distanceAA) {
+                        EscapeDistance de;
+                        if (p.fractal == "julia")
+                            de = juliaDistance(real, imag, p.juliaReal, p.juliaImag, p.maxIter);
+                        else if (p.fractal == "burning_ship")
+                            de = burningShipDistance(real, imag, p.maxIter);
+                        else
+                            de = tricornDistance(real, imag, p.maxIter);
+                        iter = executed = de.iterations;
+                        distances[x] = de.distance;
+                        counters.add_escape_time(iter, p.maxIter);
+                    } else {
+                        if (p.fractal == "julia")
+                            iter = juliaIterations(real, imag, p.juliaReal, p.juliaImag, p.maxIter);
+                        else if (p.fractal == "burning_ship")
+                            iter = burningShipIterations(real, imag, p.maxIter);
+                        else if (p.fractal == "tricorn")
+                            iter = tricornIterations(real, imag, p.maxIter);
+                        else if (p.fractal == "phoenix")
+                            iter = phoenixIterations(real, imag, p.phoenixPx, p.phoenixPy, p.maxIter);
+                        executed = iter;
+                        counters.add_escape_time(iter, p.maxIter);
+                    }
+                    iters[x] = iter;
+                    if (!costs.empty()) costs[size_t(y) * renderWidth + x] = executed;
+                }
+            }
+            {
+                MandelbrotCPU::TraceSpan span(trace.get(), mainThread, "colorize", "colorize", y);
+                for (int x = 0; x < renderWidth; x++) {
+                    RGB c = getColor(iters[x], p.fractal, p.maxIter);
+                    if (distanceAA && distances[x] >= 0.0 && distances[x] < pixelSize) {
+                        // The interior color is black, so blending by the exterior coverage of the
+                        // pixel (distance to the set over the pixel size) is a scale; done in linear light
+                        double coverage = std::pow(distances[x] / pixelSize, 1.0 / 2.2);
+                        c = RGB(uint8_t(c.r * coverage + 0.5), uint8_t(c.g * coverage + 0.5), uint8_t(c.b * coverage + 0.5));
+                    }
+                    int idx = x * 3;
+                    row[idx] = c.r;
+                    row[idx + 1] = c.g;
+                    row[idx + 2] = c.b;
+                }
+            }
+        }
+        {
+            MandelbrotCPU::TraceSpan span(trace.get(), mainThread, "write", "io", y);
+            if (downsampler) {
+                downsampler->push_rows(row.data(), 1, [&](int, const unsigned char* out) {
+                    std::cout.write(reinterpret_cast<const char*>(out), outputRowBytes);
+                });
+            } else {
+                std::cout.write(reinterpret_cast<const char*>(row.data()), row.size());
+            }
+        }
+
+        if (p.progress && std::chrono::steady_clock::now() >= nextProgress) {
+            std::cerr << "progress " << double(y + 1) / renderHeight << "\n" << std::flush;
+            nextProgress = std::chrono::steady_clock::now() + progressInterval;
         }
-        std::cout.write(reinterpret_cast<const char*>(row.data()), row.size());
+    }
+
+    if (p.progress) std::cerr << "progress 1\n" << std::flush;
+    if (p.stats) {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - renderStart).count();
+        std::cerr << counters.to_json("api", seconds, memory.finish().json_fields()) << "\n" << std::flush;
+    }
+    if (!costs.empty()) {
+        std::vector<unsigned char> heatmap = MandelbrotCPU::cost_heatmap_rgb(costs, p.maxIter);
+        std::ofstream file(p.costMap, std::ios::binary);
+        file << "P6\n" << renderWidth << " " << renderHeight << "\n255\n";
+        file.write(reinterpret_cast<const char*>(heatmap.data()), heatmap.size());
+        if (!file) { std::cerr << "Cannot write cost map: " << p.costMap << "\n"; return 1; }
+        std::cerr << MandelbrotCPU::summarize_costs(costs).to_json() << "\n" << std::flush;
+    }
+    if (trace) {
+        std::cout.flush();
+        if (!trace->write(p.trace)) { std::cerr << "Cannot write trace file: " << p.trace << "\n"; return 1; }
     }
 
     return 0;
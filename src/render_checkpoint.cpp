@@ -0,0 +1,204 @@
+/**
+ * Mandelbrot 分形渲染器 - 分块检查点日志实现
+ *
+ * 作者: Geoffrey Wang (with Claude AI assistance)
+ * 日期: 2025-08-12
+ */
+
+#include "../include/render_checkpoint.hpp"
+#include "../include/render_omp.hpp"
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace MandelbrotOMP {
+
+    namespace {
+
+        const char JOURNAL_MAGIC[4] = {'M', 'B', 'C', 'K'};
+        const uint32_t JOURNAL_VERSION = 1;
+
+        template <typename T>
+        void append_value(std::vector<unsigned char>& buffer, const T& value) {
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+        }
+
+        // FNV-1a 32位校验, 用于识别被中断写入的尾部记录
+        uint32_t fnv1a(const unsigned char* data, size_t size) {
+            uint32_t hash = 2166136261u;
+            for (size_t i = 0; i < size; ++i) {
+                hash ^= data[i];
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+
+        std::vector<unsigned char> make_header(const MandelbrotCPU::RenderParams& params,
+                                               int tile_size, int num_tiles) {
+            std::vector<unsigned char> header(JOURNAL_MAGIC, JOURNAL_MAGIC + 4);
+            append_value(header, JOURNAL_VERSION);
+            append_value(header, params.width);
+            append_value(header, params.height);
+            append_value(header, params.max_iter);
+            append_value(header, params.x_min);
+            append_value(header, params.x_max);
+            append_value(header, params.y_min);
+            append_value(header, params.y_max);
+            append_value(header, tile_size);
+            append_value(header, num_tiles);
+            return header;
+        }
+
+    } // namespace
+
+    CheckpointJournal::CheckpointJournal(const std::string& filename,
+                                         const MandelbrotCPU::RenderParams& params,
+                                         int tile_size, int num_tiles, int interval_ms)
+        : filename_(filename), params_(params), tile_size_(tile_size), num_tiles_(num_tiles),
+          interval_(interval_ms), last_flush_(std::chrono::steady_clock::now()) {}
+
+    CheckpointJournal::~CheckpointJournal() {
+        if (file_) {
+            flush();
+            std::fclose(file_);
+        }
+    }
+
+    int CheckpointJournal::restore(const std::vector<Tile>& tiles, MandelbrotCPU::ImageBuffer& image_data,
+                                   std::vector<char>& completed) {
+        completed.assign(tiles.size(), 0);
+        restored_bytes_ = 0;
+
+        std::FILE* in = std::fopen(filename_.c_str(), "rb");
+        if (!in) {
+            return 0;  // 无日志: 全新渲染
+        }
+
+        const std::vector<unsigned char> expected = make_header(params_, tile_size_, num_tiles_);
+        std::vector<unsigned char> header(expected.size());
+        if (std::fread(header.data(), 1, header.size(), in) != header.size() || header != expected) {
+            std::fclose(in);
+            throw std::runtime_error("检查点文件与当前渲染参数不匹配: " + filename_);
+        }
+
+        long long valid_bytes = static_cast<long long>(header.size());
+        int restored = 0;
+        std::vector<unsigned char> payload;
+
+        while (true) {
+            uint32_t tile_index = 0, payload_size = 0, checksum = 0;
+            if (std::fread(&tile_index, sizeof(tile_index), 1, in) != 1 ||
+                std::fread(&payload_size, sizeof(payload_size), 1, in) != 1) {
+                break;
+            }
+            if (tile_index >= tiles.size() ||
+                payload_size != static_cast<uint32_t>(tiles[tile_index].width) * tiles[tile_index].height * 3) {
+                break;
+            }
+
+            payload.resize(payload_size);
+            if (std::fread(payload.data(), 1, payload_size, in) != payload_size ||
+                std::fread(&checksum, sizeof(checksum), 1, in) != 1 ||
+                checksum != fnv1a(payload.data(), payload_size)) {
+                break;  // 中断写入的尾部记录
+            }
+
+            const Tile& tile = tiles[tile_index];
+            for (int ty = 0; ty < tile.height; ++ty) {
+                size_t dst = (static_cast<size_t>(tile.y0 + ty) * params_.width + tile.x0) * 3;
+                std::memcpy(image_data.data() + dst, payload.data() + static_cast<size_t>(ty) * tile.width * 3,
+                            static_cast<size_t>(tile.width) * 3);
+            }
+
+            if (!completed[tile_index]) {
+                completed[tile_index] = 1;
+                ++restored;
+            }
+            valid_bytes += 2 * sizeof(uint32_t) + payload_size + sizeof(uint32_t);
+        }
+
+        std::fclose(in);
+        restored_bytes_ = valid_bytes;
+        return restored;
+    }
+
+    void CheckpointJournal::open(bool append) {
+        if (append && restored_bytes_ > 0) {
+            // 截断无效尾部后继续追加
+            std::filesystem::resize_file(filename_, static_cast<std::uintmax_t>(restored_bytes_));
+            file_ = std::fopen(filename_.c_str(), "ab");
+        } else {
+            file_ = std::fopen(filename_.c_str(), "wb");
+            if (file_) {
+                write_header();
+            }
+        }
+
+        if (!file_) {
+            throw std::runtime_error("无法打开检查点文件: " + filename_);
+        }
+        last_flush_ = std::chrono::steady_clock::now();
+    }
+
+    void CheckpointJournal::write_header() {
+        const std::vector<unsigned char> header = make_header(params_, tile_size_, num_tiles_);
+        std::fwrite(header.data(), 1, header.size(), file_);
+        std::fflush(file_);
+    }
+
+    void CheckpointJournal::record_tile(int tile_index, const Tile& tile,
+                                        const MandelbrotCPU::ImageBuffer& image_data) {
+        const uint32_t payload_size = static_cast<uint32_t>(tile.width) * tile.height * 3;
+        bool due = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            append_value(pending_, static_cast<uint32_t>(tile_index));
+            append_value(pending_, payload_size);
+
+            const size_t payload_start = pending_.size();
+            for (int ty = 0; ty < tile.height; ++ty) {
+                size_t src = (static_cast<size_t>(tile.y0 + ty) * params_.width + tile.x0) * 3;
+                pending_.insert(pending_.end(), image_data.begin() + src,
+                                image_data.begin() + src + static_cast<size_t>(tile.width) * 3);
+            }
+            append_value(pending_, fnv1a(pending_.data() + payload_start, payload_size));
+
+            const auto now = std::chrono::steady_clock::now();
+            due = !flushing_ && now - last_flush_ >= interval_;
+            if (due) {
+                flushing_ = true;   // 本轮只由当前线程落盘
+                last_flush_ = now;
+            }
+        }
+
+        if (due) {
+            flush();  // 锁外写入, 其他线程继续向pending_追加
+        }
+    }
+
+    void CheckpointJournal::flush() {
+        std::lock_guard<std::mutex> io_lock(io_mutex_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            writing_.swap(pending_);  // pending_接手上一批次已清空的缓冲区
+            last_flush_ = std::chrono::steady_clock::now();
+        }
+
+        if (file_ && !writing_.empty()) {
+            if (std::fwrite(writing_.data(), 1, writing_.size(), file_) != writing_.size()) {
+                std::cerr << "[OpenMP] 警告: 检查点写入失败: " << filename_ << std::endl;
+            }
+            std::fflush(file_);
+            fsync(fileno(file_));
+        }
+        writing_.clear();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        flushing_ = false;  // 写入期间到期的线程不会排队等待磁盘
+    }
+
+} // namespace MandelbrotOMP
@@ -0,0 +1,300 @@
+/**
+ * Mandelbrot 分形渲染器 - MPI集群实现
+ *
+ * 本文件实现了基于MPI的多节点分布式渲染
+ * 主要策略:
+ * 1. 行带分块 + 动态master/worker调度 (按需分发, 自动负载均衡)
+ * 2. 节点内复用OpenMP并行分块渲染
+ * 3. MPI-IO集合写入: 每个节点用hindexed文件视图描述自己的行带,
+ *    一次MPI_File_write_all完成整图输出, 无需汇总到rank 0
+ *
+ * 作者: Geoffrey Wang (with Claude AI assistance)
+ * 日期: 2025-08-12
+ */
+
+#include "../include/render_mpi.hpp"
+#include "../include/render_pool.hpp"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+
+namespace MandelbrotMPI {
+
+    namespace {
+
+        // 调度消息标签
+        const int TAG_REQUEST = 1;     // worker -> master: 请求新分块
+        const int TAG_ASSIGN = 2;      // master -> worker: 分配的分块索引
+        const int NO_MORE_TILES = -1;  // 分配结束标记
+
+        void check_mpi(int status, const char* what) {
+            if (status != MPI_SUCCESS) {
+                char message[MPI_MAX_ERROR_STRING];
+                int length = 0;
+                MPI_Error_string(status, message, &length);
+                throw std::runtime_error(std::string("MPI错误 (") + what + "): " +
+                                         std::string(message, length));
+            }
+        }
+
+        std::string make_ppm_header(int width, int height) {
+            std::ostringstream header;
+            header << "P6\n" << width << " " << height << "\n255\n";
+            return header.str();
+        }
+
+        // 本节点已完成的分块 (索引递增, 像素数据按分块顺序连续存放)
+        struct LocalTiles {
+            std::vector<int> indices;
+            MandelbrotCPU::ImageBuffer pixels;
+            int total_rows = 0;
+            MandelbrotCPU::RenderCounters counters;
+        };
+
+        void render_local_tile(const RenderParams& params, const std::vector<Tile>& tiles,
+                               int index, LocalTiles& local) {
+            MandelbrotCPU::ImageBuffer tile_data = MandelbrotOMP::render_tile_omp(params, tiles[index], &local.counters);
+            local.indices.push_back(index);
+            local.pixels.insert(local.pixels.end(), tile_data.begin(), tile_data.end());
+            local.total_rows += tiles[index].height;
+        }
+
+        // rank 0: 响应分块请求直到所有worker收到结束标记
+        // dynamic_tiles为按需分发的分块 (未启用代价划分时即全部分块)
+        void run_master(const RenderParams& params, const std::vector<Tile>& tiles,
+                        const std::vector<int>& dynamic_tiles,
+                        int num_ranks, const MPIRenderConfig& config,
+                        MPIRenderStats& stats, LocalTiles& local, MPI_Comm comm) {
+            const int num_tiles = static_cast<int>(dynamic_tiles.size());
+            int next_tile = 0;
+
+            if (num_ranks == 1) {
+                // 单进程: 本地完成全部分块
+                for (; next_tile < num_tiles; ++next_tile) {
+                    render_local_tile(params, tiles, dynamic_tiles[next_tile], local);
+                }
+                stats.tiles_per_rank[0] = num_tiles;
+                return;
+            }
+
+            const int progress_step = std::max(1, num_tiles / 10);
+            int active_workers = num_ranks - 1;
+
+            while (active_workers > 0) {
+                int request = 0;
+                MPI_Status status;
+                MPI_Recv(&request, 1, MPI_INT, MPI_ANY_SOURCE, TAG_REQUEST, comm, &status);
+
+                int assignment = NO_MORE_TILES;
+                if (next_tile < num_tiles) {
+                    assignment = dynamic_tiles[next_tile++];
+                    stats.tiles_per_rank[status.MPI_SOURCE]++;
+
+                    if (config.verbose && next_tile % progress_step == 0) {
+                        std::cout << "[MPI] 调度进度: " << (next_tile * 100) / num_tiles
+                                  << "% (分块 " << next_tile << "/" << num_tiles << ")" << std::endl;
+                    }
+                } else {
+                    --active_workers;
+                }
+
+                MPI_Send(&assignment, 1, MPI_INT, status.MPI_SOURCE, TAG_ASSIGN, comm);
+            }
+        }
+
+        // rank > 0: 先渲染静态分配的分块, 再循环请求分块并渲染, 直到收到结束标记
+        void run_worker(const RenderParams& params, const std::vector<Tile>& tiles,
+                        const std::vector<int>& static_tiles, LocalTiles& local, MPI_Comm comm) {
+            for (int index : static_tiles) {
+                render_local_tile(params, tiles, index, local);
+            }
+
+            while (true) {
+                int request = 0;
+                int assignment = NO_MORE_TILES;
+                MPI_Send(&request, 1, MPI_INT, 0, TAG_REQUEST, comm);
+                MPI_Recv(&assignment, 1, MPI_INT, 0, TAG_ASSIGN, comm, MPI_STATUS_IGNORE);
+
+                if (assignment == NO_MORE_TILES) {
+                    break;
+                }
+                render_local_tile(params, tiles, assignment, local);
+            }
+        }
+
+        // 所有rank: 通过文件视图集合写入本地分块
+        void write_tiles_collective(MPI_File file, const RenderParams& params,
+                                    const std::vector<Tile>& tiles, const LocalTiles& local,
+                                    MPI_Offset header_size) {
+            MPI_Datatype row_type;
+            MPI_Type_contiguous(params.width * 3, MPI_BYTE, &row_type);
+            MPI_Type_commit(&row_type);
+
+            MPI_Datatype file_type = MPI_BYTE;
+            if (!local.indices.empty()) {
+                std::vector<int> block_rows;
+                std::vector<MPI_Aint> displacements;
+                for (int index : local.indices) {
+                    block_rows.push_back(tiles[index].height);
+                    displacements.push_back(static_cast<MPI_Aint>(header_size) +
+                                            static_cast<MPI_Aint>(tiles[index].y0) * params.width * 3);
+                }
+
+                MPI_Type_create_hindexed(static_cast<int>(local.indices.size()), block_rows.data(),
+                                         displacements.data(), row_type, &file_type);
+                MPI_Type_commit(&file_type);
+            }
+
+            check_mpi(MPI_File_set_view(file, 0, MPI_BYTE, file_type, "native", MPI_INFO_NULL),
+                      "MPI_File_set_view");
+            check_mpi(MPI_File_write_all(file, local.pixels.data(), local.total_rows, row_type,
+                                         MPI_STATUS_IGNORE),
+                      "MPI_File_write_all");
+
+            if (file_type != MPI_BYTE) {
+                MPI_Type_free(&file_type);
+            }
+            MPI_Type_free(&row_type);
+        }
+
+    } // namespace
+
+    MPIRenderStats render_mandelbrot_mpi(const RenderParams& params,
+                                         const std::string& output_filename,
+                                         const MPIRenderConfig& config,
+                                         MPI_Comm comm) {
+        int rank = 0, num_ranks = 1;
+        MPI_Comm_rank(comm, &rank);
+        MPI_Comm_size(comm, &num_ranks);
+
+        // 行带分块: 每块为完整宽度的连续行, 在PPM文件中连续存储
+        const std::vector<Tile> tiles = MandelbrotOMP::make_tiles(
+            params.width, params.height, params.width, std::max(1, config.band_height));
+
+        MPIRenderStats stats;
+        if (rank == 0) {
+            stats.num_ranks = num_ranks;
+            stats.num_tiles = static_cast<int>(tiles.size());
+            stats.tiles_per_rank.assign(num_ranks, 0);
+
+            if (config.verbose) {
+                std::cout << "[MPI] 开始分布式渲染 Mandelbrot 集合..." << std::endl;
+                std::cout << "[MPI] 分辨率: " << params.width << "x" << params.height << std::endl;
+                std::cout << "[MPI] 进程数: " << num_ranks << ", 分块数: " << tiles.size()
+                          << " (每块 " << config.band_height << " 行)" << std::endl;
+            }
+        }
+
+        // 节点内线程池: 只在首次渲染或线程数变化时配置 (CPU绑定交给mpirun --bind-to)
+        MandelbrotOMP::RenderPool::global().configure(config.num_threads, false);
+
+        // 打开输出文件并截断旧内容
+        MPI_File file;
+        check_mpi(MPI_File_open(comm, output_filename.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                                MPI_INFO_NULL, &file),
+                  "MPI_File_open");
+        check_mpi(MPI_File_set_size(file, 0), "MPI_File_set_size");
+
+        const std::string header = make_ppm_header(params.width, params.height);
+        if (rank == 0) {
+            check_mpi(MPI_File_write_at(file, 0, header.data(), static_cast<int>(header.size()),
+                                        MPI_BYTE, MPI_STATUS_IGNORE),
+                      "MPI_File_write_at");
+        }
+
+        double start_time = MPI_Wtime();
+
+        // 代价划分: 各rank独立计算相同的探测代价图, 每个worker静态领取一段代价均衡的连续行带,
+        // 只有余量行带通过master动态分发 (rank 0 仅负责调度)
+        std::vector<int> dynamic_tiles(tiles.size());
+        for (size_t i = 0; i < tiles.size(); ++i) dynamic_tiles[i] = static_cast<int>(i);
+        std::vector<int> static_tiles;
+
+        if (config.cost_partition && num_ranks > 1) {
+            const MandelbrotOMP::CostMap cost_map = MandelbrotOMP::estimate_tile_costs(
+                params, std::max(1, config.band_height), config.probe_scale);
+            MandelbrotOMP::CostPartition partition = MandelbrotOMP::partition_by_cost(
+                dynamic_tiles, cost_map.row_costs(), num_ranks - 1, config.steal_fraction);
+
+            if (rank > 0) {
+                static_tiles = std::move(partition.chunks[rank - 1]);
+            } else {
+                for (int r = 1; r < num_ranks; ++r) {
+                    stats.tiles_per_rank[r] += static_cast<int>(partition.chunks[r - 1].size());
+                }
+                if (config.verbose) {
+                    std::cout << "[MPI] 代价划分: 余量 " << partition.remainder.size() << " 个分块动态分发, 预计均衡度 "
+                              << static_cast<int>(100 * partition.mean_chunk_cost / std::max(1.0, partition.max_chunk_cost))
+                              << "%" << std::endl;
+                }
+            }
+            dynamic_tiles = std::move(partition.remainder);
+        }
+
+        // 动态调度渲染
+        LocalTiles local;
+        if (rank == 0) {
+            run_master(params, tiles, dynamic_tiles, num_ranks, config, stats, local, comm);
+        } else {
+            run_worker(params, tiles, static_tiles, local, comm);
+        }
+        double render_time = MPI_Wtime();
+        
+        // 热路径计数汇总到rank 0
+        const MandelbrotCPU::RenderCounters& c = local.counters;
+        long long local_counts[6] = {c.pixels, c.iterations, c.escaped, c.max_iter_hits, c.cardioid_skips, c.bulb_skips};
+        long long total_counts[6] = {0, 0, 0, 0, 0, 0};
+        check_mpi(MPI_Reduce(local_counts, total_counts, 6, MPI_LONG_LONG, MPI_SUM, 0, comm), "MPI_Reduce");
+        if (rank == 0) {
+            stats.counters.pixels = total_counts[0];
+            stats.counters.iterations = total_counts[1];
+            stats.counters.escaped = total_counts[2];
+            stats.counters.max_iter_hits = total_counts[3];
+            stats.counters.cardioid_skips = total_counts[4];
+            stats.counters.bulb_skips = total_counts[5];
+        }
+
+        // 集合写入
+        write_tiles_collective(file, params, tiles, local, static_cast<MPI_Offset>(header.size()));
+        check_mpi(MPI_File_close(&file), "MPI_File_close");
+        double write_time = MPI_Wtime();
+
+        if (rank == 0) {
+            stats.render_seconds = render_time - start_time;
+            stats.write_seconds = write_time - render_time;
+
+            if (config.verbose) {
+                std::cout << "[MPI] 渲染完成! 耗时: " << static_cast<long>(stats.render_seconds * 1000)
+                          << " ms, 集合写入: " << static_cast<long>(stats.write_seconds * 1000)
+                          << " ms" << std::endl;
+                std::cout << "[MPI] 图像已保存: " << output_filename << std::endl;
+            }
+        }
+
+        return stats;
+    }
+
+    std::string get_mpi_info(MPI_Comm comm) {
+        std::ostringstream info;
+
+        char version[MPI_MAX_LIBRARY_VERSION_STRING];
+        int version_length = 0;
+        MPI_Get_library_version(version, &version_length);
+
+        char processor[MPI_MAX_PROCESSOR_NAME];
+        int processor_length = 0;
+        MPI_Get_processor_name(processor, &processor_length);
+
+        int num_ranks = 1;
+        MPI_Comm_size(comm, &num_ranks);
+
+        info << "MPI库版本: " << std::string(version, version_length) << std::endl;
+        info << "进程数: " << num_ranks << std::endl;
+        info << "主机名: " << std::string(processor, processor_length) << std::endl;
+        info << "每进程OpenMP线程数: " << omp_get_max_threads() << std::endl;
+
+        return info.str();
+    }
+
+} // namespace MandelbrotMPI
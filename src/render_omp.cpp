@@ -3,9 +3,11 @@
  * 
  * 本文件实现了基于OpenMP的多线程并行渲染
  * 主要优化策略:
- * 1. 像素级并行化 (#pragma omp parallel for)
- * 2. 动态负载均衡 (schedule(dynamic))
- * 3. 内存访问优化 (避免false sharing)
+ * 1. 分块级并行化: 分块交给常驻线程池 RenderPool 执行, 连续渲染不再重复创建线程组
+ * 2. 动态负载均衡: TileScheduler 为每个线程维护分块队列, 用原子游标领取,
+ *    本队列耗尽后从其他队列窃取; 可按低分辨率代价图静态划分初始队列
+ * 3. 内存访问优化: 分块按行优先 / Morton / Hilbert 顺序遍历, 多NUMA节点时
+ *    线程绑定到节点并首次写入本节点负责的行, 每线程统计槽独占缓存行 (避免false sharing)
  * 4. 自适应线程数配置
  * 
  * 作者: Geoffrey Wang (with Claude AI assistance)
@@ -13,36 +15,268 @@
  */
 
 #include "../include/render_omp.hpp"
+#include "../include/render_checkpoint.hpp"
+#include "../include/cost_map.hpp"
+#include "../include/numa_topology.hpp"
+#include "../include/tile_scheduler.hpp"
+#include "../include/render_pool.hpp"
+#include "../include/render_progress.hpp"
 #include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
 #include <chrono>
 #include <sstream>
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 
 namespace MandelbrotOMP {
 
+    namespace {
+
+        // 渲染单个分块 (串行), dst指向分块左上角像素, dst_stride为目标缓冲区行字节数
+        // 坐标映射与整图一致, 保证分块拼接无缝; costs非空时同时写入每像素迭代次数 (行跨度为图像宽度)
+        void render_tile_into(const RenderParams& params, const Tile& tile,
+                              unsigned char* dst, size_t dst_stride, MandelbrotCPU::RenderCounters& counters,
+                              int* costs = nullptr) {
+            const double x_scale = (params.x_max - params.x_min) / (params.width - 1);
+            const double y_scale = (params.y_max - params.y_min) / (params.height - 1);
+
+            for (int ty = 0; ty < tile.height; ++ty) {
+                double imag = params.y_min + (tile.y0 + ty) * y_scale;
+                unsigned char* row = dst + ty * dst_stride;
+
+                for (int tx = 0; tx < tile.width; ++tx) {
+                    double real = params.x_min + (tile.x0 + tx) * x_scale;
+                    int iterations = mandelbrot_iterations_omp(real, imag, params.max_iter);
+                    counters.add_escape_time(iterations, params.max_iter);
+                    if (costs) costs[static_cast<size_t>(ty) * params.width + tx] = iterations;
+                    MandelbrotCPU::RGB color = MandelbrotCPU::iterations_to_color(iterations, params.max_iter);
+
+                    row[tx * 3] = color.r;
+                    row[tx * 3 + 1] = color.g;
+                    row[tx * 3 + 2] = color.b;
+                }
+            }
+        }
+
+        // NUMA布局: 每个节点拥有一段连续的像素行 (按分块行对齐, 按节点线程数比例划分)
+        struct NumaPlan {
+            std::vector<int> thread_nodes;      // 线程 -> 节点下标
+            std::vector<int> node_row_begin;    // 节点拥有的像素行 [begin, end)
+            std::vector<int> node_row_end;
+            
+            int node_of_row(int row) const {
+                for (size_t n = 0; n < node_row_begin.size(); ++n) {
+                    if (row >= node_row_begin[n] && row < node_row_end[n]) return static_cast<int>(n);
+                }
+                return 0;
+            }
+        };
+
+        // row_costs非空时按分块行代价 (而非行数) 与节点线程数成比例划分
+        NumaPlan make_numa_plan(const NumaTopology& topology, const std::vector<int>& thread_nodes,
+                                int height, int tile_size, const std::vector<double>& row_costs) {
+            NumaPlan plan;
+            plan.thread_nodes = thread_nodes;
+            
+            const int num_threads = static_cast<int>(thread_nodes.size());
+            const int num_nodes = static_cast<int>(topology.nodes.size());
+            std::vector<int> threads_per_node(num_nodes, 0);
+            for (int node : plan.thread_nodes) ++threads_per_node[node];
+            
+            const int tile_rows = (height + tile_size - 1) / tile_size;
+            std::vector<double> prefix(tile_rows + 1, 0.0);
+            for (int r = 0; r < tile_rows; ++r) {
+                prefix[r + 1] = prefix[r] + (row_costs.empty() ? 1.0 : row_costs[r]);
+            }
+            
+            int assigned_threads = 0;
+            int first = 0;
+            for (int n = 0; n < num_nodes; ++n) {
+                assigned_threads += threads_per_node[n];
+                const double boundary = prefix[tile_rows] * assigned_threads / num_threads;
+                int last = first;
+                while (last < tile_rows && prefix[last + 1] - boundary < boundary - prefix[last]) ++last;
+                if (assigned_threads == num_threads) last = tile_rows;
+                plan.node_row_begin.push_back(std::min(height, first * tile_size));
+                plan.node_row_end.push_back(std::min(height, last * tile_size));
+                first = last;
+            }
+            
+            return plan;
+        }
+
+        // 调度方案统计
+        struct ScheduleSummary {
+            int num_pending = 0;            // 待渲染分块数
+            double predicted_balance = 0.0; // 代价划分的预计均衡度 (平均段代价 / 最重段代价)
+            int remainder_tiles = 0;        // 余量分块数
+        };
+
+        // 按遍历顺序将未完成的分块分配到所属NUMA节点的队列
+        // cost_map非空时, 每个节点内再按代价切成每线程一段, 节点余量作为共享队列
+        ScheduleSummary fill_scheduler(TileScheduler& scheduler, const std::vector<Tile>& tiles,
+                                       const std::vector<char>& completed, const NumaPlan& plan,
+                                       int tiles_x, int tiles_y, TileOrder order,
+                                       const CostMap* cost_map, double steal_fraction) {
+            ScheduleSummary summary;
+            const int num_nodes = static_cast<int>(plan.node_row_begin.size());
+            const int num_threads = static_cast<int>(plan.thread_nodes.size());
+            std::vector<std::vector<int>> node_tiles(num_nodes);
+            
+            for (int index : make_tile_order(tiles_x, tiles_y, order)) {
+                if (!completed[index]) {
+                    node_tiles[plan.node_of_row(tiles[index].y0)].push_back(index);
+                    ++summary.num_pending;
+                }
+            }
+            
+            if (!cost_map) {
+                for (auto& queue : node_tiles) {
+                    scheduler.add_queue(std::move(queue));
+                }
+                for (int t = 0; t < num_threads; ++t) {
+                    scheduler.set_home_queue(t, plan.thread_nodes[t]);
+                }
+                return summary;
+            }
+            
+            double max_cost = 0.0, total_cost = 0.0;
+            for (int n = 0; n < num_nodes; ++n) {
+                std::vector<int> node_threads;
+                for (int t = 0; t < num_threads; ++t) {
+                    if (plan.thread_nodes[t] == n) node_threads.push_back(t);
+                }
+                if (node_threads.empty()) {
+                    scheduler.add_queue(std::move(node_tiles[n]));  // 无线程的节点: 只能被窃取
+                    continue;
+                }
+                
+                CostPartition partition = partition_by_cost(node_tiles[n], cost_map->tile_costs,
+                                                            static_cast<int>(node_threads.size()), steal_fraction);
+                for (size_t k = 0; k < node_threads.size(); ++k) {
+                    scheduler.set_home_queue(node_threads[k], scheduler.add_queue(std::move(partition.chunks[k])));
+                }
+                summary.remainder_tiles += static_cast<int>(partition.remainder.size());
+                const int remainder_queue = scheduler.add_queue(std::move(partition.remainder));
+                for (int t : node_threads) {
+                    scheduler.set_shared_queue(t, remainder_queue);
+                }
+                
+                max_cost = std::max(max_cost, partition.max_chunk_cost);
+                total_cost += partition.mean_chunk_cost * node_threads.size();
+            }
+            if (max_cost > 0.0) {
+                summary.predicted_balance = total_cost / num_threads / max_cost;
+            }
+            
+            return summary;
+        }
+
+        // 每线程统计槽 (独占缓存行, 仅由所属线程写入)
+        struct alignas(64) ThreadSlot {
+            double busy_seconds = 0.0;
+            long long tiles = 0;
+            MandelbrotCPU::RenderCounters counters;
+        };
+
+        // 在线程池上执行分块循环, body(thread_id, tile_index, counters) 累加到本线程的计数槽
+        // stats非空时逐分块计时, 并填充每线程统计与合并后的计数; trace非空时每个分块记录一个区间
+        template <typename Body>
+        void run_tiles_instrumented(RenderPool& pool, TileScheduler& scheduler, RenderStats* stats,
+                                    MandelbrotCPU::TraceRecorder* trace, Body&& body) {
+            std::vector<ThreadSlot> slots(pool.num_threads());
+            if (trace) trace->ensure_threads(pool.num_threads());
+            MandelbrotCPU::TraceSpan phase(trace, MandelbrotCPU::TraceRecorder::kMainThread, "render_tiles", "compute");
+            auto start = std::chrono::steady_clock::now();
+            pool.run_tiles(scheduler, [&](int tid, int tile_index) {
+                ThreadSlot& slot = slots[tid];
+                MandelbrotCPU::TraceSpan span(trace, tid, "tile", "compute", tile_index);
+                if (!stats) {
+                    body(tid, tile_index, slot.counters);
+                    return;
+                }
+                auto tile_start = std::chrono::steady_clock::now();
+                body(tid, tile_index, slot.counters);
+                slot.busy_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tile_start).count();
+                ++slot.tiles;
+            });
+            if (!stats) return;
+            stats->wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            
+            stats->thread_busy_seconds.clear();
+            stats->thread_tiles.clear();
+            stats->counters = MandelbrotCPU::RenderCounters();
+            for (const ThreadSlot& slot : slots) {
+                stats->thread_busy_seconds.push_back(slot.busy_seconds);
+                stats->thread_tiles.push_back(slot.tiles);
+                stats->counters.merge(slot.counters);
+            }
+            stats->steals = scheduler.steal_count();
+        }
+
+    } // namespace
+
     int get_optimal_thread_count() {
-        int hw_threads = omp_get_max_threads();
-        int recommended = std::min(hw_threads, 16);  // 避免过度并行化
-        
-        return recommended;
+        // 使用全部可用处理器; NUMA感知的绑定与分块归属保证多路服务器上的扩展性
+        return omp_get_num_procs();
     }
 
-    void configure_openmp(int num_threads, int chunk_size) {
+    void configure_openmp(int num_threads, int chunk_size, bool pin_threads) {
+        (void)chunk_size;  // 分块调度由TileScheduler完成, 保留参数以兼容旧接口
         if (num_threads <= 0) {
             num_threads = get_optimal_thread_count();
         }
         
-        omp_set_num_threads(num_threads);
-        
-        // 设置动态调度的块大小
-        if (chunk_size > 0) {
-            // OpenMP环境变量方式设置 (如果支持)
-            char chunk_env[32];
-            snprintf(chunk_env, sizeof(chunk_env), "%d", chunk_size);
-            // setenv("OMP_SCHEDULE", "dynamic,chunk", 1);  // 可选
+        RenderPool& pool = RenderPool::global();
+        if (pool.configure(num_threads, pin_threads)) {
+            std::cout << "[OpenMP] 线程池已配置: " << pool.num_threads() << " 线程"
+                      << (pool.pinned() ? ", 已按NUMA节点绑定" : "") << std::endl;
+        } else {
+            std::cout << "[OpenMP] 复用线程池: " << pool.num_threads() << " 线程 (已提交任务 "
+                      << pool.jobs() << " 个)" << std::endl;
         }
-        
-        std::cout << "[OpenMP] 配置完成: " << num_threads << " 线程" << std::endl;
+    }
+
+    std::vector<Tile> make_tiles(int width, int height, int tile_width, int tile_height) {
+        std::vector<Tile> tiles;
+        if (width <= 0 || height <= 0 || tile_width <= 0 || tile_height <= 0) {
+            return tiles;
+        }
+
+        for (int y0 = 0; y0 < height; y0 += tile_height) {
+            for (int x0 = 0; x0 < width; x0 += tile_width) {
+                tiles.push_back({x0, y0,
+                                 std::min(tile_width, width - x0),
+                                 std::min(tile_height, height - y0)});
+            }
+        }
+
+        return tiles;
+    }
+
+    MandelbrotCPU::ImageBuffer render_tile_omp(const RenderParams& params, const Tile& tile,
+                                               MandelbrotCPU::RenderCounters* counters) {
+        MandelbrotCPU::ImageBuffer tile_data(static_cast<size_t>(tile.width) * tile.height * 3);
+        const size_t row_bytes = static_cast<size_t>(tile.width) * 3;
+
+        RenderPool& pool = RenderPool::global();
+        if (pool.num_threads() == 0) pool.configure();
+        std::vector<MandelbrotCPU::RenderCounters> thread_counters(pool.num_threads());
+        pool.parallel_for(tile.height, [&](int ty) {
+            const Tile row = {tile.x0, tile.y0 + ty, tile.width, 1};
+            render_tile_into(params, row, tile_data.data() + ty * row_bytes, row_bytes,
+                             thread_counters[omp_get_thread_num()]);
+        });
+
+        if (counters) {
+            for (const MandelbrotCPU::RenderCounters& c : thread_counters) counters->merge(c);
+        }
+
+        return tile_data;
     }
 
     std::string get_openmp_info() {
@@ -52,78 +286,506 @@ namespace MandelbrotOMP {
         info << "最大线程数: " << omp_get_max_threads() << std::endl;
         info << "当前线程数: " << omp_get_num_threads() << std::endl;
         info << "处理器数量: " << omp_get_num_procs() << std::endl;
+        info << get_numa_info();
+        
+        const std::string thp_mode = MandelbrotCPU::BufferPool::transparent_huge_page_mode();
+        info << "透明大页: " << (thp_mode.empty() ? "不可用" : thp_mode) << std::endl;
         
         return info.str();
     }
 
-    std::vector<unsigned char> render_mandelbrot_omp(const RenderParams& params, int num_threads) {
+    MandelbrotCPU::ImageBuffer render_mandelbrot_omp(const RenderParams& params, int num_threads) {
+        RenderOptions options;
+        options.num_threads = num_threads;
+        return render_mandelbrot_omp(params, options);
+    }
+
+    MandelbrotCPU::ImageBuffer render_mandelbrot_omp(const RenderParams& params, const RenderOptions& options) {
         std::cout << "[OpenMP] 开始并行渲染 Mandelbrot 集合..." << std::endl;
         std::cout << "[OpenMP] 分辨率: " << params.width << "x" << params.height << std::endl;
         std::cout << "[OpenMP] 最大迭代: " << params.max_iter << std::endl;
         std::cout << "[OpenMP] 复平面范围: [" << params.x_min << "," << params.x_max 
                   << "] x [" << params.y_min << "," << params.y_max << "]" << std::endl;
         
-        // 配置OpenMP
-        configure_openmp(num_threads);
+        // 配置OpenMP (线程池已按相同配置建立时直接复用)
+        configure_openmp(options.num_threads, 1, options.pin_threads);
+        RenderPool& pool = RenderPool::global();
         
         auto start_time = std::chrono::high_resolution_clock::now();
         
-        int total_pixels = params.width * params.height;
-        std::vector<unsigned char> image_data(total_pixels * 3);
+        const size_t total_pixels = static_cast<size_t>(params.width) * params.height;  // 十亿像素级超出int
+        const size_t row_bytes = static_cast<size_t>(params.width) * 3;
+        MandelbrotCPU::ImageBuffer image_data(total_pixels * 3);  // 不清零, 由渲染线程首次写入
+        if (options.pixel_costs) {
+            options.pixel_costs->assign(total_pixels, 0);  // 续渲恢复的分块保持为0
+        }
         
-        // 预计算常量避免重复计算
-        const double x_scale = (params.x_max - params.x_min) / (params.width - 1);
-        const double y_scale = (params.y_max - params.y_min) / (params.height - 1);
+        // 正方形分块: 动态调度粒度, 同时也是检查点粒度
+        const int tile_size = std::max(1, options.tile_size);
+        const std::vector<Tile> tiles = make_tiles(params.width, params.height, tile_size, tile_size);
+        std::vector<char> completed(tiles.size(), 0);
         
-        // 进度统计变量
-        int progress_counter = 0;
-        const int progress_step = params.height / 10;
+        // NUMA布局: 线程池已按节点绑定线程, 节点内线程并行first-touch本节点的行
+        const NumaTopology& topology = get_numa_topology();
+        const bool numa = topology.is_numa();
         
-        std::cout << "[OpenMP] 使用 " << omp_get_max_threads() << " 个线程并行渲染" << std::endl;
+        // 代价图: 低分辨率探测, 决定节点行区间和每线程的分块段
+        std::unique_ptr<CostMap> cost_map;
+        std::vector<double> row_costs;
+        if (options.cost_partition) {
+            MandelbrotCPU::TraceSpan span(options.trace, MandelbrotCPU::TraceRecorder::kMainThread, "cost_probe", "schedule");
+            auto probe_start = std::chrono::high_resolution_clock::now();
+            cost_map = std::make_unique<CostMap>(estimate_tile_costs(params, tile_size, options.probe_scale));
+            row_costs = cost_map->row_costs();
+            auto probe_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::high_resolution_clock::now() - probe_start).count();
+            std::cout << "[OpenMP] 代价探测: " << cost_map->probe_width << "x" << cost_map->probe_height
+                      << ", 耗时 " << probe_ms << " ms" << std::endl;
+        }
         
-        // OpenMP并行化主循环
-        #pragma omp parallel for schedule(dynamic, 1) shared(progress_counter)
-        for (int py = 0; py < params.height; ++py) {
-            // 计算当前行的Y坐标
-            double imag = params.y_min + py * y_scale;
-            
-            for (int px = 0; px < params.width; ++px) {
-                // 计算当前像素的X坐标
-                double real = params.x_min + px * x_scale;
-                
-                // 计算该点的迭代次数 (使用优化版本)
-                int iterations = mandelbrot_iterations_omp(real, imag, params.max_iter);
-                
-                // 转换为颜色 (复用CPU版本的着色函数)
-                MandelbrotCPU::RGB color = MandelbrotCPU::iterations_to_color(iterations, params.max_iter);
+        const NumaPlan plan = make_numa_plan(topology, pool.thread_nodes(), params.height, tile_size, row_costs);
+        
+        // 预缺页: 多NUMA节点时总是执行 (决定页面归属), 单节点时按需执行
+        if (numa || options.prefault) {
+            MandelbrotCPU::TraceSpan span(options.trace, MandelbrotCPU::TraceRecorder::kMainThread, "prefault", "memory");
+            auto prefault_start = std::chrono::high_resolution_clock::now();
+            pool.run([&](int tid) {
+                const int node = plan.thread_nodes[tid];
                 
-                // 存储RGB数据
-                int pixel_index = (py * params.width + px) * 3;
-                image_data[pixel_index] = color.r;     // Red
-                image_data[pixel_index + 1] = color.g; // Green  
-                image_data[pixel_index + 2] = color.b; // Blue
+                // 本节点的第rank个线程负责本节点行区间的第rank段
+                int rank = 0, node_threads = 0;
+                for (int t = 0; t < static_cast<int>(plan.thread_nodes.size()); ++t) {
+                    if (plan.thread_nodes[t] != node) continue;
+                    if (t < tid) ++rank;
+                    ++node_threads;
+                }
+                const int rows = plan.node_row_end[node] - plan.node_row_begin[node];
+                const int first = plan.node_row_begin[node] + rows * rank / node_threads;
+                const int last = plan.node_row_begin[node] + rows * (rank + 1) / node_threads;
+                if (last > first) {
+                    MandelbrotCPU::prefault_pages(image_data.data() + first * row_bytes, (last - first) * row_bytes);
+                }
+            });
+            if (options.prefault) {
+                auto prefault_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::high_resolution_clock::now() - prefault_start).count();
+                std::cout << "[OpenMP] 预缺页: " << (image_data.size() >> 20) << " MB, 耗时 "
+                          << prefault_ms << " ms" << std::endl;
+            }
+        }
+        
+        // 检查点日志: 续渲时先恢复已完成的分块
+        std::unique_ptr<CheckpointJournal> journal;
+        if (!options.checkpoint_file.empty()) {
+            MandelbrotCPU::TraceSpan span(options.trace, MandelbrotCPU::TraceRecorder::kMainThread, "checkpoint_restore", "io");
+            journal = std::make_unique<CheckpointJournal>(options.checkpoint_file, params, tile_size,
+                                                          static_cast<int>(tiles.size()),
+                                                          options.checkpoint_interval_ms);
+            if (options.resume) {
+                int restored = journal->restore(tiles, image_data, completed);
+                std::cout << "[OpenMP] 从检查点恢复: " << restored << "/" << tiles.size()
+                          << " 个分块已完成" << std::endl;
             }
+            journal->open(options.resume);
+            std::cout << "[OpenMP] 检查点日志: " << options.checkpoint_file << std::endl;
+        }
+        
+        // 分块队列: 每个NUMA节点一个队列 (单节点时即全局动态调度)
+        const int num_threads = static_cast<int>(plan.thread_nodes.size());
+        const int tiles_x = (params.width + tile_size - 1) / tile_size;
+        const int tiles_y = (params.height + tile_size - 1) / tile_size;
+        TileScheduler scheduler(num_threads);
+        const auto schedule_start = MandelbrotCPU::TraceRecorder::Clock::now();
+        const ScheduleSummary summary = fill_scheduler(scheduler, tiles, completed, plan, tiles_x, tiles_y,
+                                                       options.tile_order, cost_map.get(), options.steal_fraction);
+        if (options.trace) {
+            options.trace->add(MandelbrotCPU::TraceRecorder::kMainThread, "schedule", "schedule",
+                               schedule_start, MandelbrotCPU::TraceRecorder::Clock::now());
+        }
+        const int num_pending = summary.num_pending;
+        
+        // 进度: 渲染线程只做无锁计数, 输出由报告线程按固定间隔完成
+        long long pending_pixels = 0;
+        for (size_t i = 0; i < tiles.size(); ++i) {
+            if (!completed[i]) pending_pixels += static_cast<long long>(tiles[i].width) * tiles[i].height;
+        }
+        ProgressTracker progress(num_threads, num_pending, pending_pixels);
+        if (options.progress_callback) {
+            progress.start_reporter(options.progress_callback, options.progress_interval_ms);
+        } else {
+            progress.start_reporter([](const ProgressStatus& status) {
+                std::cout << "[OpenMP] 渲染进度: " << static_cast<int>(status.fraction() * 100) << "% ("
+                          << status.tiles_done << "/" << status.tiles_total << " 分块)\n" << std::flush;
+            }, options.progress_interval_ms);
+        }
+        
+        std::cout << "[OpenMP] 使用 " << num_threads << " 个线程并行渲染 "
+                  << num_pending << " 个分块 (" << tile_size << "x" << tile_size << ", "
+                  << tile_order_name(options.tile_order) << "顺序)" << std::endl;
+        if (cost_map) {
+            std::cout << "[OpenMP] 代价划分: 每线程一段连续分块, 余量 " << summary.remainder_tiles
+                      << " 个分块, 预计均衡度 " << static_cast<int>(summary.predicted_balance * 100) << "%" << std::endl;
+        }
+        if (numa) {
+            std::cout << "[OpenMP] NUMA节点: " << topology.nodes.size()
+                      << (pool.pinned() ? ", 线程已按节点绑定" : ", 未绑定线程") << std::endl;
+        }
+        
+        // 并行化主循环 (线程池上的分块级调度, 本节点优先 + 跨节点窃取)
+        // 着色与迭代在同一像素循环中完成, 时间线上的分块区间包含两者
+        run_tiles_instrumented(pool, scheduler, options.stats, options.trace, [&](int tid, int tile_index,
+                                                                                  MandelbrotCPU::RenderCounters& counters) {
+            const Tile& tile = tiles[tile_index];
+            unsigned char* dst = image_data.data() + tile.y0 * row_bytes + static_cast<size_t>(tile.x0) * 3;
+            int* costs = options.pixel_costs
+                ? options.pixel_costs->data() + static_cast<size_t>(tile.y0) * params.width + tile.x0
+                : nullptr;
+            render_tile_into(params, tile, dst, row_bytes, counters, costs);
             
-            // 线程安全的进度显示 (仅主线程更新)
-            #pragma omp critical
-            {
-                ++progress_counter;
-                if (progress_counter % progress_step == 0) {
-                    int progress = (progress_counter * 100) / params.height;
-                    std::cout << "[OpenMP] 渲染进度: " << progress << "% (线程 " 
-                              << omp_get_thread_num() << ")" << std::endl;
-                }
+            if (journal) {
+                MandelbrotCPU::TraceSpan span(options.trace, tid, "checkpoint", "io", tile_index);
+                journal->record_tile(tile_index, tile, image_data);
             }
+            
+            progress.add_tile(tid, static_cast<long long>(tile.width) * tile.height);
+        });
+        progress.finish();
+        
+        if (journal) {
+            MandelbrotCPU::TraceSpan span(options.trace, MandelbrotCPU::TraceRecorder::kMainThread, "checkpoint_flush", "io");
+            journal->flush();
         }
         
         auto end_time = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
         
         std::cout << "[OpenMP] 渲染完成! 耗时: " << duration.count() << " ms" << std::endl;
-        std::cout << "[OpenMP] 性能: " << (total_pixels * 1000.0 / duration.count()) << " 像素/秒" << std::endl;
-        std::cout << "[OpenMP] 使用的线程数: " << omp_get_max_threads() << std::endl;
+        std::cout << "[OpenMP] 性能: " << (static_cast<double>(total_pixels) * 1000.0 / duration.count()) << " 像素/秒" << std::endl;
+        std::cout << "[OpenMP] 使用的线程数: " << num_threads << std::endl;
+        if (numa || cost_map) {
+            std::cout << "[OpenMP] 窃取分块: " << scheduler.steal_count() << std::endl;
+        }
+        if (cost_map && options.pixel_costs) {
+            // 探测图与实测代价的一致性: 相关系数低说明探测分辨率不足以划分
+            const CostMapAccuracy accuracy = compare_cost_maps(
+                *cost_map, cost_map_from_iterations(*options.pixel_costs, params.width, params.height, tile_size));
+            std::cout << "[OpenMP] 代价探测准确度: 分块相关系数 " << accuracy.correlation
+                      << ", 探测/实测总代价 " << accuracy.total_ratio << std::endl;
+        }
         
         return image_data;
     }
 
+    IterationField render_iterations_omp(const RenderParams& params, const RenderOptions& options) {
+        RenderPool& pool = RenderPool::global();
+        pool.configure(options.num_threads, options.pin_threads);
+        
+        IterationField field(params.width, params.height, std::max(1, options.tile_size));
+        const int tile_size = field.tile_size();
+        const std::vector<Tile> tiles = make_tiles(params.width, params.height, tile_size, tile_size);
+        const std::vector<char> completed(tiles.size(), 0);
+        
+        std::unique_ptr<CostMap> cost_map;
+        std::vector<double> row_costs;
+        if (options.cost_partition) {
+            MandelbrotCPU::TraceSpan span(options.trace, MandelbrotCPU::TraceRecorder::kMainThread, "cost_probe", "schedule");
+            cost_map = std::make_unique<CostMap>(estimate_tile_costs(params, tile_size, options.probe_scale));
+            row_costs = cost_map->row_costs();
+        }
+        
+        const NumaPlan plan = make_numa_plan(get_numa_topology(), pool.thread_nodes(), params.height, tile_size, row_costs);
+        TileScheduler scheduler(pool.num_threads());
+        fill_scheduler(scheduler, tiles, completed, plan, field.tiles_x(), field.tiles_y(), options.tile_order,
+                       cost_map.get(), options.steal_fraction);
+        
+        const double x_scale = (params.x_max - params.x_min) / (params.width - 1);
+        const double y_scale = (params.y_max - params.y_min) / (params.height - 1);
+        
+        // 每个分块写入一段连续内存, 首次写入即由所属节点的线程完成
+        // 预缺页: 每个分块是一段连续内存, 由线程池并行触及
+        if (options.prefault) {
+            const size_t tile_bytes = static_cast<size_t>(tile_size) * tile_size * sizeof(int);
+            pool.parallel_for(static_cast<int>(tiles.size()), [&](int tile_index) {
+                MandelbrotCPU::prefault_pages(field.tile_data(tile_index), tile_bytes);
+            });
+        }
+        
+        ProgressTracker progress(pool.num_threads(), static_cast<long long>(tiles.size()),
+                                 static_cast<long long>(params.width) * params.height);
+        progress.start_reporter(options.progress_callback, options.progress_interval_ms);
+        
+        run_tiles_instrumented(pool, scheduler, options.stats, options.trace, [&](int tid, int tile_index,
+                                                                                  MandelbrotCPU::RenderCounters& counters) {
+            const Tile& tile = tiles[tile_index];
+            int* block = field.tile_data(tile_index);
+            
+            for (int ty = 0; ty < tile.height; ++ty) {
+                double imag = params.y_min + (tile.y0 + ty) * y_scale;
+                int* row = block + ty * tile_size;
+                for (int tx = 0; tx < tile.width; ++tx) {
+                    double real = params.x_min + (tile.x0 + tx) * x_scale;
+                    row[tx] = mandelbrot_iterations_omp(real, imag, params.max_iter);
+                    counters.add_escape_time(row[tx], params.max_iter);
+                }
+            }
+            progress.add_tile(tid, static_cast<long long>(tile.width) * tile.height);
+        });
+        progress.finish();
+        
+        return field;
+    }
+
+    namespace {
+
+        // 按分块读取迭代场 (连续内存), 写入对应的图像行段; color_of(iterations) 给出像素颜色
+        template <typename ColorFn>
+        MandelbrotCPU::ImageBuffer colorize_tiles(RenderPool& pool, const IterationField& field,
+                                                  MandelbrotCPU::TraceRecorder* trace, ColorFn&& color_of) {
+            const size_t row_bytes = static_cast<size_t>(field.width()) * 3;
+            MandelbrotCPU::ImageBuffer image_data(row_bytes * field.height());
+            const int tile_size = field.tile_size();
+            const int num_tiles = field.tiles_x() * field.tiles_y();
+            MandelbrotCPU::TraceSpan phase(trace, MandelbrotCPU::TraceRecorder::kMainThread, "colorize", "colorize");
+            
+            pool.parallel_for(num_tiles, [&](int tile_index) {
+                MandelbrotCPU::TraceSpan span(trace, omp_get_thread_num(), "colorize_tile", "colorize", tile_index);
+                const int x0 = (tile_index % field.tiles_x()) * tile_size;
+                const int y0 = (tile_index / field.tiles_x()) * tile_size;
+                const int width = std::min(tile_size, field.width() - x0);
+                const int height = std::min(tile_size, field.height() - y0);
+                const int* block = field.tile_data(tile_index);
+                
+                for (int ty = 0; ty < height; ++ty) {
+                    unsigned char* dst = image_data.data() + (y0 + ty) * row_bytes + static_cast<size_t>(x0) * 3;
+                    for (int tx = 0; tx < width; ++tx) {
+                        const MandelbrotCPU::RGB color = color_of(block[ty * tile_size + tx]);
+                        dst[tx * 3] = color.r;
+                        dst[tx * 3 + 1] = color.g;
+                        dst[tx * 3 + 2] = color.b;
+                    }
+                }
+            });
+            
+            return image_data;
+        }
+
+        // 整数哈希 (murmur3 finalizer), 用于可复现的抖动采样
+        uint32_t mix_bits(uint32_t h) {
+            h ^= h >> 16;
+            h *= 0x85EBCA6Bu;
+            h ^= h >> 13;
+            h *= 0xC2B2AE35u;
+            h ^= h >> 16;
+            return h;
+        }
+
+        RenderPool& colorize_pool(MandelbrotCPU::TraceRecorder* trace) {
+            RenderPool& pool = RenderPool::global();
+            if (pool.num_threads() == 0) pool.configure();
+            if (trace) trace->ensure_threads(pool.num_threads());
+            return pool;
+        }
+
+    } // namespace
+
+    MandelbrotCPU::ImageBuffer colorize_omp(const IterationField& field, int max_iter,
+                                            MandelbrotCPU::TraceRecorder* trace) {
+        return colorize_tiles(colorize_pool(trace), field, trace, [max_iter](int iterations) {
+            return MandelbrotCPU::iterations_to_color(iterations, max_iter);
+        });
+    }
+
+    MandelbrotCPU::ImageBuffer colorize_omp(const IterationField& field, const std::vector<RGB>& palette,
+                                            MandelbrotCPU::TraceRecorder* trace) {
+        return colorize_tiles(colorize_pool(trace), field, trace, [&palette](int iterations) { return palette[iterations]; });
+    }
+
+    std::vector<RGB> linear_palette(int max_iter) {
+        std::vector<RGB> palette(max_iter + 1);
+        for (int iterations = 0; iterations <= max_iter; ++iterations) {
+            palette[iterations] = MandelbrotCPU::iterations_to_color(iterations, max_iter);
+        }
+        return palette;
+    }
+
+    std::vector<RGB> equalized_palette_omp(const IterationField& field, int max_iter,
+                                           MandelbrotCPU::TraceRecorder* trace) {
+        RenderPool& pool = colorize_pool(trace);
+        const int num_threads = pool.num_threads();
+        const int num_bins = max_iter + 1;
+        const int tile_size = field.tile_size();
+        const int num_tiles = field.tiles_x() * field.tiles_y();
+        
+        // 1. 每线程子直方图: 各线程只写自己的直方图 (由自己首次写入), 无原子操作
+        //    统计每像素开销相同, 分块按线程编号交错静态分配即可均衡
+        std::vector<std::vector<uint32_t>> sub_histograms(num_threads);
+        {
+            MandelbrotCPU::TraceSpan span(trace, MandelbrotCPU::TraceRecorder::kMainThread, "histogram", "colorize");
+            pool.run([&](int tid) {
+                std::vector<uint32_t>& histogram = sub_histograms[tid];
+                histogram.assign(num_bins, 0);
+                for (int tile_index = tid; tile_index < num_tiles; tile_index += num_threads) {
+                    const int width = std::min(tile_size, field.width() - (tile_index % field.tiles_x()) * tile_size);
+                    const int height = std::min(tile_size, field.height() - (tile_index / field.tiles_x()) * tile_size);
+                    const int* block = field.tile_data(tile_index);
+                    for (int ty = 0; ty < height; ++ty) {
+                        for (int tx = 0; tx < width; ++tx) {
+                            ++histogram[block[ty * tile_size + tx]];
+                        }
+                    }
+                }
+            });
+        }
+        
+        // 2. 并行归约: 直方图按区间切分, 每个区间由一个线程累加全部子直方图
+        const int bins_per_chunk = 4096;
+        std::vector<uint64_t> histogram(num_bins);
+        {
+            MandelbrotCPU::TraceSpan span(trace, MandelbrotCPU::TraceRecorder::kMainThread, "histogram_reduce", "colorize");
+            pool.parallel_for((num_bins + bins_per_chunk - 1) / bins_per_chunk, [&](int chunk) {
+                const int begin = chunk * bins_per_chunk;
+                const int end = std::min(num_bins, begin + bins_per_chunk);
+                for (int bin = begin; bin < end; ++bin) {
+                    uint64_t sum = 0;
+                    for (const std::vector<uint32_t>& sub : sub_histograms) sum += sub[bin];
+                    histogram[bin] = sum;
+                }
+            });
+        }
+        
+        // 3. CDF只算一次, 直接生成颜色查找表; 内部像素 (max_iter) 不参与分布, 固定为黑色
+        //    色谱只取到品红 (0.83), 避免分布两端同为红色
+        std::vector<MandelbrotCPU::RGB> lut(num_bins);
+        {
+            MandelbrotCPU::TraceSpan span(trace, MandelbrotCPU::TraceRecorder::kMainThread, "cdf_lut", "colorize");
+            uint64_t escaped = 0;
+            for (int bin = 0; bin < max_iter; ++bin) escaped += histogram[bin];
+            
+            uint64_t cumulative = 0;
+            for (int bin = 0; bin < max_iter; ++bin) {
+                cumulative += histogram[bin];
+                const double t = escaped ? static_cast<double>(cumulative) / escaped : 0.0;
+                lut[bin] = MandelbrotCPU::palette_color(0.83 * t);
+            }
+            lut[max_iter] = MandelbrotCPU::RGB(0, 0, 0);
+        }
+        return lut;
+    }
+
+    MandelbrotCPU::ImageBuffer colorize_equalized_omp(const IterationField& field, int max_iter,
+                                                      MandelbrotCPU::TraceRecorder* trace) {
+        // 4. 查表着色
+        return colorize_omp(field, equalized_palette_omp(field, max_iter, trace), trace);
+    }
+
+    SupersampleStats supersample_edges_omp(const RenderParams& params, const IterationField& field,
+                                           const std::vector<RGB>& palette, MandelbrotCPU::ImageBuffer& image,
+                                           const SupersampleOptions& options) {
+        RenderPool& pool = colorize_pool(options.trace);
+        const std::vector<RGB> linear = palette.empty() ? linear_palette(params.max_iter) : std::vector<RGB>();
+        const std::vector<RGB>& lut = palette.empty() ? linear : palette;
+        
+        const int grid = std::max(2, static_cast<int>(std::lround(std::sqrt(static_cast<double>(options.samples)))));
+        const int tile_size = field.tile_size();
+        const int num_tiles = field.tiles_x() * field.tiles_y();
+        const size_t row_bytes = static_cast<size_t>(params.width) * 3;
+        const double x_scale = (params.x_max - params.x_min) / (params.width - 1);
+        const double y_scale = (params.y_max - params.y_min) / (params.height - 1);
+        
+        // 边缘判定: 与4邻域跨越集合边界, 或颜色 (各通道差之和) 相差超过阈值
+        auto differs = [&](int a, int b) {
+            if ((a == params.max_iter) != (b == params.max_iter)) return true;
+            const RGB& ca = lut[a];
+            const RGB& cb = lut[b];
+            return std::abs(ca.r - cb.r) + std::abs(ca.g - cb.g) + std::abs(ca.b - cb.b) > options.color_threshold;
+        };
+        
+        std::vector<MandelbrotCPU::RenderCounters> thread_counters(pool.num_threads());
+        std::vector<long long> tile_edges(num_tiles, 0);
+        MandelbrotCPU::TraceSpan phase(options.trace, MandelbrotCPU::TraceRecorder::kMainThread, "supersample", "compute");
+        
+        // 只读迭代场、只写本分块像素: 判定与补采样在同一遍内完成; 边缘像素分布不均, 按分块动态调度
+        pool.parallel_for(num_tiles, [&](int tile_index) {
+            const int tid = omp_get_thread_num();
+            MandelbrotCPU::TraceSpan span(options.trace, tid, "supersample_tile", "compute", tile_index);
+            MandelbrotCPU::RenderCounters& counters = thread_counters[tid];
+            const int x0 = (tile_index % field.tiles_x()) * tile_size;
+            const int y0 = (tile_index / field.tiles_x()) * tile_size;
+            const int x1 = std::min(x0 + tile_size, params.width);
+            const int y1 = std::min(y0 + tile_size, params.height);
+            long long edges = 0;
+            
+            for (int y = y0; y < y1; ++y) {
+                for (int x = x0; x < x1; ++x) {
+                    const int center = field.at(x, y);
+                    const bool edge = (x > 0 && differs(center, field.at(x - 1, y))) ||
+                                      (x + 1 < params.width && differs(center, field.at(x + 1, y))) ||
+                                      (y > 0 && differs(center, field.at(x, y - 1))) ||
+                                      (y + 1 < params.height && differs(center, field.at(x, y + 1)));
+                    if (!edge) continue;
+                    ++edges;
+                    
+                    // 分层抖动: 像素覆盖的 [-0.5, 0.5)^2 划分为 grid x grid 个子格, 每格一个抖动采样;
+                    // 抖动量由像素坐标哈希得到, 结果与线程数和调度顺序无关
+                    int sum[3] = {0, 0, 0};
+                    for (int sy = 0; sy < grid; ++sy) {
+                        for (int sx = 0; sx < grid; ++sx) {
+                            const uint32_t hash = mix_bits(static_cast<uint32_t>(y) * 0x9E3779B1u ^
+                                                           static_cast<uint32_t>(x) * 0x85EBCA77u ^
+                                                           static_cast<uint32_t>(sy * grid + sx) * 0xC2B2AE3Du);
+                            const double jitter_x = (hash & 0xFFFF) / 65536.0;
+                            const double jitter_y = (hash >> 16) / 65536.0;
+                            const double real = params.x_min + (x - 0.5 + (sx + jitter_x) / grid) * x_scale;
+                            const double imag = params.y_min + (y - 0.5 + (sy + jitter_y) / grid) * y_scale;
+                            const int iterations = mandelbrot_iterations_omp(real, imag, params.max_iter);
+                            counters.add_escape_time(iterations, params.max_iter);
+                            const RGB& color = lut[iterations];
+                            sum[0] += color.r;
+                            sum[1] += color.g;
+                            sum[2] += color.b;
+                        }
+                    }
+                    
+                    const int count = grid * grid;
+                    unsigned char* dst = image.data() + y * row_bytes + static_cast<size_t>(x) * 3;
+                    for (int c = 0; c < 3; ++c) dst[c] = static_cast<unsigned char>((sum[c] + count / 2) / count);
+                }
+            }
+            tile_edges[tile_index] = edges;
+        });
+        
+        SupersampleStats stats;
+        for (long long edges : tile_edges) stats.edge_pixels += edges;
+        stats.samples_per_pixel = grid * grid;
+        for (const MandelbrotCPU::RenderCounters& c : thread_counters) stats.counters.merge(c);
+        return stats;
+    }
+
+    MandelbrotCPU::ImageBuffer downsample_omp(const MandelbrotCPU::ImageBuffer& image, int width, int height,
+                                              int dst_width, int dst_height, MandelbrotCPU::ResampleFilter filter,
+                                              MandelbrotCPU::TraceRecorder* trace) {
+        RenderPool& pool = colorize_pool(trace);
+        MandelbrotCPU::Downsampler downsampler(width, height, dst_width, dst_height, filter);
+        MandelbrotCPU::ImageBuffer result(static_cast<size_t>(dst_width) * dst_height * 3);
+        const size_t row_bytes = static_cast<size_t>(width) * 3;
+        const size_t dst_row_bytes = static_cast<size_t>(dst_width) * 3;
+        const int band_rows = 64;
+        
+        auto parallel = [&pool](int count, auto&& body) { pool.parallel_for(count, body); };
+        auto store = [&](int y, const unsigned char* row) {
+            std::memcpy(result.data() + y * dst_row_bytes, row, dst_row_bytes);
+        };
+        for (int y = 0; y < height; y += band_rows) {
+            MandelbrotCPU::TraceSpan span(trace, MandelbrotCPU::TraceRecorder::kMainThread, "downsample_band", "colorize", y);
+            downsampler.push_rows(image.data() + y * row_bytes, std::min(band_rows, height - y), store, parallel);
+        }
+        return result;
+    }
+
+    void remove_checkpoint(const std::string& checkpoint_file) {
+        if (!checkpoint_file.empty()) {
+            std::remove(checkpoint_file.c_str());
+        }
+    }
+
 } // namespace MandelbrotOMP
@@ -0,0 +1,77 @@
+/**
+ * 渲染线程池实现
+ *
+ * 作者: Geoffrey Wang (with Claude AI assistance)
+ * 日期: 2025-08-12
+ */
+
+#include "../include/render_pool.hpp"
+#include <cstdlib>
+
+namespace MandelbrotOMP {
+
+    namespace {
+
+        // 用户通过OMP_PROC_BIND/OMP_PLACES指定绑定策略时不再覆盖
+        bool user_controls_binding() {
+            return std::getenv("OMP_PROC_BIND") != nullptr || std::getenv("OMP_PLACES") != nullptr;
+        }
+
+        // 未指定线程数时的默认值: 首次使用时的OpenMP默认线程数 (遵循OMP_NUM_THREADS, 否则为处理器数)
+        int default_thread_count() {
+            static const int count = omp_get_max_threads();
+            return count;
+        }
+
+    } // namespace
+
+    RenderPool& RenderPool::global() {
+        static RenderPool pool;
+        default_thread_count();
+        return pool;
+    }
+
+    bool RenderPool::configure(int num_threads, bool pin_threads) {
+        if (num_threads <= 0) {
+            num_threads = default_thread_count();
+        }
+
+        const NumaTopology& topology = get_numa_topology();
+        const bool pin = pin_threads && topology.is_numa() && !user_controls_binding();
+        pin_requested_ = pin_threads;
+        if (num_threads == num_threads_ && pin == pinned_) {
+            return false;
+        }
+
+        // 固定线程组大小, 线程编号与NUMA节点的对应关系在各次任务之间保持不变
+        omp_set_dynamic(0);
+        omp_set_num_threads(num_threads);
+
+        num_threads_ = num_threads;
+        thread_nodes_ = assign_threads_to_nodes(topology, num_threads);
+
+        // OpenMP运行时在区域之间复用同一组线程, 绑定一次即可持续生效
+        if (pin || pinned_) {
+            std::vector<int> all_cpus;
+            for (const NumaNode& node : topology.nodes) {
+                all_cpus.insert(all_cpus.end(), node.cpus.begin(), node.cpus.end());
+            }
+
+            #pragma omp parallel num_threads(num_threads_)
+            {
+                const int tid = omp_get_thread_num();
+                pin_current_thread(pin ? topology.nodes[thread_nodes_[tid]].cpus : all_cpus);
+            }
+        }
+        pinned_ = pin;
+
+        return true;
+    }
+
+    void RenderPool::ensure_configured() {
+        if (num_threads_ == 0) {
+            configure(0, pin_requested_);
+        }
+    }
+
+} // namespace MandelbrotOMP
@@ -0,0 +1,70 @@
+/**
+ * 渲染进度跟踪实现
+ *
+ * 作者: Geoffrey Wang (with Claude AI assistance)
+ * 日期: 2025-08-12
+ */
+
+#include "../include/render_progress.hpp"
+#include <algorithm>
+
+namespace MandelbrotOMP {
+
+    ProgressTracker::ProgressTracker(int num_threads, long long tiles_total, long long pixels_total)
+        : slots_(new Slot[std::max(1, num_threads)]), num_slots_(std::max(1, num_threads)),
+          tiles_total_(tiles_total), pixels_total_(pixels_total),
+          start_(std::chrono::steady_clock::now()) {}
+
+    ProgressTracker::~ProgressTracker() {
+        finish();
+    }
+
+    ProgressStatus ProgressTracker::status() const {
+        ProgressStatus status;
+        for (int i = 0; i < num_slots_; ++i) {
+            status.tiles_done += slots_[i].tiles.load(std::memory_order_relaxed);
+            status.pixels_done += slots_[i].pixels.load(std::memory_order_relaxed);
+        }
+        status.tiles_total = tiles_total_;
+        status.pixels_total = pixels_total_;
+        status.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+        return status;
+    }
+
+    void ProgressTracker::start_reporter(ProgressCallback callback, int interval_ms) {
+        if (!callback || reporter_.joinable()) return;
+
+        callback_ = std::move(callback);
+        const auto interval = std::chrono::milliseconds(std::max(1, interval_ms));
+
+        reporter_ = std::thread([this, interval] {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!wake_.wait_for(lock, interval, [this] { return stop_; })) {
+                lock.unlock();
+                callback_(status());
+                lock.lock();
+            }
+        });
+    }
+
+    void ProgressTracker::finish() {
+        if (finished_) return;
+        finished_ = true;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        if (reporter_.joinable()) {
+            reporter_.join();
+        }
+
+        if (callback_) {
+            ProgressStatus final_status = status();
+            final_status.finished = true;
+            callback_(final_status);
+        }
+    }
+
+} // namespace MandelbrotOMP